@@ -0,0 +1,311 @@
+/**
+ * @file BarometerSensor.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "BarometerSensor.hpp"
+#include <cmath>
+#include "Log.hpp"
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+BarometerSensor::BarometerSensor(DevI2C *i2c, uint8_t address) : m_i2c(i2c), m_address(address),
+    m_rate(0), m_one_shot(false), m_one_shot_pending(false),
+    m_pressure(0), m_filtered(0), m_reference(0), m_altitude(0){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+BarometerSensor::~BarometerSensor()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+const float& BarometerSensor::getRate() const{
+    return m_rate;
+}
+
+const float& BarometerSensor::getPressure() const{
+    return m_pressure;
+}
+
+const float& BarometerSensor::getAltitude() const{
+    return m_altitude;
+}
+
+const float& BarometerSensor::getReference() const{
+    return m_reference;
+}
+
+
+/*
+----------------------------------------------------------
+-------------------INTERFACE------------------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Checks the sensor and leaves it in power-down
+ *
+ * @param init unused
+ * @return 0 in case of success
+ */
+int BarometerSensor::init(void *init)
+{
+    uint8_t id = 0;
+    if(read_id(&id) != 0 || id != LPS22HB_ID)
+    {
+        LOG_WARNING("Barometer: LPS22HB not found\n");
+        return 1;
+    }
+
+    // Low-current mode off, better noise
+    if(writeRegister(LPS22HB_RES_CONF, 0x00) != 0)
+    {
+        return 1;
+    }
+    return powerDown();
+}
+
+int BarometerSensor::read_id(uint8_t *id)
+{
+    return readRegisters(LPS22HB_WHO_AM_I, id, 1);
+}
+
+/**
+ * @brief Latest pressure read by update()
+ *
+ * @param pf_data [hPa]
+ * @return 0
+ */
+int BarometerSensor::get_pressure(float *pf_data)
+{
+    *pf_data = m_pressure;
+    return 0;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Continuous mode with the FIFO in stream mode at the next supported ODR,
+ * or one-shot conversions below BARO_ONE_SHOT_RATE
+ *
+ * @param rate [Hz]
+ * @return 0 in case of success
+ */
+int BarometerSensor::configure(float rate)
+{
+    m_one_shot = rate < BARO_ONE_SHOT_RATE;
+    m_one_shot_pending = false;
+
+    uint8_t odr = m_one_shot ? LPS22HB_ODR_ONE_SHOT
+                : (rate <= 1.0f ) ? LPS22HB_ODR_1HZ
+                : (rate <= 10.0f) ? LPS22HB_ODR_10HZ
+                : (rate <= 25.0f) ? LPS22HB_ODR_25HZ
+                : (rate <= 50.0f) ? LPS22HB_ODR_50HZ
+                :                   LPS22HB_ODR_75HZ;
+
+    m_rate = m_one_shot ? rate
+           : (odr == LPS22HB_ODR_1HZ ) ? 1.0f
+           : (odr == LPS22HB_ODR_10HZ) ? 10.0f
+           : (odr == LPS22HB_ODR_25HZ) ? 25.0f
+           : (odr == LPS22HB_ODR_50HZ) ? 50.0f
+           :                             75.0f;
+
+    // The FIFO must go through bypass to be emptied before stream mode
+    if(writeRegister(LPS22HB_FIFO_CTRL, LPS22HB_FIFO_BYPASS) != 0
+        || writeRegister(LPS22HB_CTRL_REG1, odr | LPS22HB_EN_LPFP | LPS22HB_LPFP_CFG | LPS22HB_BDU) != 0
+        || writeRegister(LPS22HB_CTRL_REG2, m_one_shot ? LPS22HB_IF_ADD_INC : (LPS22HB_FIFO_EN | LPS22HB_IF_ADD_INC)) != 0)
+    {
+        return 1;
+    }
+
+    if(!m_one_shot && writeRegister(LPS22HB_FIFO_CTRL, LPS22HB_FIFO_STREAM) != 0)
+    {
+        return 1;
+    }
+
+    // Reading LPFP_RES resets the internal filter
+    uint8_t dummy;
+    return readRegisters(LPS22HB_LPFP_RES, &dummy, 1);
+}
+
+/**
+ * @brief Power-down mode, no conversion
+ *
+ * @return 0 in case of success
+ */
+int BarometerSensor::powerDown()
+{
+    m_one_shot = false;
+    m_one_shot_pending = false;
+    m_rate = 0;
+    if(writeRegister(LPS22HB_CTRL_REG1, LPS22HB_ODR_ONE_SHOT | LPS22HB_BDU) != 0
+        || writeRegister(LPS22HB_CTRL_REG2, LPS22HB_IF_ADD_INC) != 0
+        || writeRegister(LPS22HB_FIFO_CTRL, LPS22HB_FIFO_BYPASS) != 0)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Reads the new samples and updates the altitude. Each call reads at most BARO_FIFO_BURST samples in one transfer,
+ * so it must be called at least at getRate()/BARO_FIFO_BURST
+ *
+ * @return number of new samples, -1 on a bus error
+ */
+int BarometerSensor::update()
+{
+    if(m_rate <= 0)
+    {
+        return 0;
+    }
+    return m_one_shot ? readOneShot() : readFifo();
+}
+
+/**
+ * @brief The next sample becomes the zero altitude
+ *
+ */
+void BarometerSensor::resetReference()
+{
+    m_reference = 0;
+    m_altitude = 0;
+}
+
+/**
+ * @brief Drains up to BARO_FIFO_BURST samples. The output registers wrap from PRESS_OUT_XL to TEMP_OUT_H,
+ * so consecutive FIFO slots are read in a single burst
+ *
+ * @return number of samples read, -1 on a bus error
+ */
+int BarometerSensor::readFifo()
+{
+    uint8_t status;
+    if(readRegisters(LPS22HB_FIFO_STATUS, &status, 1) != 0)
+    {
+        return -1;
+    }
+
+    int nb_samples = status & LPS22HB_FIFO_LEVEL_MASK;
+    if(nb_samples > BARO_FIFO_BURST)
+    {
+        nb_samples = BARO_FIFO_BURST;
+    }
+    if(nb_samples == 0)
+    {
+        return 0;
+    }
+
+    uint8_t data[BARO_FIFO_BURST*LPS22HB_SAMPLE_SIZE];
+    if(readRegisters(LPS22HB_PRESS_OUT_XL, data, nb_samples*LPS22HB_SAMPLE_SIZE) != 0)
+    {
+        return -1;
+    }
+
+    for(int i = 0; i < nb_samples; i++)
+    {
+        const uint8_t *sample = data + i*LPS22HB_SAMPLE_SIZE;
+        int32_t raw = (int32_t)(((uint32_t)sample[2] << 24) | ((uint32_t)sample[1] << 16) | ((uint32_t)sample[0] << 8)) >> 8;
+        filter(raw/LPS22HB_SENSITIVITY);
+    }
+    return nb_samples;
+}
+
+/**
+ * @brief Reads the result of the previous one-shot and starts the next one, never waits for the conversion
+ *
+ * @return 1 if a sample was read, -1 on a bus error
+ */
+int BarometerSensor::readOneShot()
+{
+    int nb_samples = 0;
+
+    if(m_one_shot_pending)
+    {
+        uint8_t status;
+        if(readRegisters(LPS22HB_STATUS, &status, 1) != 0)
+        {
+            return -1;
+        }
+        if((status & LPS22HB_P_DA) == 0)
+        {
+            return 0;   //Conversion not over yet
+        }
+
+        uint8_t data[3];
+        if(readRegisters(LPS22HB_PRESS_OUT_XL, data, 3) != 0)
+        {
+            return -1;
+        }
+        int32_t raw = (int32_t)(((uint32_t)data[2] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[0] << 8)) >> 8;
+        filter(raw/LPS22HB_SENSITIVITY);
+        nb_samples = 1;
+    }
+
+    if(writeRegister(LPS22HB_CTRL_REG2, LPS22HB_IF_ADD_INC | LPS22HB_ONE_SHOT) != 0)
+    {
+        return -1;
+    }
+    m_one_shot_pending = true;
+    return nb_samples;
+}
+
+/**
+ * @brief First order low-pass filter on the pressure, then barometric formula relative to the reference
+ *
+ * @param pressure [hPa]
+ */
+void BarometerSensor::filter(float pressure)
+{
+    m_pressure = pressure;
+
+    if(m_reference <= 0)
+    {
+        m_reference = pressure;
+        m_filtered = pressure;
+    }
+
+    float dt = 1.0f/m_rate;
+    m_filtered += (pressure - m_filtered)*dt/(BARO_ALTITUDE_TAU + dt);
+    m_altitude = 44330.0f*(1.0f - powf(m_filtered/m_reference, 0.190295f));
+}
+
+int BarometerSensor::readRegisters(uint8_t reg, uint8_t *data, uint16_t length)
+{
+    return m_i2c->i2c_read(data, m_address, reg, length);
+}
+
+int BarometerSensor::writeRegister(uint8_t reg, uint8_t value)
+{
+    return m_i2c->i2c_write(&value, m_address, reg, 1);
+}
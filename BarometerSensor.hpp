@@ -0,0 +1,120 @@
+/**
+ * @file BarometerSensor.hpp
+ * @author Corentin BENOIT
+ * @brief LPS22HB barometer on the PressureSensor interface, with a filtered relative altitude
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_BAROMETERSENSOR
+#define DEF_BAROMETERSENSOR
+
+#include "mbed.h"
+#include <cstdint>
+#include "DevI2C.h"
+#include "LSM6DSL/ST_INTERFACES/Sensors/PressureSensor.h"
+
+// I2C addresses, 8 bits
+const uint8_t LPS22HB_ADDRESS_LOW = 0xB8;   //SA0 = 0
+const uint8_t LPS22HB_ADDRESS_HIGH = 0xBA;  //SA0 = 1, B-L4S5I board
+
+// Registers
+const uint8_t LPS22HB_WHO_AM_I = 0x0F;
+const uint8_t LPS22HB_CTRL_REG1 = 0x10;
+const uint8_t LPS22HB_CTRL_REG2 = 0x11;
+const uint8_t LPS22HB_FIFO_CTRL = 0x14;
+const uint8_t LPS22HB_RES_CONF = 0x1A;
+const uint8_t LPS22HB_FIFO_STATUS = 0x26;
+const uint8_t LPS22HB_STATUS = 0x27;
+const uint8_t LPS22HB_PRESS_OUT_XL = 0x28;
+const uint8_t LPS22HB_LPFP_RES = 0x33;
+
+const uint8_t LPS22HB_ID = 0xB1;
+
+// CTRL_REG1
+const uint8_t LPS22HB_ODR_MASK = 0x70;
+const uint8_t LPS22HB_ODR_ONE_SHOT = 0x00;  //Power-down until a one-shot is requested
+const uint8_t LPS22HB_ODR_1HZ = 0x10;
+const uint8_t LPS22HB_ODR_10HZ = 0x20;
+const uint8_t LPS22HB_ODR_25HZ = 0x30;
+const uint8_t LPS22HB_ODR_50HZ = 0x40;
+const uint8_t LPS22HB_ODR_75HZ = 0x50;
+const uint8_t LPS22HB_EN_LPFP = 0x08;       //Internal low-pass filter
+const uint8_t LPS22HB_LPFP_CFG = 0x04;      //Bandwidth ODR/20 instead of ODR/9
+const uint8_t LPS22HB_BDU = 0x02;
+
+// CTRL_REG2
+const uint8_t LPS22HB_FIFO_EN = 0x40;
+const uint8_t LPS22HB_IF_ADD_INC = 0x10;
+const uint8_t LPS22HB_ONE_SHOT = 0x01;
+
+// FIFO_CTRL and FIFO_STATUS
+const uint8_t LPS22HB_FIFO_BYPASS = 0x00;
+const uint8_t LPS22HB_FIFO_STREAM = 0x40;
+const uint8_t LPS22HB_FIFO_LEVEL_MASK = 0x3F;
+
+// STATUS
+const uint8_t LPS22HB_P_DA = 0x01;
+
+const int LPS22HB_FIFO_SIZE = 32;           //Samples
+const int LPS22HB_SAMPLE_SIZE = 5;          //Pressure and temperature bytes of one FIFO slot
+const float LPS22HB_SENSITIVITY = 4096.0f;  //LSB/hPa
+
+// Burst size: longest I2C transfer allowed between two IMU samples
+const int BARO_FIFO_BURST = 4;              //Samples
+const float BARO_ALTITUDE_TAU = 1.0f;       //Time constant of the altitude low-pass filter [s]
+const float BARO_ONE_SHOT_RATE = 1.0f;      //Below this rate the sensor stays in power-down between one-shots [Hz]
+
+
+class BarometerSensor : public PressureSensor
+{
+public:
+    // Constructor
+    BarometerSensor(DevI2C *i2c, uint8_t address = LPS22HB_ADDRESS_HIGH);
+
+    // Destructor
+    virtual ~BarometerSensor();
+
+
+    // Assessors
+    const float &getRate() const;
+    const float &getPressure() const;
+    const float &getAltitude() const;
+    const float &getReference() const;
+
+    // Interface
+    virtual int init(void *init);
+    virtual int read_id(uint8_t *id);
+    virtual int get_pressure(float *pf_data);
+
+    //Methods
+    int configure(float rate);
+    int powerDown();
+    int update();
+    void resetReference();
+
+
+
+protected:
+    int readRegisters(uint8_t reg, uint8_t *data, uint16_t length);
+    int writeRegister(uint8_t reg, uint8_t value);
+    int readFifo();
+    int readOneShot();
+    void filter(float pressure);
+
+    DevI2C *m_i2c;
+    uint8_t m_address;
+
+    float m_rate;               //ODR in continuous mode, one-shot rate below BARO_ONE_SHOT_RATE [Hz]
+    bool m_one_shot;
+    bool m_one_shot_pending;
+
+    float m_pressure;           //Latest sample [hPa]
+    float m_filtered;           //Low-pass filtered pressure [hPa]
+    float m_reference;          //Pressure at the zero altitude [hPa], 0 until the first sample
+    float m_altitude;           //Relative altitude [m]
+};
+#endif
@@ -0,0 +1,262 @@
+/**
+ * @file BlockProcessor.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "BlockProcessor.hpp"
+#include <cstring>
+
+#if BLOCK_SIMD_DSP
+#include "cmsis.h"
+#elif BLOCK_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+
+
+using namespace std;
+
+static inline int32_t saturate16(int32_t value)
+{
+    if(value > INT16_MAX) return INT16_MAX;
+    if(value < INT16_MIN) return INT16_MIN;
+    return value;
+}
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+BlockProcessor::BlockProcessor(){
+    for(int i = 0; i < BLOCK_AXES; i++)
+    {
+        m_bias[i] = 0;
+        m_gain[i] = 1;
+    }
+    m_shift = 0;
+    m_low = INT16_MIN;
+    m_high = INT16_MAX;
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Offset removed from each axis, in LSB
+ *
+ * @param bias
+ */
+void BlockProcessor::setBias(const int16_t bias[BLOCK_AXES])
+{
+    for(int i = 0; i < BLOCK_AXES; i++)
+    {
+        m_bias[i] = bias[i];
+    }
+}
+
+/**
+ * @brief Gain of each axis in Q(shift): 1.0 is 1 << shift
+ *
+ * @param gain
+ * @param shift [0; 15], common to the three axes
+ */
+void BlockProcessor::setGain(const int16_t gain[BLOCK_AXES], int shift)
+{
+    for(int i = 0; i < BLOCK_AXES; i++)
+    {
+        m_gain[i] = gain[i];
+    }
+    m_shift = (shift < 0) ? 0 : ((shift > 15) ? 15 : shift);
+}
+
+/**
+ * @brief Range of the output, low <= high
+ *
+ * @param low
+ * @param high
+ */
+void BlockProcessor::setClamp(int16_t low, int16_t high)
+{
+    m_low = low;
+    m_high = high;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Interleaved XYZ samples, as read from the FIFO or the output registers, to one array per axis
+ *
+ * @param data block.length*BLOCK_SAMPLE_BYTES bytes
+ * @param block
+ */
+void BlockProcessor::unpack(const uint8_t *data, AxisBlock &block) const
+{
+    int16_t *x = block.axis[0];
+    int16_t *y = block.axis[1];
+    int16_t *z = block.axis[2];
+    int n = 0;
+
+#if BLOCK_SIMD_DSP
+    // Two samples are three words: x0 y0, z0 x1, y1 z1
+    for(; n + 2 <= block.length; n += 2)
+    {
+        uint32_t w[3];
+        memcpy(w, data + n*BLOCK_SAMPLE_BYTES, sizeof(w));
+        uint32_t xx = __PKHBT(w[0], w[1], 0);
+        uint32_t yy = __PKHBT(w[0] >> 16, w[2], 16);
+        uint32_t zz = __PKHBT(w[1], w[2], 0);
+        memcpy(x + n, &xx, sizeof(xx));
+        memcpy(y + n, &yy, sizeof(yy));
+        memcpy(z + n, &zz, sizeof(zz));
+    }
+#endif
+
+    for(; n < block.length; n++)
+    {
+        const uint8_t *sample = data + n*BLOCK_SAMPLE_BYTES;
+        x[n] = (int16_t)(sample[0] | (sample[1] << 8));
+        y[n] = (int16_t)(sample[2] | (sample[3] << 8));
+        z[n] = (int16_t)(sample[4] | (sample[5] << 8));
+    }
+}
+
+/**
+ * @brief Bias, gain and clamp of every sample of the block, in place
+ *
+ * @param block
+ */
+void BlockProcessor::process(AxisBlock &block) const
+{
+    for(int i = 0; i < BLOCK_AXES; i++)
+    {
+        processAxis(block.axis[i], block.length, i);
+    }
+}
+
+/**
+ * @brief Scalar unpack, one sample at a time
+ *
+ * @param data
+ * @param block
+ */
+void BlockProcessor::unpackReference(const uint8_t *data, AxisBlock &block) const
+{
+    for(int n = 0; n < block.length; n++)
+    {
+        for(int i = 0; i < BLOCK_AXES; i++)
+        {
+            const uint8_t *value = data + n*BLOCK_SAMPLE_BYTES + 2*i;
+            block.axis[i][n] = (int16_t)(value[0] | (value[1] << 8));
+        }
+    }
+}
+
+/**
+ * @brief Scalar process, the definition that the SIMD kernels follow
+ *
+ * @param block
+ */
+void BlockProcessor::processReference(AxisBlock &block) const
+{
+    for(int i = 0; i < BLOCK_AXES; i++)
+    {
+        for(int n = 0; n < block.length; n++)
+        {
+            block.axis[i][n] = processSample(block.axis[i][n], i);
+        }
+    }
+}
+
+/**
+ * @brief Kernels of this build
+ *
+ * @return const char* "dsp", "sse2" or "scalar"
+ */
+const char *BlockProcessor::getImplementation()
+{
+#if BLOCK_SIMD_DSP
+    return "dsp";
+#elif BLOCK_SIMD_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+int16_t BlockProcessor::processSample(int16_t raw, int axis) const
+{
+    int32_t round = (m_shift > 0) ? (1 << (m_shift - 1)) : 0;
+    int32_t value = saturate16((int32_t)raw - m_bias[axis]);
+    value = saturate16((value*m_gain[axis] + round) >> m_shift);
+    if(value < m_low) value = m_low;
+    if(value > m_high) value = m_high;
+    return (int16_t)value;
+}
+
+void BlockProcessor::processAxis(int16_t *samples, int length, int axis) const
+{
+    int32_t round = (m_shift > 0) ? (1 << (m_shift - 1)) : 0;
+    int n = 0;
+
+#if BLOCK_SIMD_DSP
+    // Two samples per word: QSUB16 for the bias, SMLAD against (gain, 0) and (0, gain) then SSAT for the gain, SSUB16 and SEL for the clamp
+    uint32_t bias = __PKHBT((uint16_t)m_bias[axis], (uint32_t)m_bias[axis], 16);
+    uint32_t gain_bottom = (uint16_t)m_gain[axis];
+    uint32_t gain_top = gain_bottom << 16;
+    uint32_t low = __PKHBT((uint16_t)m_low, (uint32_t)m_low, 16);
+    uint32_t high = __PKHBT((uint16_t)m_high, (uint32_t)m_high, 16);
+    for(; n + 2 <= length; n += 2)
+    {
+        uint32_t pair;
+        memcpy(&pair, samples + n, sizeof(pair));
+        pair = __QSUB16(pair, bias);
+        int32_t first = __SSAT((int32_t)__SMLAD(pair, gain_bottom, round) >> m_shift, 16);
+        int32_t second = __SSAT((int32_t)__SMLAD(pair, gain_top, round) >> m_shift, 16);
+        pair = __PKHBT((uint32_t)first, (uint32_t)second, 16);
+        __SSUB16(pair, low);
+        pair = __SEL(pair, low);
+        __SSUB16(pair, high);
+        pair = __SEL(high, pair);
+        memcpy(samples + n, &pair, sizeof(pair));
+    }
+#elif BLOCK_SIMD_SSE2
+    __m128i bias = _mm_set1_epi16(m_bias[axis]);
+    __m128i gain = _mm_set1_epi16(m_gain[axis]);
+    __m128i rounding = _mm_set1_epi32(round);
+    __m128i shift = _mm_cvtsi32_si128(m_shift);
+    __m128i low = _mm_set1_epi16(m_low);
+    __m128i high = _mm_set1_epi16(m_high);
+    for(; n + 8 <= length; n += 8)
+    {
+        __m128i value = _mm_subs_epi16(_mm_loadu_si128((const __m128i *)(samples + n)), bias);
+        __m128i product_low = _mm_mullo_epi16(value, gain);
+        __m128i product_high = _mm_mulhi_epi16(value, gain);
+        __m128i first = _mm_sra_epi32(_mm_add_epi32(_mm_unpacklo_epi16(product_low, product_high), rounding), shift);
+        __m128i second = _mm_sra_epi32(_mm_add_epi32(_mm_unpackhi_epi16(product_low, product_high), rounding), shift);
+        value = _mm_packs_epi32(first, second);
+        value = _mm_min_epi16(_mm_max_epi16(value, low), high);
+        _mm_storeu_si128((__m128i *)(samples + n), value);
+    }
+#endif
+
+    for(; n < length; n++)
+    {
+        samples[n] = processSample(samples[n], axis);
+    }
+}
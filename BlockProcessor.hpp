@@ -0,0 +1,77 @@
+/**
+ * @file BlockProcessor.hpp
+ * @author Corentin BENOIT
+ * @brief Fixed-point processing of blocks of 3-axis samples in structure of arrays, with packed SIMD when the target has it
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_BLOCKPROCESSOR
+#define DEF_BLOCKPROCESSOR
+
+#include <cstdint>
+
+#if defined(__ARM_FEATURE_DSP)
+#define BLOCK_SIMD_DSP 1        //Cortex-M4/M7: QSUB16, SMULBB/SMULTB, SSAT, SEL
+#elif defined(__SSE2__)
+#define BLOCK_SIMD_SSE2 1
+#endif
+
+const int BLOCK_AXES = 3;
+const int BLOCK_SAMPLE_BYTES = 2*BLOCK_AXES;    //X, Y, Z little endian, as in the output registers and the FIFO
+
+/**
+ * @brief Block of samples in structure of arrays, one int16 array per axis
+ */
+struct AxisBlock
+{
+    int16_t *axis[BLOCK_AXES];
+    int length;
+};
+
+
+/**
+ * @brief For each axis: v = sat16(raw - bias), v = sat16((v*gain + round) >> shift), v = clamp(v, low, high).
+ * Every step saturates, so the SIMD kernels and the scalar reference agree bit for bit.
+ * Only block_kernels_bench uses it for now, the firmware reads one sample per tick; it is meant for the FIFO block reads
+ */
+class BlockProcessor
+{
+public:
+    // Constructor
+    BlockProcessor();
+
+    // Destructor
+    ~BlockProcessor() = default;
+
+
+    // Assessors
+    void setBias(const int16_t bias[BLOCK_AXES]);
+    void setGain(const int16_t gain[BLOCK_AXES], int shift);
+    void setClamp(int16_t low, int16_t high);
+
+    //Methods
+    void unpack(const uint8_t *data, AxisBlock &block) const;
+    void process(AxisBlock &block) const;
+
+    void unpackReference(const uint8_t *data, AxisBlock &block) const;
+    void processReference(AxisBlock &block) const;
+
+    static const char *getImplementation();
+
+
+
+protected:
+    int16_t processSample(int16_t raw, int axis) const;
+    void processAxis(int16_t *samples, int length, int axis) const;
+
+    int16_t m_bias[BLOCK_AXES];
+    int16_t m_gain[BLOCK_AXES];     //Q(shift)
+    int m_shift;                    //[0; 15]
+    int16_t m_low;
+    int16_t m_high;
+};
+#endif
@@ -0,0 +1,435 @@
+/**
+ * @file CommandParser.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "CommandParser.hpp"
+#include <cstdlib>
+#include <cstring>
+#include "Log.hpp"
+
+
+
+using namespace std;
+
+// Time between two polls of the RX buffer
+#define COMMAND_POLL_PERIOD 20ms
+#define COMMAND_RUN_FLAG 0x01
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+CommandParser::CommandParser(const RuntimeConfig &config) : m_serial(NULL), m_length(0), m_overflow(false), m_pending(config), m_requests(NO_REQUEST), m_changed(false){
+    m_flags.set(COMMAND_RUN_FLAG);
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+CommandParser::~CommandParser()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+RuntimeConfig CommandParser::getConfig(){
+    m_mutex.lock();
+    RuntimeConfig config = m_pending;
+    m_mutex.unlock();
+    return config;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Thread body, polls the serial link forever. Must run in a low priority thread
+ *
+ */
+void CommandParser::run()
+{
+    while (1) {
+        //No timeout while paused, nothing wakes the MCU up
+        m_flags.wait_any(COMMAND_RUN_FLAG, osWaitForever, false);
+        poll();
+        ThisThread::sleep_for(COMMAND_POLL_PERIOD);
+    }
+}
+
+/**
+ * @brief Stops the polls once the current one is over, for the low-power mode
+ *
+ */
+void CommandParser::pause()
+{
+    m_flags.clear(COMMAND_RUN_FLAG);
+}
+
+/**
+ * @brief Polls again
+ *
+ */
+void CommandParser::resume()
+{
+    m_flags.set(COMMAND_RUN_FLAG);
+}
+
+/**
+ * @brief Reads the characters already received, never waits for new ones
+ *
+ */
+void CommandParser::poll()
+{
+    if(m_serial == NULL)
+    {
+        m_serial = mbed_file_handle(STDIN_FILENO);
+    }
+
+    char c;
+    while (m_serial->readable() && m_serial->read(&c, 1) == 1) {
+        if(c == '\n' || c == '\r')
+        {
+            //The reply leaves whole, between two console writes of the other threads
+            consoleLock();
+            if(m_length > 0 && !m_overflow)
+            {
+                m_line[m_length] = '\0';
+                parseLine(m_line);
+            }
+            else if(m_overflow)
+            {
+                printf("ERR line too long\n");
+            }
+            fflush(stdout);
+            consoleUnlock();
+            m_length = 0;
+            m_overflow = false;
+        }
+        else if(m_length < COMMAND_LENGTH - 1)
+        {
+            m_line[m_length++] = c;
+        }
+        else
+        {
+            m_overflow = true;
+        }
+    }
+}
+
+/**
+ * @brief Parses one command and updates the pending configuration, or adds a one-shot request
+ *
+ * rate <hz>              output rate
+ * odr <hz>               IMU rate and output data rate
+ * odr mag <hz>           magnetometer rate and output data rate
+ * odr baro <hz>          barometer output data rate
+ * fs acc <g>             accelerometer full scale
+ * fs gyro <dps>          gyroscope full scale
+ * fs mag <gauss>         magnetometer full scale
+ * ch <name>[,<name>...]  enabled channels among acc, gyro, mag, baro, touch, potr, potl, pot, steps, hip, torque, lift, expo, gait, fall, all
+ * fmt tab|csv|trace      column separator, or the binary trace of the raw data
+ * drop oldest|newest     record dropped when the output queue is full
+ * color b|g|r|y          colour of the gas springs, for the torque channel
+ * start / stop           streaming
+ * cal [N]                calibration with N samples
+ * idle <s>               time without motion before the low-power mode, 0 disables it
+ * stats                  prints and clears the I2C latency statistics
+ * prof                   prints and clears the I2C profiler counters
+ * mem                    prints the heap use and the allocations since the initialisation
+ * safety                 prints the safety event counts and their latency from the interrupt to the serial port
+ * expo [clear]           prints the exposure histograms, or starts a new shift
+ * expo trunk|hip <deg>[,<deg>...]  bin edges of the trunk or of both hip histograms, clears them
+ * cfg                    prints the configuration
+ *
+ * @param line
+ * @return true if the command is valid
+ */
+bool CommandParser::parseLine(const char *line)
+{
+    char command[16] = "";
+    char arg1[COMMAND_LENGTH] = "";     //As long as the line, a token is never cut
+    char arg2[COMMAND_LENGTH] = "";
+    static_assert(COMMAND_LENGTH == 64, "the widths of sscanf follow COMMAND_LENGTH");
+    sscanf(line, "%15s %63s %63s", command, arg1, arg2);
+
+    m_mutex.lock();
+    RuntimeConfig config = m_pending;
+    CommandRequest requests = m_requests;
+    m_mutex.unlock();
+    const char *error = NULL;
+
+    if(strcmp(command, "rate") == 0)
+    {
+        float rate = atof(arg1);
+        if(rate <= 0 || rate > 1000.0f) error = "rate must be in ]0; 1000] Hz";
+        else config.sampling_freq = rate;
+    }
+    else if(strcmp(command, "odr") == 0 && strcmp(arg1, "mag") == 0)
+    {
+        float rate = atof(arg2);
+        if(rate <= 0 || rate > 80.0f) error = "odr mag must be in ]0; 80] Hz";
+        else config.mag_freq = rate;
+    }
+    else if(strcmp(command, "odr") == 0 && strcmp(arg1, "baro") == 0)
+    {
+        float rate = atof(arg2);
+        if(rate <= 0 || rate > 75.0f) error = "odr baro must be in ]0; 75] Hz";
+        else config.baro_freq = rate;
+    }
+    else if(strcmp(command, "odr") == 0)
+    {
+        float rate = atof(arg1);
+        if(rate < 12.5f || rate > 6660.0f) error = "odr must be in [12.5; 6660] Hz";
+        else config.imu_freq = rate;
+    }
+    else if(strcmp(command, "fs") == 0)
+    {
+        float full_scale = atof(arg2);
+        if(strcmp(arg1, "acc") == 0 && full_scale > 0 && full_scale <= 16.0f) config.sensibility_acc = full_scale;
+        else if(strcmp(arg1, "gyro") == 0 && full_scale > 0 && full_scale <= 2000.0f) config.sensibility_gyro = full_scale;
+        else if(strcmp(arg1, "mag") == 0 && full_scale > 0 && full_scale <= 16.0f) config.sensibility_mag = full_scale;
+        else error = "usage: fs acc <2..16> | fs gyro <125..2000> | fs mag <4..16>";
+    }
+    else if(strcmp(command, "ch") == 0)
+    {
+        if(!parseChannels(arg1, config.channels)) error = "unknown channel";
+    }
+    else if(strcmp(command, "fmt") == 0)
+    {
+        if(strcmp(arg1, "tab") == 0) config.format = FORMAT_TAB;
+        else if(strcmp(arg1, "csv") == 0) config.format = FORMAT_CSV;
+        else if(strcmp(arg1, "trace") == 0) config.format = FORMAT_TRACE;
+        else error = "usage: fmt tab|csv|trace";
+    }
+    else if(strcmp(command, "drop") == 0)
+    {
+        if(strcmp(arg1, "oldest") == 0) config.overflow = DROP_OLDEST;
+        else if(strcmp(arg1, "newest") == 0) config.overflow = DROP_NEWEST;
+        else error = "usage: drop oldest|newest";
+    }
+    else if(strcmp(command, "color") == 0)
+    {
+        if(strlen(arg1) == 1 && strchr("bgry", arg1[0]) != NULL) config.color = arg1[0];
+        else error = "usage: color b|g|r|y";
+    }
+    else if(strcmp(command, "start") == 0)
+    {
+        config.streaming = true;
+    }
+    else if(strcmp(command, "stop") == 0)
+    {
+        config.streaming = false;
+    }
+    else if(strcmp(command, "cal") == 0)
+    {
+        int N = (arg1[0] != '\0') ? atoi(arg1) : config.calibration_samples;
+        if(N <= 0) error = "usage: cal [N]";
+        else
+        {
+            config.calibration_samples = N;
+            requests.calibrate = true;
+        }
+    }
+    else if(strcmp(command, "idle") == 0)
+    {
+        float timeout = atof(arg1);
+        if(arg1[0] == '\0' || timeout < 0) error = "usage: idle <s>";
+        else config.idle_timeout = timeout;
+    }
+    else if(strcmp(command, "stats") == 0)
+    {
+        requests.bus_stats = true;
+    }
+    else if(strcmp(command, "prof") == 0)
+    {
+        requests.bus_profile = true;
+    }
+    else if(strcmp(command, "mem") == 0)
+    {
+        requests.mem_report = true;
+    }
+    else if(strcmp(command, "safety") == 0)
+    {
+        requests.safety_report = true;
+    }
+    else if(strcmp(command, "expo") == 0)
+    {
+        if(arg1[0] == '\0') requests.exposure.report = true;
+        else if(strcmp(arg1, "clear") == 0) requests.exposure.clear = true;
+        else if(strcmp(arg1, "trunk") == 0 && parseEdges(arg2, requests.exposure)) requests.exposure.signal = EXPOSURE_TRUNK;
+        else if(strcmp(arg1, "hip") == 0 && parseEdges(arg2, requests.exposure)) requests.exposure.signal = EXPOSURE_HIP_RIGHT;
+        else error = "usage: expo [clear] | expo trunk|hip <deg>[,<deg>...] ascending";
+    }
+    else if(strcmp(command, "cfg") == 0)
+    {
+        display();
+        return true;
+    }
+    else
+    {
+        error = "unknown command";
+    }
+
+    if(error != NULL)
+    {
+        printf("ERR %s\n", error);
+        return false;
+    }
+
+    m_mutex.lock();
+    m_pending = config;
+    m_requests = requests;
+    m_changed = true;
+    m_mutex.unlock();
+
+    printf("OK\n");
+    return true;
+}
+
+/**
+ * @brief Gives the new configuration to the acquisition loop, to be called at a sample boundary.
+ * Never blocks: if the parser is writing the configuration, it will be fetched at the next boundary
+ *
+ * @param config
+ * @param requests one-shot requests since the last fetch, NO_REQUEST if none
+ * @return true if the configuration changed or a request came
+ */
+bool CommandParser::fetch(RuntimeConfig &config, CommandRequest &requests)
+{
+    if(!m_mutex.trylock())
+    {
+        return false;
+    }
+
+    bool changed = m_changed;
+    if(changed)
+    {
+        config = m_pending;
+        requests = m_requests;
+        m_requests = NO_REQUEST;
+        m_changed = false;
+    }
+    m_mutex.unlock();
+
+    return changed;
+}
+
+/**
+ * @brief Information for the user
+ *
+ */
+void CommandParser::display()
+{
+    RuntimeConfig config = getConfig();
+    printf("rate %.1f Hz, odr %.1f Hz, fs acc %.0f g, fs gyro %.0f dps, odr mag %.1f Hz, fs mag %.0f gauss, odr baro %.1f Hz, channels 0x%02lx, fmt %s, drop %s, color %c, %s, cal N=%d, idle %.0f s\n",
+        config.sampling_freq,
+        config.imu_freq,
+        config.sensibility_acc,
+        config.sensibility_gyro,
+        config.mag_freq,
+        config.sensibility_mag,
+        config.baro_freq,
+        (unsigned long)config.channels,
+        (config.format == FORMAT_CSV) ? "csv" : (config.format == FORMAT_TRACE) ? "trace" : "tab",
+        (config.overflow == DROP_NEWEST) ? "newest" : "oldest",
+        config.color,
+        config.streaming ? "streaming" : "stopped",
+        config.calibration_samples,
+        config.idle_timeout);
+}
+
+/**
+ * @brief Converts a list like "acc,gyro,pot" into channel bits
+ *
+ * @param list
+ * @param channels
+ * @return true if every name is known
+ */
+bool CommandParser::parseChannels(char *list, uint32_t &channels) const
+{
+    uint32_t new_channels = 0;
+    char *saveptr = NULL;
+
+    for(char *name = strtok_r(list, ",", &saveptr); name != NULL; name = strtok_r(NULL, ",", &saveptr))
+    {
+        if(strcmp(name, "acc") == 0) new_channels |= CHANNEL_ACC;
+        else if(strcmp(name, "gyro") == 0) new_channels |= CHANNEL_GYRO;
+        else if(strcmp(name, "mag") == 0) new_channels |= CHANNEL_MAG;
+        else if(strcmp(name, "baro") == 0) new_channels |= CHANNEL_BARO;
+        else if(strcmp(name, "touch") == 0) new_channels |= CHANNEL_TOUCH;
+        else if(strcmp(name, "potr") == 0) new_channels |= CHANNEL_POT_RIGHT;
+        else if(strcmp(name, "potl") == 0) new_channels |= CHANNEL_POT_LEFT;
+        else if(strcmp(name, "pot") == 0) new_channels |= CHANNEL_POT_RIGHT | CHANNEL_POT_LEFT;
+        else if(strcmp(name, "steps") == 0) new_channels |= CHANNEL_STEPS;
+        else if(strcmp(name, "hip") == 0) new_channels |= CHANNEL_HIP;
+        else if(strcmp(name, "torque") == 0) new_channels |= CHANNEL_TORQUE;
+        else if(strcmp(name, "lift") == 0) new_channels |= CHANNEL_LIFT;
+        else if(strcmp(name, "expo") == 0) new_channels |= CHANNEL_EXPOSURE;
+        else if(strcmp(name, "gait") == 0) new_channels |= CHANNEL_GAIT;
+        else if(strcmp(name, "fall") == 0) new_channels |= CHANNEL_FALL;
+        else if(strcmp(name, "all") == 0) new_channels |= ALL_CHANNELS;
+        else return false;
+    }
+
+    if(new_channels == 0)
+    {
+        return false;
+    }
+    channels = new_channels;
+    return true;
+}
+
+/**
+ * @brief Converts a list like "0,20,60" into ascending bin edges
+ *
+ * @param list
+ * @param request
+ * @return true if the list is valid
+ */
+bool CommandParser::parseEdges(char *list, ExposureRequest &request) const
+{
+    int16_t edges[EXPOSURE_MAX_EDGES];
+    int nb_edges = 0;
+    char *saveptr = NULL;
+
+    for(char *value = strtok_r(list, ",", &saveptr); value != NULL; value = strtok_r(NULL, ",", &saveptr))
+    {
+        char *end = NULL;
+        long edge = strtol(value, &end, 10);
+        if(end == value || *end != '\0' || nb_edges == EXPOSURE_MAX_EDGES
+            || edge < EXPOSURE_MIN_ANGLE || edge > EXPOSURE_MAX_ANGLE
+            || (nb_edges > 0 && edge <= edges[nb_edges - 1]))
+        {
+            return false;
+        }
+        edges[nb_edges++] = (int16_t)edge;
+    }
+
+    if(nb_edges == 0)
+    {
+        return false;
+    }
+    memcpy(request.edges, edges, sizeof(edges));
+    request.nb_edges = nb_edges;
+    return true;
+}
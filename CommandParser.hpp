@@ -0,0 +1,61 @@
+/**
+ * @file CommandParser.hpp
+ * @author Corentin BENOIT
+ * @brief Non-blocking line-command parser on the serial RX path
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_COMMANDPARSER
+#define DEF_COMMANDPARSER
+
+#include "mbed.h"
+#include <cstdint>
+#include "RuntimeConfig.hpp"
+
+const int COMMAND_LENGTH = 64; //Longest command line accepted
+
+
+class CommandParser
+{
+public:
+    // Constructor
+    CommandParser(const RuntimeConfig &config);
+
+    // Destructor
+    ~CommandParser();
+
+
+    // Assessors
+    RuntimeConfig getConfig();
+
+    //Methods
+    void run();
+    void pause();
+    void resume();
+    void poll();
+    bool parseLine(const char *line);
+    bool fetch(RuntimeConfig &config, CommandRequest &requests);
+    void display();
+
+
+
+protected:
+    bool parseChannels(char *list, uint32_t &channels) const;
+    bool parseEdges(char *list, ExposureRequest &request) const;
+
+    FileHandle *m_serial;
+    EventFlags m_flags;         //Run flag, cleared while paused
+    char m_line[COMMAND_LENGTH];
+    int m_length;
+    bool m_overflow;            //Line too long, dropped until the next end of line
+
+    Mutex m_mutex;
+    RuntimeConfig m_pending;    //Protected by m_mutex
+    CommandRequest m_requests;  //Protected by m_mutex, not fetched yet
+    bool m_changed;             //Protected by m_mutex
+};
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file ExposureLog.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "ExposureLog.hpp"
+#include <cstdio>
+#include <cstring>
+#include "kvstore_global_api.h"
+#include "Log.hpp"
+
+
+
+using namespace std;
+
+// Default bins: the 20 and 60 deg limits of ISO 11226 for the trunk
+static const int16_t DEFAULT_TRUNK_EDGES[] = {0, 20, 45, 60, 90};
+static const int16_t DEFAULT_HIP_EDGES[] = {0, 30, 60, 90};
+static const char *SIGNAL_NAMES[EXPOSURE_NB_SIGNALS] = {"trunk", "hip right", "hip left"};
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+ExposureLog::ExposureLog(){
+    memset(&m_data, 0, sizeof(m_data));
+    m_data.version = EXPOSURE_VERSION;
+    setEdges(EXPOSURE_TRUNK, DEFAULT_TRUNK_EDGES, sizeof(DEFAULT_TRUNK_EDGES)/sizeof(DEFAULT_TRUNK_EDGES[0]));
+    setEdges(EXPOSURE_HIP_RIGHT, DEFAULT_HIP_EDGES, sizeof(DEFAULT_HIP_EDGES)/sizeof(DEFAULT_HIP_EDGES[0]));
+    setEdges(EXPOSURE_HIP_LEFT, DEFAULT_HIP_EDGES, sizeof(DEFAULT_HIP_EDGES)/sizeof(DEFAULT_HIP_EDGES[0]));
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+const ExposureData &ExposureLog::getData() const{
+    return m_data;
+}
+
+/**
+ * @brief New bins for one histogram, its time is cleared
+ *
+ * @param signal
+ * @param edges ascending [deg]
+ * @param nb_edges 1 to EXPOSURE_MAX_EDGES
+ * @return false if the edges are not valid, nothing changes then
+ */
+bool ExposureLog::setEdges(int signal, const int16_t *edges, int nb_edges)
+{
+    if(signal < 0 || signal >= EXPOSURE_NB_SIGNALS || nb_edges < 1 || nb_edges > EXPOSURE_MAX_EDGES)
+    {
+        return false;
+    }
+    for(int i = 0; i < nb_edges; i++)
+    {
+        if(edges[i] < EXPOSURE_MIN_ANGLE || edges[i] > EXPOSURE_MAX_ANGLE || (i > 0 && edges[i] <= edges[i - 1]))
+        {
+            return false;
+        }
+    }
+
+    m_data.nb_edges[signal] = nb_edges;
+    memset(m_data.edges[signal], 0, sizeof(m_data.edges[signal]));
+    memcpy(m_data.edges[signal], edges, nb_edges*sizeof(edges[0]));
+    memset(m_data.time_us[signal], 0, sizeof(m_data.time_us[signal]));
+    buildTable(signal);
+    return true;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Starts a new shift, the edges are kept
+ *
+ */
+void ExposureLog::clear()
+{
+    memset(m_data.time_us, 0, sizeof(m_data.time_us));
+    m_data.touch_us = 0;
+    m_data.total_us = 0;
+}
+
+/**
+ * @brief Adds the time of one sample, O(1)
+ *
+ * @param angle trunk pitch, right and left hip angles [deg]
+ * @param touch
+ * @param dt_us time since the last sample
+ */
+void ExposureLog::add(const float angle[EXPOSURE_NB_SIGNALS], bool touch, uint32_t dt_us)
+{
+    for(int s = 0; s < EXPOSURE_NB_SIGNALS; s++)
+    {
+        //Positive offset, so the truncation is a floor. NaN goes to the first bin
+        float offset = angle[s] - EXPOSURE_MIN_ANGLE;
+        int degree = 0;
+        if(offset >= EXPOSURE_TABLE_SIZE - 1)
+        {
+            degree = EXPOSURE_TABLE_SIZE - 1;
+        }
+        else if(offset > 0.0f)
+        {
+            degree = (int)offset;
+        }
+        m_data.time_us[s][m_bin[s][degree]] += dt_us;
+    }
+    if(touch)
+    {
+        m_data.touch_us += dt_us;
+    }
+    m_data.total_us += dt_us;
+}
+
+/**
+ * @brief Restores the histograms of the KVStore, at startup
+ *
+ * @return true if they were found
+ */
+bool ExposureLog::load()
+{
+    static ExposureData stored;     //Static, too large for the stack of a thread
+    size_t size = 0;
+    int status = kv_get(EXPOSURE_KEY, &stored, sizeof(stored), &size);
+    if(status != MBED_SUCCESS || size != sizeof(stored) || stored.version != EXPOSURE_VERSION)
+    {
+        return false;
+    }
+    for(int s = 0; s < EXPOSURE_NB_SIGNALS; s++)
+    {
+        if(stored.nb_edges[s] < 1 || stored.nb_edges[s] > EXPOSURE_MAX_EDGES)
+        {
+            return false;
+        }
+    }
+
+    m_data = stored;
+    for(int s = 0; s < EXPOSURE_NB_SIGNALS; s++)
+    {
+        buildTable(s);
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the histograms to the KVStore, a flash write: called by the output thread on a copy
+ *
+ * @param data
+ * @return true if written
+ */
+bool ExposureLog::save(const ExposureData &data)
+{
+    int status = kv_set(EXPOSURE_KEY, &data, sizeof(data), 0);
+    if(status != MBED_SUCCESS)
+    {
+        LOG_WARNING("Exposure not saved, KVStore error %d\n", status);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Prints the time and the share of the recorded time in every bin
+ *
+ */
+void ExposureLog::display() const
+{
+    float total_s = m_data.total_us/1000000.0f;
+    float scale = (m_data.total_us > 0) ? 100.0f/m_data.total_us : 0.0f;
+
+    printf("Exposure: %.0f s recorded, touch %.0f s (%.1f%%)\n",
+        total_s, m_data.touch_us/1000000.0f, m_data.touch_us*scale);
+    for(int s = 0; s < EXPOSURE_NB_SIGNALS; s++)
+    {
+        int nb_edges = m_data.nb_edges[s];
+        printf("  %-10s", SIGNAL_NAMES[s]);
+        for(int bin = 0; bin <= nb_edges; bin++)
+        {
+            char range[16];
+            if(bin == 0)
+            {
+                snprintf(range, sizeof(range), "<%d", m_data.edges[s][0]);
+            }
+            else if(bin == nb_edges)
+            {
+                snprintf(range, sizeof(range), ">=%d", m_data.edges[s][nb_edges - 1]);
+            }
+            else
+            {
+                snprintf(range, sizeof(range), "%d..%d", m_data.edges[s][bin - 1], m_data.edges[s][bin]);
+            }
+            printf(" %s: %.0f s %.1f%%", range, m_data.time_us[s][bin]/1000000.0f, m_data.time_us[s][bin]*scale);
+        }
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Bin of every whole degree, the number of edges at or below it
+ *
+ * @param signal
+ */
+void ExposureLog::buildTable(int signal)
+{
+    int bin = 0;
+    for(int i = 0; i < EXPOSURE_TABLE_SIZE; i++)
+    {
+        while (bin < m_data.nb_edges[signal] && m_data.edges[signal][bin] <= i + EXPOSURE_MIN_ANGLE) {
+            bin++;
+        }
+        m_bin[signal][i] = bin;
+    }
+}
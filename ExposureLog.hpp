@@ -0,0 +1,91 @@
+/**
+ * @file ExposureLog.hpp
+ * @author Corentin BENOIT
+ * @brief Time spent in trunk pitch and hip angle bins over a shift, and time with the touch sensor active
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_EXPOSURELOG
+#define DEF_EXPOSURELOG
+
+#include <cstdint>
+
+const int EXPOSURE_MAX_EDGES = 15;
+const int EXPOSURE_MAX_BINS = EXPOSURE_MAX_EDGES + 1;
+const int EXPOSURE_MIN_ANGLE = -90;         //Lowest angle of the bin lookup, anything below is in the first bin [deg]
+const int EXPOSURE_MAX_ANGLE = 180;         //Highest, anything above is in the last bin [deg]
+const int EXPOSURE_TABLE_SIZE = EXPOSURE_MAX_ANGLE - EXPOSURE_MIN_ANGLE + 1;
+const uint32_t EXPOSURE_VERSION = 1;        //Of the stored layout, a different one is ignored
+const char EXPOSURE_KEY[] = "/kv/exposure";
+
+// Histograms
+enum ExposureSignal
+{
+    EXPOSURE_TRUNK,
+    EXPOSURE_HIP_RIGHT,
+    EXPOSURE_HIP_LEFT,
+    EXPOSURE_NB_SIGNALS
+};
+
+/**
+ * @brief Everything that is stored, plain data, about 500 bytes whatever the length of the shift
+ */
+struct ExposureData
+{
+    uint32_t version;
+    uint8_t nb_edges[EXPOSURE_NB_SIGNALS];
+    int16_t edges[EXPOSURE_NB_SIGNALS][EXPOSURE_MAX_EDGES];     //Ascending, bin i is [edges[i-1]; edges[i]) [deg]
+    uint64_t time_us[EXPOSURE_NB_SIGNALS][EXPOSURE_MAX_BINS];
+    uint64_t touch_us;          //Touch sensor active
+    uint64_t total_us;          //Time recorded
+};
+
+// One-shot requests of the expo command
+struct ExposureRequest
+{
+    bool report;                //Print the histograms
+    bool clear;                 //Start a new shift
+    int8_t signal;              //New edges for EXPOSURE_TRUNK, or for both hips with EXPOSURE_HIP_RIGHT, -1 for none
+    uint8_t nb_edges;
+    int16_t edges[EXPOSURE_MAX_EDGES];
+};
+
+
+/**
+ * @brief Fixed memory. The bin of each whole degree is looked up in a table built when the edges change,
+ * so a sample costs one conversion and one load per histogram, no search and no division
+ */
+class ExposureLog
+{
+public:
+    // Constructor
+    ExposureLog();
+
+    // Destructor
+    ~ExposureLog() = default;
+
+
+    // Assessors
+    const ExposureData &getData() const;
+    bool setEdges(int signal, const int16_t *edges, int nb_edges);
+
+    //Methods
+    void clear();
+    void add(const float angle[EXPOSURE_NB_SIGNALS], bool touch, uint32_t dt_us);
+    bool load();
+    static bool save(const ExposureData &data);
+    void display() const;
+
+
+
+protected:
+    void buildTable(int signal);
+
+    ExposureData m_data;
+    uint8_t m_bin[EXPOSURE_NB_SIGNALS][EXPOSURE_TABLE_SIZE];    //Bin of each degree from EXPOSURE_MIN_ANGLE
+};
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file GaitDetector.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "GaitDetector.hpp"
+#include <cstring>
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+GaitDetector::GaitDetector(){
+    reset();
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+uint32_t GaitDetector::getCount() const{
+    return m_count;
+}
+
+float GaitDetector::getStrideTime() const{
+    return m_stride_us/1000000.0f;
+}
+
+float GaitDetector::getCadence() const{
+    //Two steps per stride
+    return (m_stride_us > 0.0f) ? 120000000.0f/m_stride_us : 0.0f;
+}
+
+const GaitEvent &GaitDetector::getEvent(int i) const{
+    return m_events[i];
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Forgets everything, the count included
+ *
+ */
+void GaitDetector::reset()
+{
+    m_started = false;
+    m_last_us = 0;
+    m_count = 0;
+    m_nb_events = 0;
+    memset(m_last_angle, 0, sizeof(m_last_angle));
+    memset(m_velocity, 0, sizeof(m_velocity));
+    memset(m_events, 0, sizeof(m_events));
+    restart();
+}
+
+/**
+ * @brief New IMU sample of the hip estimates
+ *
+ * @param timestamp_us
+ * @param angle right, left [deg]
+ * @param velocity right, left [deg/s]
+ * @return number of events detected, getEvent() holds them
+ */
+int GaitDetector::update(int64_t timestamp_us, const float angle[GAIT_SIDES], const float velocity[GAIT_SIDES])
+{
+    m_nb_events = 0;
+    if(m_heel_strike_us >= 0 && timestamp_us - m_heel_strike_us > GAIT_TIMEOUT_US)
+    {
+        restart();
+    }
+
+    int64_t dt_us = timestamp_us - m_last_us;
+    if(m_started && dt_us <= 0)
+    {
+        return 0;
+    }
+    if(m_started && dt_us <= GAIT_MAX_STEP_US)
+    {
+        float gain = dt_us/(GAIT_SMOOTHING_US + (float)dt_us);
+        for(int side = 0; side < GAIT_SIDES; side++)
+        {
+            float smoothed = m_velocity[side] + gain*(velocity[side] - m_velocity[side]);
+            for(int kind = 0; kind < GAIT_NB_KINDS; kind++)
+            {
+                //Towards the peak flexion, or the peak extension
+                float towards = (kind == GAIT_HEEL_STRIKE) ? smoothed : -smoothed;
+                float threshold = GAIT_VELOCITY_FRACTION*m_peak_velocity[kind];
+                if(towards > ((threshold > GAIT_MIN_VELOCITY) ? threshold : GAIT_MIN_VELOCITY))
+                {
+                    m_armed[side][kind] = true;
+                }
+                if(towards > m_swing_velocity[side][kind])
+                {
+                    m_swing_velocity[side][kind] = towards;
+                }
+                if(detect(side, (GaitEventKind)kind, timestamp_us, angle, smoothed))
+                {
+                    m_nb_events++;
+                }
+            }
+            m_velocity[side] = smoothed;
+        }
+    }
+    else
+    {
+        //First sample, or the samples stopped: the velocities can't be compared
+        memset(m_armed, 0, sizeof(m_armed));
+        for(int side = 0; side < GAIT_SIDES; side++)
+        {
+            m_velocity[side] = velocity[side];
+        }
+        m_started = true;
+    }
+
+    m_last_us = timestamp_us;
+    for(int side = 0; side < GAIT_SIDES; side++)
+    {
+        m_last_angle[side] = angle[side];
+    }
+    return m_nb_events;
+}
+
+/**
+ * @brief The thresholds and the stride time start again from a normal walk
+ *
+ */
+void GaitDetector::restart()
+{
+    memset(m_armed, 0, sizeof(m_armed));
+    memset(m_swing_velocity, 0, sizeof(m_swing_velocity));
+    for(int side = 0; side < GAIT_SIDES; side++)
+    {
+        for(int kind = 0; kind < GAIT_NB_KINDS; kind++)
+        {
+            m_event_us[side][kind] = -1;
+        }
+    }
+    m_heel_strike_us = -1;
+    m_peak_angle[GAIT_HEEL_STRIKE] = GAIT_DEFAULT_FLEXION;
+    m_peak_angle[GAIT_TOE_OFF] = GAIT_DEFAULT_EXTENSION;
+    m_peak_velocity[GAIT_HEEL_STRIKE] = GAIT_DEFAULT_VELOCITY;
+    m_peak_velocity[GAIT_TOE_OFF] = GAIT_DEFAULT_VELOCITY;
+    m_stride_us = 0.0f;
+}
+
+/**
+ * @brief Zero crossing of the smoothed hip velocity between the last sample and this one, and its checks.
+ * On a velocity changing linearly, the smoothed one crosses GAIT_SMOOTHING_US late: the event time is corrected by it
+ *
+ * @param side
+ * @param kind
+ * @param timestamp_us
+ * @param angle both hips [deg]
+ * @param velocity smoothed, of this hip [deg/s]
+ * @return true if an event was added
+ */
+bool GaitDetector::detect(int side, GaitEventKind kind, int64_t timestamp_us, const float angle[GAIT_SIDES], float velocity)
+{
+    float direction = (kind == GAIT_HEEL_STRIKE) ? 1.0f : -1.0f;
+    float previous = direction*m_velocity[side];
+    float current = direction*velocity;
+    if(!m_armed[side][kind] || previous <= 0.0f || current > 0.0f)
+    {
+        return false;
+    }
+
+    float fraction = previous/(previous - current);
+    int64_t crossing_us = m_last_us + (int64_t)(fraction*(timestamp_us - m_last_us)) - (int64_t)GAIT_SMOOTHING_US;
+    float crossing_angle = m_last_angle[side] + fraction*(angle[side] - m_last_angle[side]);     //The peak is flat, the delay hardly changes it
+    float mid = 0.5f*(m_peak_angle[GAIT_HEEL_STRIKE] + m_peak_angle[GAIT_TOE_OFF]);
+    float half_range = 0.5f*(m_peak_angle[GAIT_HEEL_STRIKE] - m_peak_angle[GAIT_TOE_OFF]);
+
+    //A small wobble, or both hips together: stays armed for the real extremum
+    if(direction*(crossing_angle - mid) < GAIT_ANGLE_FRACTION*half_range
+        || direction*(crossing_angle - angle[1 - side]) < GAIT_MIN_SEPARATION)
+    {
+        return false;
+    }
+    float refractory_us = GAIT_REFRACTORY_FRACTION*m_stride_us;
+    if(refractory_us < GAIT_MIN_REFRACTORY_US)
+    {
+        refractory_us = GAIT_MIN_REFRACTORY_US;
+    }
+    if(m_event_us[side][kind] >= 0 && crossing_us - m_event_us[side][kind] < refractory_us)
+    {
+        return false;
+    }
+
+    adapt(side, kind, crossing_angle, crossing_us);
+
+    GaitEvent &event = m_events[m_nb_events];
+    event.index = ++m_count;
+    event.side = (uint8_t)side;
+    event.kind = kind;
+    event.timestamp_us = crossing_us;
+    event.detected_us = timestamp_us;
+    event.angle = crossing_angle;
+    event.stride_time = getStrideTime();
+    event.cadence = getCadence();
+    return true;
+}
+
+/**
+ * @brief Moves the running peaks and the stride time towards an accepted event
+ *
+ * @param side
+ * @param kind
+ * @param angle at the extremum [deg]
+ * @param timestamp_us of the extremum
+ */
+void GaitDetector::adapt(int side, GaitEventKind kind, float angle, int64_t timestamp_us)
+{
+    m_peak_angle[kind] += GAIT_ADAPT_GAIN*(angle - m_peak_angle[kind]);
+    m_peak_velocity[kind] += GAIT_ADAPT_GAIN*(m_swing_velocity[side][kind] - m_peak_velocity[kind]);
+    m_swing_velocity[side][kind] = 0.0f;
+    m_armed[side][kind] = false;
+
+    if(kind == GAIT_HEEL_STRIKE)
+    {
+        int64_t stride_us = timestamp_us - m_event_us[side][kind];
+        if(m_event_us[side][kind] >= 0 && stride_us >= GAIT_MIN_STRIDE_US && stride_us <= GAIT_MAX_STRIDE_US)
+        {
+            m_stride_us = (m_stride_us > 0.0f) ? m_stride_us + GAIT_STRIDE_GAIN*(stride_us - m_stride_us) : (float)stride_us;
+        }
+        m_heel_strike_us = timestamp_us;
+    }
+    m_event_us[side][kind] = timestamp_us;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file GaitDetector.hpp
+ * @author Corentin BENOIT
+ * @brief Streaming heel-strike and toe-off detection on the hip angles, with the running stride time and cadence
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_GAITDETECTOR
+#define DEF_GAITDETECTOR
+
+#include <cstdint>
+
+const float GAIT_MIN_VELOCITY = 30.0f;          //Arming floor, above the hip velocity of standing or shifting weight [deg/s]
+const float GAIT_VELOCITY_FRACTION = 0.35f;     //Arming threshold, fraction of the running peak velocity of the same direction
+const float GAIT_ANGLE_FRACTION = 0.25f;        //An extremum must be past the mid angle by this fraction of the half range
+const float GAIT_MIN_SEPARATION = 10.0f;        //The other hip must be that far on the other side, both hips bend together in a squat [deg]
+const float GAIT_ADAPT_GAIN = 0.25f;            //Of the running peaks, per accepted event
+const float GAIT_STRIDE_GAIN = 0.3f;            //Of the running stride time, per heel strike
+const float GAIT_REFRACTORY_FRACTION = 0.5f;    //Of the stride time, between two events of the same kind and side
+const int64_t GAIT_MIN_REFRACTORY_US = 300000;
+const int64_t GAIT_MIN_STRIDE_US = 600000;      //Heel strike intervals out of these bounds don't update the stride time
+const int64_t GAIT_MAX_STRIDE_US = 2500000;
+const int64_t GAIT_TIMEOUT_US = 3000000;        //No heel strike for that long: standing, the thresholds and the cadence start again
+const float GAIT_SMOOTHING_US = 30000.0f;       //Time constant of the velocity smoothing, the delay of the detection [us]
+const int64_t GAIT_MAX_STEP_US = 100000;        //Longer gaps between two updates disarm the detection
+const float GAIT_DEFAULT_FLEXION = 25.0f;       //Starting peaks, a normal walk [deg]
+const float GAIT_DEFAULT_EXTENSION = -10.0f;
+const float GAIT_DEFAULT_VELOCITY = 120.0f;     //[deg/s]
+const int GAIT_SIDES = 2;                       //Right, left
+
+// Kind of event, and index of the per kind arrays
+enum GaitEventKind
+{
+    GAIT_HEEL_STRIKE,       //Peak hip flexion of the late swing
+    GAIT_TOE_OFF,           //Peak hip extension of the late stance
+    GAIT_NB_KINDS
+};
+
+/**
+ * @brief One detected event, what the event path prints
+ */
+struct GaitEvent
+{
+    uint32_t index;             //Events detected since the start
+    uint8_t side;               //0 right, 1 left
+    GaitEventKind kind;
+    int64_t timestamp_us;       //Time of the extremum, interpolated between two IMU samples
+    int64_t detected_us;        //IMU sample that detected it, about GAIT_SMOOTHING_US later
+    float angle;                //Hip angle at the extremum [deg]
+    float stride_time;          //Running estimate, 0 until two heel strikes of a side [s]
+    float cadence;              //[steps/min]
+};
+
+
+/**
+ * @brief The hip extrema are the kinematic markers of the gait events: the peak flexion leads the heel strike and the
+ * peak extension leads the toe-off, each by a nearly constant share of the cycle. An extremum is the zero crossing of
+ * the smoothed hip velocity, found on the first IMU sample past it and dated back by the delay of the smoothing.
+ * It counts only if the velocity passed an arming threshold since the last event of that kind, if the angle is past
+ * the mid angle of the running peaks, if the other hip is on the other side, and after a refractory period.
+ * The thresholds follow the peaks of the accepted events. Fixed size, no heap
+ */
+class GaitDetector
+{
+public:
+    // Constructor
+    GaitDetector();
+
+    // Destructor
+    ~GaitDetector() = default;
+
+
+    // Assessors
+    uint32_t getCount() const;
+    float getStrideTime() const;
+    float getCadence() const;
+    const GaitEvent &getEvent(int i) const;
+
+    //Methods
+    void reset();
+    int update(int64_t timestamp_us, const float angle[GAIT_SIDES], const float velocity[GAIT_SIDES]);
+
+
+
+protected:
+    void restart();
+    bool detect(int side, GaitEventKind kind, int64_t timestamp_us, const float angle[GAIT_SIDES], float velocity);
+    void adapt(int side, GaitEventKind kind, float angle, int64_t timestamp_us);
+
+    bool m_started;
+    int64_t m_last_us;
+    float m_last_angle[GAIT_SIDES];
+    float m_velocity[GAIT_SIDES];                          //Smoothed [deg/s]
+    bool m_armed[GAIT_SIDES][GAIT_NB_KINDS];
+    float m_swing_velocity[GAIT_SIDES][GAIT_NB_KINDS];     //Largest velocity towards the extremum since the last one [deg/s]
+    int64_t m_event_us[GAIT_SIDES][GAIT_NB_KINDS];          //Last event of each kind, -1 for none
+    int64_t m_heel_strike_us;                               //Last heel strike of either side, for the timeout
+
+    float m_peak_angle[GAIT_NB_KINDS];          //Running peak flexion and extension, shared by both hips [deg]
+    float m_peak_velocity[GAIT_NB_KINDS];       //Running peak flexion and extension velocities, as magnitudes [deg/s]
+    float m_stride_us;                          //Running stride time, 0 until the first valid one
+
+    uint32_t m_count;
+    int m_nb_events;
+    GaitEvent m_events[GAIT_SIDES];             //Of the last update
+};
+#endif
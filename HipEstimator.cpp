@@ -0,0 +1,315 @@
+/**
+ * @file HipEstimator.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "HipEstimator.hpp"
+#include <cstring>
+
+
+
+using namespace std;
+
+// Uncertainty of a new estimate: the potentiometer angle, 20 deg/s, 1000 deg/s2 and a 5 deg/s bias
+static const float INITIAL_VARIANCE[HIP_STATES] = {HIP_POT_NOISE*HIP_POT_NOISE, 400.0f, 1.0e6f, 25.0f};
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+HipEstimator::HipEstimator(){
+    reset();
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+bool HipEstimator::isStarted() const{
+    return m_started;
+}
+
+bool HipEstimator::isGyroUsed() const{
+    return m_gyro_used;
+}
+
+float HipEstimator::getAngle() const{
+    return m_x[0];
+}
+
+float HipEstimator::getVelocity() const{
+    return m_x[1];
+}
+
+float HipEstimator::getAcceleration() const{
+    return m_x[2];
+}
+
+float HipEstimator::getGyroBias() const{
+    return m_x[3];
+}
+
+uint32_t HipEstimator::getRejected() const{
+    return m_rejected;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Forgets the estimate, start() begins a new one
+ *
+ */
+void HipEstimator::reset()
+{
+    m_started = false;
+    m_gyro_used = true;
+    m_timestamp_us = 0;
+    memset(m_x, 0, sizeof(m_x));
+    memset(m_p, 0, sizeof(m_p));
+    m_rejected = 0;
+    m_outliers = 0;
+    m_inconsistency = 1.0f;
+}
+
+/**
+ * @brief Begins at rest on a potentiometer angle, the gyroscope bias of the last estimate is kept
+ *
+ * @param angle [deg]
+ * @param timestamp_us
+ */
+void HipEstimator::start(float angle, int64_t timestamp_us)
+{
+    float bias = m_started ? m_x[3] : 0.0f;
+    memset(m_x, 0, sizeof(m_x));
+    memset(m_p, 0, sizeof(m_p));
+    m_x[0] = angle;
+    m_x[3] = bias;
+    m_inconsistency = 1.0f;
+    m_gyro_used = true;
+    for(int i = 0; i < HIP_STATES; i++)
+    {
+        m_p[i][i] = INITIAL_VARIANCE[i];
+    }
+    m_timestamp_us = timestamp_us;
+    m_started = true;
+}
+
+/**
+ * @brief Moves the state to the time of the next measurement. A gap longer than HIP_MAX_STEP restarts at the last angle
+ *
+ * @param timestamp_us
+ */
+void HipEstimator::predict(int64_t timestamp_us)
+{
+    if(!m_started || timestamp_us <= m_timestamp_us)
+    {
+        return;
+    }
+    float dt = (timestamp_us - m_timestamp_us)/1000000.0f;
+    if(dt > HIP_MAX_STEP)
+    {
+        start(m_x[0], timestamp_us);
+        return;
+    }
+    m_timestamp_us = timestamp_us;
+
+    float dt2 = dt*dt;
+    float dt3 = dt2*dt;
+    float f[HIP_STATES][HIP_STATES] = {
+        {1.0f, dt, 0.5f*dt2, 0.0f},
+        {0.0f, 1.0f, dt, 0.0f},
+        {0.0f, 0.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f},
+    };
+
+    m_x[0] += dt*m_x[1] + 0.5f*dt2*m_x[2];
+    m_x[1] += dt*m_x[2];
+
+    // P = F P F' + Q, Q of a white jerk on the motion and of a random walk on the bias
+    float fp[HIP_STATES][HIP_STATES];
+    for(int i = 0; i < HIP_STATES; i++)
+    {
+        for(int j = 0; j < HIP_STATES; j++)
+        {
+            float sum = 0.0f;
+            for(int k = 0; k < HIP_STATES; k++)
+            {
+                sum += f[i][k]*m_p[k][j];
+            }
+            fp[i][j] = sum;
+        }
+    }
+    for(int i = 0; i < HIP_STATES; i++)
+    {
+        for(int j = 0; j < HIP_STATES; j++)
+        {
+            float sum = 0.0f;
+            for(int k = 0; k < HIP_STATES; k++)
+            {
+                sum += fp[i][k]*f[j][k];
+            }
+            m_p[i][j] = sum;
+        }
+    }
+
+    float q = HIP_JERK_DENSITY;
+    m_p[0][0] += q*dt3*dt2/20.0f;
+    m_p[0][1] += q*dt3*dt/8.0f;
+    m_p[1][0] += q*dt3*dt/8.0f;
+    m_p[0][2] += q*dt3/6.0f;
+    m_p[2][0] += q*dt3/6.0f;
+    m_p[1][1] += q*dt3/3.0f;
+    m_p[1][2] += q*dt2/2.0f;
+    m_p[2][1] += q*dt2/2.0f;
+    m_p[2][2] += q*dt;
+    m_p[3][3] += HIP_BIAS_DENSITY*dt;
+}
+
+/**
+ * @brief Gyroscope pitch rate, after the calibration offset, at the time of the last predict()
+ *
+ * @param rate [deg/s]
+ */
+void HipEstimator::updateGyro(float rate)
+{
+    const float h[HIP_STATES] = {0.0f, 1.0f, 0.0f, 1.0f};
+    if(m_gyro_used)
+    {
+        update(h, rate, HIP_GYRO_NOISE*HIP_GYRO_NOISE, 0.0f);
+        return;
+    }
+
+    //Only compared with the estimate of the potentiometer
+    m_inconsistency += HIP_CONSISTENCY_RATE*(normalize(h, rate, HIP_GYRO_NOISE*HIP_GYRO_NOISE) - m_inconsistency);
+    if(m_inconsistency < HIP_GYRO_ON_LEVEL)
+    {
+        m_gyro_used = true;
+        m_inconsistency = 1.0f;
+    }
+}
+
+/**
+ * @brief Potentiometer angle, at the time of the last predict()
+ *
+ * @param angle [deg]
+ */
+void HipEstimator::updatePot(float angle)
+{
+    const float h[HIP_STATES] = {1.0f, 0.0f, 0.0f, 0.0f};
+    float normalized;
+    if(update(h, angle, HIP_POT_NOISE*HIP_POT_NOISE, HIP_POT_GATE, &normalized))
+    {
+        m_outliers = 0;
+        if(m_gyro_used)
+        {
+            m_inconsistency += HIP_CONSISTENCY_RATE*(normalized - m_inconsistency);
+            if(m_inconsistency > HIP_GYRO_OFF_LEVEL)
+            {
+                m_gyro_used = false;
+                m_inconsistency = HIP_GYRO_OFF_LEVEL;
+            }
+        }
+    }
+    else if(m_started && ++m_outliers >= HIP_MAX_OUTLIERS)
+    {
+        //The potentiometer is consistent again, but far from the estimate
+        start(angle, m_timestamp_us);
+        m_outliers = 0;
+    }
+}
+
+/**
+ * @brief Squared innovation of a measurement over its variance, the state is left unchanged
+ *
+ * @param h measurement row
+ * @param measurement
+ * @param variance of the measurement
+ * @return float 1 on average when the model holds
+ */
+float HipEstimator::normalize(const float h[HIP_STATES], float measurement, float variance) const
+{
+    float s = variance;
+    float innovation = measurement;
+    for(int i = 0; i < HIP_STATES; i++)
+    {
+        for(int j = 0; j < HIP_STATES; j++)
+        {
+            s += h[i]*m_p[i][j]*h[j];
+        }
+        innovation -= h[i]*m_x[i];
+    }
+    return innovation*innovation/s;
+}
+
+/**
+ * @brief Scalar measurement update, no matrix inversion
+ *
+ * @param h measurement row
+ * @param measurement
+ * @param variance of the measurement
+ * @param gate in standard deviations of the innovation, 0 accepts everything
+ * @param normalized squared innovation over its variance, optional
+ * @return true if the measurement was used
+ */
+bool HipEstimator::update(const float h[HIP_STATES], float measurement, float variance, float gate, float *normalized)
+{
+    if(!m_started)
+    {
+        return false;
+    }
+
+    float ph[HIP_STATES];
+    float s = variance;
+    float innovation = measurement;
+    for(int i = 0; i < HIP_STATES; i++)
+    {
+        ph[i] = 0.0f;
+        for(int j = 0; j < HIP_STATES; j++)
+        {
+            ph[i] += m_p[i][j]*h[j];
+        }
+        s += h[i]*ph[i];
+        innovation -= h[i]*m_x[i];
+    }
+
+    if(normalized != NULL)
+    {
+        *normalized = innovation*innovation/s;
+    }
+    if(gate > 0.0f && innovation*innovation > gate*gate*s)
+    {
+        m_rejected++;
+        return false;
+    }
+
+    for(int i = 0; i < HIP_STATES; i++)
+    {
+        m_x[i] += ph[i]/s*innovation;
+    }
+    // P = P - K H P, kept symmetric
+    for(int i = 0; i < HIP_STATES; i++)
+    {
+        for(int j = i; j < HIP_STATES; j++)
+        {
+            float value = m_p[i][j] - ph[i]*ph[j]/s;
+            m_p[i][j] = value;
+            m_p[j][i] = value;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file HipEstimator.hpp
+ * @author Corentin BENOIT
+ * @brief Angle, angular velocity and angular acceleration of one hip, Kalman fusion of the potentiometer angle and the gyroscope
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HIPESTIMATOR
+#define DEF_HIPESTIMATOR
+
+#include <cstddef>
+#include <cstdint>
+
+const int HIP_STATES = 4;                   //Angle [deg], velocity [deg/s], acceleration [deg/s2], gyroscope bias [deg/s]
+const float HIP_POT_NOISE = 0.8f;           //Potentiometer angle, standard deviation [deg]
+const float HIP_GYRO_NOISE = 0.15f;         //Gyroscope rate, standard deviation [deg/s]
+const float HIP_JERK_DENSITY = 2.0e6f;      //Power spectral density of the jerk [(deg/s3)2/Hz], how fast the motion may change
+const float HIP_BIAS_DENSITY = 100.0f;      //Random walk of the gyroscope bias [(deg/s)2/s], large enough to take the slow thigh motion too
+const float HIP_CONSISTENCY_RATE = 0.05f;   //Smoothing of the normalized innovations, per sample
+const float HIP_GYRO_OFF_LEVEL = 2.0f;      //Smoothed potentiometer innovation that stops using the gyroscope, the thighs move
+const float HIP_GYRO_ON_LEVEL = 0.65f;      //Smoothed gyroscope innovation that uses it again, the thighs are still
+const float HIP_POT_GATE = 6.0f;            //Potentiometer innovations beyond this many standard deviations are rejected, the wiper lost contact
+const int HIP_MAX_OUTLIERS = 40;            //Consecutive rejected potentiometer samples that restart the estimate on the potentiometer
+const float HIP_MAX_STEP = 0.1f;            //Longer gaps between two updates restart the estimate [s]
+
+
+/**
+ * @brief Constant acceleration model at the IMU rate. The gyroscope rate updates the velocity and its own bias,
+ * the potentiometer angle corrects the angle and so the drift. The gyroscope axis is the trunk pitch rate, equal
+ * to the hip rate only while the thighs are still: bending and lifting. When the potentiometer disagrees, walking,
+ * the gyroscope is left out until its rate matches the estimate of the potentiometer alone again.
+ * Fixed size, no heap, single precision for the FPU of the Cortex-M4
+ */
+class HipEstimator
+{
+public:
+    // Constructor
+    HipEstimator();
+
+    // Destructor
+    ~HipEstimator() = default;
+
+
+    // Assessors
+    bool isStarted() const;
+    bool isGyroUsed() const;
+    float getAngle() const;
+    float getVelocity() const;
+    float getAcceleration() const;
+    float getGyroBias() const;
+    uint32_t getRejected() const;
+
+    //Methods
+    void reset();
+    void start(float angle, int64_t timestamp_us);
+    void predict(int64_t timestamp_us);
+    void updateGyro(float rate);
+    void updatePot(float angle);
+
+
+
+protected:
+    float normalize(const float h[HIP_STATES], float measurement, float variance) const;
+    bool update(const float h[HIP_STATES], float measurement, float variance, float gate, float *normalized = NULL);
+
+    bool m_started;
+    bool m_gyro_used;
+    int64_t m_timestamp_us;     //Of the state
+    float m_x[HIP_STATES];
+    float m_p[HIP_STATES][HIP_STATES];
+    uint32_t m_rejected;        //Potentiometer samples out of the gate
+    int m_outliers;             //Consecutive ones
+    float m_inconsistency;      //Smoothed normalized innovation of the potentiometer, or of the gyroscope when it is left out, 1 when the model holds
+};
+#endif
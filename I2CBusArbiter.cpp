@@ -0,0 +1,319 @@
+/**
+ * @file I2CBusArbiter.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "I2CBusArbiter.hpp"
+#include <cstring>
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+I2CBusArbiter::I2CBusArbiter(DevI2C &bus, const Timer &clock) : m_bus(bus), m_clock(clock), m_frequency(100000),
+    m_nb_devices(0), m_nb_pending(0){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+I2CBusArbiter::~I2CBusArbiter()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+void I2CBusArbiter::setFrequency(int frequency){
+    m_frequency = frequency;
+}
+
+int I2CBusArbiter::getNbPending() const{
+    return m_nb_pending;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Registers a device of the bus
+ *
+ * @param address 8 bits I2C address
+ * @param increment_flag bit OR-ed to the register of multi-byte reads
+ * @param name for the statistics
+ * @return index of the device, -1 if the table is full
+ */
+int I2CBusArbiter::addDevice(uint8_t address, uint8_t increment_flag, const char *name)
+{
+    if(m_nb_devices >= MAX_ARBITER_DEVICES)
+    {
+        return -1;
+    }
+
+    Device &device = m_devices[m_nb_devices];
+    device.address = address;
+    device.increment_flag = increment_flag;
+    device.name = name;
+    m_nb_devices++;
+    resetStats();
+    return m_nb_devices - 1;
+}
+
+/**
+ * @brief Queues a read, sorted by deadline then priority
+ *
+ * @param transaction
+ * @return false if the queue is full or the transaction is already pending
+ */
+bool I2CBusArbiter::submit(I2CTransaction *transaction)
+{
+    if(m_nb_pending >= MAX_PENDING_TRANSACTIONS || transaction->status == TRANSACTION_PENDING
+        || transaction->device < 0 || transaction->device >= m_nb_devices)
+    {
+        return false;
+    }
+
+    transaction->status = TRANSACTION_PENDING;
+    transaction->submit_us = m_clock.elapsed_time().count();
+
+    int i = m_nb_pending;
+    while (i > 0) {
+        const I2CTransaction *previous = m_pending[i - 1];
+        bool before = transaction->deadline_us < previous->deadline_us
+            || (transaction->deadline_us == previous->deadline_us && transaction->priority > previous->priority);
+        if(!before)
+        {
+            break;
+        }
+        m_pending[i] = m_pending[i - 1];
+        i--;
+    }
+    m_pending[i] = transaction;
+    m_nb_pending++;
+    return true;
+}
+
+/**
+ * @brief Runs the pending reads in order, back-to-back with repeated starts.
+ * A read runs if its deadline is before until_us, or if it is over before until_us.
+ * The first read that can wait stops the run, so a slow sensor never delays the next IMU tick
+ *
+ * @param until_us end of the time slot given to the bus
+ * @return number of transactions completed
+ */
+int I2CBusArbiter::run(int64_t until_us)
+{
+    int nb_done = 0;
+    bool bus_held = false;
+
+    m_bus.lock();
+    while (m_nb_pending > 0) {
+        // Adjacent registers of the same device are read at once
+        int nb_transactions = 1;
+        int length = m_pending[0]->length;
+        while (nb_transactions < m_nb_pending
+            && mergeable(m_pending[nb_transactions - 1], m_pending[nb_transactions])
+            && length + m_pending[nb_transactions]->length <= ARBITER_MERGE_SIZE) {
+            length += m_pending[nb_transactions]->length;
+            nb_transactions++;
+        }
+
+        int64_t now_us = m_clock.elapsed_time().count();
+        bool due = m_pending[0]->deadline_us <= until_us;
+        if(!due && now_us + estimate(length) > until_us)
+        {
+            break;
+        }
+
+        nb_done += execute(nb_transactions, length, bus_held);
+    }
+
+    if(bus_held)
+    {
+        m_bus.stop();
+    }
+    m_bus.unlock();
+
+    return nb_done;
+}
+
+/**
+ * @brief Information for the user
+ *
+ */
+void I2CBusArbiter::display() const
+{
+    for(int i = 0; i < m_nb_devices; i++)
+    {
+        const Device &device = m_devices[i];
+        printf("I2C %s: %lu reads, %lu merged, mean %d us, max %d us, %lu late, %lu errors\n",
+            device.name,
+            (unsigned long)device.nb_transactions,
+            (unsigned long)device.nb_merged,
+            (device.nb_transactions > 0) ? (int)(device.total_latency_us/device.nb_transactions) : 0,
+            (int)device.max_latency_us,
+            (unsigned long)device.nb_missed,
+            (unsigned long)device.nb_errors);
+    }
+}
+
+/**
+ * @brief Clears the latency statistics
+ *
+ */
+void I2CBusArbiter::resetStats()
+{
+    for(int i = 0; i < m_nb_devices; i++)
+    {
+        Device &device = m_devices[i];
+        device.nb_transactions = 0;
+        device.nb_merged = 0;
+        device.nb_missed = 0;
+        device.nb_errors = 0;
+        device.total_latency_us = 0;
+        device.max_latency_us = 0;
+    }
+}
+
+/**
+ * @brief True when the second read starts right after the last register of the first one
+ *
+ * @param first
+ * @param second
+ * @return true
+ * @return false
+ */
+bool I2CBusArbiter::mergeable(const I2CTransaction *first, const I2CTransaction *second) const
+{
+    return first->device == second->device && first->reg + first->length == second->reg;
+}
+
+/**
+ * @brief Bus time of one read: address, register, repeated start and address, then the data, 9 clocks a byte
+ *
+ * @param length [bytes]
+ * @return [us]
+ */
+int64_t I2CBusArbiter::estimate(int length) const
+{
+    return (int64_t)(length + 3)*9*1000000/m_frequency + ARBITER_OVERHEAD_US;
+}
+
+/**
+ * @brief Reads the first pending transactions in one transfer and leaves the bus held for the next one
+ *
+ * @param nb_transactions merged transactions, at the head of the queue
+ * @param length total length
+ * @param bus_held true once a transfer ended without a stop condition
+ * @return nb_transactions
+ */
+int I2CBusArbiter::execute(int nb_transactions, int length, bool &bus_held)
+{
+    // Out of the queue before the completion callbacks, which may submit new reads
+    I2CTransaction *transactions[MAX_PENDING_TRANSACTIONS];
+    memcpy(transactions, m_pending, nb_transactions*sizeof(I2CTransaction *));
+    m_nb_pending -= nb_transactions;
+    memmove(m_pending, m_pending + nb_transactions, m_nb_pending*sizeof(I2CTransaction *));
+
+    I2CTransaction *first = transactions[0];
+    const Device &device = m_devices[first->device];
+
+    uint8_t reg = first->reg;
+    if(length > 1)
+    {
+        reg |= device.increment_flag;
+    }
+    uint8_t *buffer = (nb_transactions > 1) ? m_merge_buffer : first->buffer;
+
+#if MBED_CONF_APP_I2C_PROFILER
+    uint32_t start_us = I2CProfiler::instance().now();
+#endif
+
+    // The write starts with a repeated start when the previous read kept the bus
+    int ret = m_bus.write(device.address, (const char *)&reg, 1, true);
+    if(ret == 0)
+    {
+        ret = m_bus.read(device.address, (char *)buffer, length, true);
+    }
+    bus_held = true;
+
+#if MBED_CONF_APP_I2C_PROFILER
+    // Bypasses DevI2C::i2c_read for the repeated starts, counted here instead
+    I2CProfiler::instance().record(device.address, reg, length, false, ret != 0, start_us);
+#endif
+
+    int offset = 0;
+    for(int i = 0; i < nb_transactions; i++)
+    {
+        I2CTransaction *transaction = transactions[i];
+        if(nb_transactions > 1)
+        {
+            memcpy(transaction->buffer, m_merge_buffer + offset, transaction->length);
+            offset += transaction->length;
+        }
+        if(i > 0)
+        {
+            m_devices[transaction->device].nb_merged++;
+        }
+        complete(transaction, ret);
+    }
+
+    return nb_transactions;
+}
+
+/**
+ * @brief Statistics and completion callback of one transaction
+ *
+ * @param transaction
+ * @param ret bus status
+ */
+void I2CBusArbiter::complete(I2CTransaction *transaction, int ret)
+{
+    Device &device = m_devices[transaction->device];
+
+    transaction->complete_us = m_clock.elapsed_time().count();
+    transaction->status = (ret == 0) ? TRANSACTION_DONE : TRANSACTION_ERROR;
+
+    int64_t latency_us = transaction->complete_us - transaction->submit_us;
+    device.nb_transactions++;
+    device.total_latency_us += latency_us;
+    if(latency_us > device.max_latency_us)
+    {
+        device.max_latency_us = latency_us;
+    }
+    if(transaction->complete_us > transaction->deadline_us)
+    {
+        device.nb_missed++;
+    }
+    if(ret != 0)
+    {
+        device.nb_errors++;
+    }
+
+    if(transaction->done != NULL)
+    {
+        transaction->done(transaction);
+    }
+}
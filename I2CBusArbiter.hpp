@@ -0,0 +1,108 @@
+/**
+ * @file I2CBusArbiter.hpp
+ * @author Corentin BENOIT
+ * @brief Deadline ordered queue of register reads shared by the sensors of one I2C bus
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_I2CBUSARBITER
+#define DEF_I2CBUSARBITER
+
+#include "mbed.h"
+#include <cstdint>
+#include "DevI2C.h"
+
+const int MAX_ARBITER_DEVICES = 4;
+const int MAX_PENDING_TRANSACTIONS = 16;
+const int ARBITER_MERGE_SIZE = 32;          //Longest merged read [bytes]
+const int ARBITER_OVERHEAD_US = 20;         //Driver time of one transaction on top of the bus time
+
+// Transaction state
+enum TransactionStatus
+{
+    TRANSACTION_IDLE,
+    TRANSACTION_PENDING,
+    TRANSACTION_DONE,
+    TRANSACTION_ERROR,
+};
+
+/**
+ * @brief One register read. Owned by the caller, it must live until done is called
+ */
+struct I2CTransaction
+{
+    int device;                 //Index returned by addDevice()
+    uint8_t reg;                //First register
+    uint8_t *buffer;
+    uint16_t length;
+    int64_t deadline_us;        //Latest completion time
+    uint8_t priority;           //Higher first when the deadlines are equal
+    void (*done)(I2CTransaction *transaction);  //Called once read, may be NULL
+
+    // Filled in by the arbiter
+    TransactionStatus status;
+    int64_t submit_us;
+    int64_t complete_us;
+};
+
+
+class I2CBusArbiter
+{
+public:
+    // Constructor
+    I2CBusArbiter(DevI2C &bus, const Timer &clock);
+
+    // Destructor
+    ~I2CBusArbiter();
+
+
+    // Assessors
+    void setFrequency(int frequency);
+    int getNbPending() const;
+
+    //Methods
+    int addDevice(uint8_t address, uint8_t increment_flag, const char *name);
+    bool submit(I2CTransaction *transaction);
+    int run(int64_t until_us);
+    void display() const;
+    void resetStats();
+
+
+
+protected:
+    bool mergeable(const I2CTransaction *first, const I2CTransaction *second) const;
+    int64_t estimate(int length) const;
+    int execute(int nb_transactions, int length, bool &bus_held);
+    void complete(I2CTransaction *transaction, int ret);
+
+    struct Device
+    {
+        uint8_t address;            //8 bits I2C address
+        uint8_t increment_flag;     //Register bit enabling the address auto-increment, 0 if always on
+        const char *name;
+
+        uint32_t nb_transactions;
+        uint32_t nb_merged;         //Transactions read together with the previous one
+        uint32_t nb_missed;         //Completed after their deadline
+        uint32_t nb_errors;
+        int64_t total_latency_us;   //From submit to completion
+        int64_t max_latency_us;
+    };
+
+    DevI2C &m_bus;
+    const Timer &m_clock;
+    int m_frequency;            //[Hz]
+
+    Device m_devices[MAX_ARBITER_DEVICES];
+    int m_nb_devices;
+
+    I2CTransaction *m_pending[MAX_PENDING_TRANSACTIONS];    //Sorted by deadline, then priority
+    int m_nb_pending;
+
+    uint8_t m_merge_buffer[ARBITER_MERGE_SIZE];
+};
+#endif
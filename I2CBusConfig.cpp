@@ -0,0 +1,181 @@
+/**
+ * @file I2CBusConfig.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "I2CBusConfig.hpp"
+#include "Log.hpp"
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+I2CBusConfig::I2CBusConfig(DevI2C &bus) : m_bus(bus), m_nb_devices(0),
+    m_frequency(I2C_STANDARD_MODE), m_transaction_us(0), m_nb_errors(0){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+I2CBusConfig::~I2CBusConfig()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+const int& I2CBusConfig::getFrequency() const{
+    return m_frequency;
+}
+
+const int& I2CBusConfig::getTransactionTime() const{
+    return m_transaction_us;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Registers a device of the bus
+ *
+ * @param device
+ * @param id expected value of read_id()
+ * @param max_frequency fastest clock supported by the device [Hz]
+ * @param name for the report
+ * @return index of the device, -1 if the table is full
+ */
+int I2CBusConfig::addDevice(Component *device, uint8_t id, int max_frequency, const char *name)
+{
+    if(m_nb_devices >= MAX_BUS_DEVICES)
+    {
+        return -1;
+    }
+
+    Device &entry = m_devices[m_nb_devices];
+    entry.device = device;
+    entry.id = id;
+    entry.max_frequency = max_frequency;
+    entry.name = name;
+    return m_nb_devices++;
+}
+
+/**
+ * @brief Tries Fm+, then fast mode, then standard mode, skipping the clocks a device doesn't support.
+ * A clock is kept when every device answers I2C_CHECK_ROUNDS read_id round-trips with its ID
+ *
+ * @return the selected clock [Hz]
+ */
+int I2CBusConfig::autotune()
+{
+    const int candidates[] = {I2C_FAST_MODE_PLUS, I2C_FAST_MODE, I2C_STANDARD_MODE};
+
+    int max_frequency = I2C_FAST_MODE_PLUS;
+    for(int i = 0; i < m_nb_devices; i++)
+    {
+        if(m_devices[i].max_frequency < max_frequency)
+        {
+            max_frequency = m_devices[i].max_frequency;
+        }
+    }
+
+    m_frequency = I2C_STANDARD_MODE;
+    for(int frequency : candidates)
+    {
+        if(frequency <= max_frequency && check(frequency))
+        {
+            m_frequency = frequency;
+            break;
+        }
+    }
+
+    m_bus.frequency(m_frequency);
+    m_transaction_us = measure();
+    display();
+    return m_frequency;
+}
+
+/**
+ * @brief Information for the user
+ *
+ */
+void I2CBusConfig::display() const
+{
+    printf("I2C bus: %d kHz, %d us per read_id transaction, %d failed checks\n",
+        m_frequency/1000,
+        m_transaction_us,
+        m_nb_errors);
+}
+
+/**
+ * @brief read_id round-trips on every device at one clock
+ *
+ * @param frequency [Hz]
+ * @return true if every round-trip returned the expected ID
+ */
+bool I2CBusConfig::check(int frequency)
+{
+    m_bus.frequency(frequency);
+
+    for(int i = 0; i < m_nb_devices; i++)
+    {
+        for(int round = 0; round < I2C_CHECK_ROUNDS; round++)
+        {
+            uint8_t id = 0;
+            if(m_devices[i].device->read_id(&id) != 0 || id != m_devices[i].id)
+            {
+                LOG_WARNING("I2C bus: %s failed at %d kHz\n", m_devices[i].name, frequency/1000);
+                m_nb_errors++;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Mean time of one read_id transaction on the first device
+ *
+ * @return [us]
+ */
+int I2CBusConfig::measure()
+{
+    if(m_nb_devices == 0)
+    {
+        return 0;
+    }
+
+    const int nb_transactions = 100;
+    uint8_t id;
+    Timer t;
+
+    t.start();
+    for(int i = 0; i < nb_transactions; i++)
+    {
+        m_devices[0].device->read_id(&id);
+    }
+    t.stop();
+
+    return (int)(t.elapsed_time().count()/nb_transactions);
+}
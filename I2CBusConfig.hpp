@@ -0,0 +1,70 @@
+/**
+ * @file I2CBusConfig.hpp
+ * @author Corentin BENOIT
+ * @brief Selects the fastest I2C clock supported by every device of the bus
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_I2CBUSCONFIG
+#define DEF_I2CBUSCONFIG
+
+#include "mbed.h"
+#include <cstdint>
+#include "DevI2C.h"
+#include "Component.h"
+
+// I2C clocks [Hz]
+const int I2C_STANDARD_MODE = 100000;
+const int I2C_FAST_MODE = 400000;
+const int I2C_FAST_MODE_PLUS = 1000000;
+
+const int MAX_BUS_DEVICES = 4;
+const int I2C_CHECK_ROUNDS = 20;        //read_id round-trips per device to accept a clock
+
+
+class I2CBusConfig
+{
+public:
+    // Constructor
+    I2CBusConfig(DevI2C &bus);
+
+    // Destructor
+    ~I2CBusConfig();
+
+
+    // Assessors
+    const int &getFrequency() const;
+    const int &getTransactionTime() const;
+
+    //Methods
+    int addDevice(Component *device, uint8_t id, int max_frequency, const char *name);
+    int autotune();
+    void display() const;
+
+
+
+protected:
+    bool check(int frequency);
+    int measure();
+
+    struct Device
+    {
+        Component *device;
+        uint8_t id;             //Expected WHO_AM_I
+        int max_frequency;      //Fastest clock in the datasheet [Hz]
+        const char *name;
+    };
+
+    DevI2C &m_bus;
+    Device m_devices[MAX_BUS_DEVICES];
+    int m_nb_devices;
+
+    int m_frequency;            //Selected clock [Hz]
+    int m_transaction_us;       //Mean time of one read_id transaction at the selected clock
+    int m_nb_errors;            //Failed round-trips at the faster clocks
+};
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file I2CProfiler.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "I2CProfiler.hpp"
+#include <cstring>
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+I2CProfiler::I2CProfiler(){
+    reset();
+    m_clock.start();
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+I2CProfiler::~I2CProfiler()
+{
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Start time of a transaction
+ *
+ * @return uint32_t [us]
+ */
+uint32_t I2CProfiler::now() const
+{
+    return (uint32_t)m_clock.elapsed_time().count();
+}
+
+/**
+ * @brief Counts one transaction
+ *
+ * @param address 8 bits address
+ * @param reg first register
+ * @param length data bytes
+ * @param write
+ * @param error NACK or bus error
+ * @param start_us from now()
+ */
+void I2CProfiler::record(uint8_t address, uint8_t reg, uint16_t length, bool write, bool error, uint32_t start_us)
+{
+    uint32_t duration_us = now() - start_us;
+
+    Counters &counters = m_counters;
+
+    int d = 0;
+    while (d < counters.nb_devices && counters.devices[d].address != address) {
+        d++;
+    }
+    if(d == counters.nb_devices && counters.nb_devices < MAX_PROFILED_DEVICES)
+    {
+        counters.devices[counters.nb_devices++] = {address, 0, 0, 0};
+    }
+    if(d < counters.nb_devices)
+    {
+        counters.devices[d].nb_transactions++;
+        counters.devices[d].nb_bytes += length;
+        if(error)
+        {
+            counters.devices[d].nb_errors++;
+        }
+    }
+
+    int r = 0;
+    while (r < counters.nb_registers && (counters.registers[r].address != address || counters.registers[r].reg != reg)) {
+        r++;
+    }
+    if(r == counters.nb_registers && counters.nb_registers < MAX_PROFILED_REGISTERS)
+    {
+        counters.registers[counters.nb_registers++] = {address, reg, 0, 0, 0};
+    }
+    if(r < counters.nb_registers)
+    {
+        if(write) counters.registers[r].nb_writes++;
+        else counters.registers[r].nb_reads++;
+        counters.registers[r].nb_bytes += length;
+    }
+
+    counters.latency[bucket(duration_us)]++;
+    counters.tick_transactions++;
+    counters.tick_us += duration_us;
+}
+
+/**
+ * @brief Closes the bus cost of one sample tick, to be called once per output
+ *
+ */
+void I2CProfiler::tick()
+{
+    Counters &counters = m_counters;
+    counters.nb_ticks++;
+    counters.total_tick_us += counters.tick_us;
+    if(counters.tick_transactions > counters.max_tick_transactions)
+    {
+        counters.max_tick_transactions = counters.tick_transactions;
+    }
+    if(counters.tick_us > counters.max_tick_us)
+    {
+        counters.max_tick_us = counters.tick_us;
+    }
+    counters.tick_cost[bucket(counters.tick_us)]++;
+
+    counters.tick_transactions = 0;
+    counters.tick_us = 0;
+}
+
+/**
+ * @brief Compact report: per tick, per device, per register, then the histograms.
+ * The counters are copied under the bus lock, the bus is free again while the copy is printed
+ *
+ * @param bus the DevI2C the threads record under
+ * @param clear starts the counters again from the copy
+ */
+void I2CProfiler::dump(I2C &bus, bool clear)
+{
+    bus.lock();
+    m_report = m_counters;
+    if(clear)
+    {
+        reset();
+    }
+    bus.unlock();
+
+    const Counters &counters = m_report;
+    uint32_t nb_transactions = 0;
+    for(int i = 0; i < counters.nb_devices; i++)
+    {
+        nb_transactions += counters.devices[i].nb_transactions;
+    }
+
+    printf("I2C profile: %lu ticks, %.1f transactions and %lu us per tick, max %lu and %lu us\n",
+        (unsigned long)counters.nb_ticks,
+        (counters.nb_ticks > 0) ? (float)nb_transactions/counters.nb_ticks : 0.0f,
+        (unsigned long)((counters.nb_ticks > 0) ? counters.total_tick_us/counters.nb_ticks : 0),
+        (unsigned long)counters.max_tick_transactions,
+        (unsigned long)counters.max_tick_us);
+
+    for(int i = 0; i < counters.nb_devices; i++)
+    {
+        const DeviceStats &device = counters.devices[i];
+        printf("0x%02X: %lu transactions, %lu bytes, %lu errors\n",
+            device.address,
+            (unsigned long)device.nb_transactions,
+            (unsigned long)device.nb_bytes,
+            (unsigned long)device.nb_errors);
+
+        for(int j = 0; j < counters.nb_registers; j++)
+        {
+            const RegisterStats &reg = counters.registers[j];
+            if(reg.address == device.address)
+            {
+                printf("  0x%02X: %lu r, %lu w, %lu bytes\n",
+                    reg.reg,
+                    (unsigned long)reg.nb_reads,
+                    (unsigned long)reg.nb_writes,
+                    (unsigned long)reg.nb_bytes);
+            }
+        }
+    }
+
+    displayHistogram("latency", counters.latency);
+    displayHistogram("per tick", counters.tick_cost);
+}
+
+/**
+ * @brief Clears every counter, under the bus lock once the threads use the bus
+ *
+ */
+void I2CProfiler::reset()
+{
+    memset(&m_counters, 0, sizeof(m_counters));
+}
+
+/**
+ * @brief Profiler of every DevI2C
+ *
+ * @return I2CProfiler&
+ */
+I2CProfiler &I2CProfiler::instance()
+{
+    static I2CProfiler profiler;
+    return profiler;
+}
+
+int I2CProfiler::bucket(uint32_t duration_us)
+{
+    int i = 0;
+    uint32_t limit_us = PROFILER_FIRST_BUCKET_US;
+    while (i < PROFILER_BUCKETS - 1 && duration_us >= limit_us) {
+        limit_us *= 2;
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief One line, the upper bound of each bucket then its count
+ *
+ * @param name
+ * @param histogram
+ */
+void I2CProfiler::displayHistogram(const char *name, const uint32_t histogram[PROFILER_BUCKETS])
+{
+    printf("%s us:", name);
+    uint32_t limit_us = PROFILER_FIRST_BUCKET_US;
+    for(int i = 0; i < PROFILER_BUCKETS - 1; i++)
+    {
+        printf(" <%lu:%lu", (unsigned long)limit_us, (unsigned long)histogram[i]);
+        limit_us *= 2;
+    }
+    printf(" >=%lu:%lu\n", (unsigned long)(limit_us/2), (unsigned long)histogram[PROFILER_BUCKETS - 1]);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file I2CProfiler.hpp
+ * @author Corentin BENOIT
+ * @brief Counts and times the I2C transactions of DevI2C, per device and per register. Built with the i2c-profiler option
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_I2CPROFILER
+#define DEF_I2CPROFILER
+
+#include "mbed.h"
+#include <cstdint>
+
+const int MAX_PROFILED_DEVICES = 8;
+const int MAX_PROFILED_REGISTERS = 64;      //Device and register pairs, the next ones are counted in their device only
+const int PROFILER_BUCKETS = 10;            //Latency histogram: <16 us, then one bucket per doubling, the last one open
+const int PROFILER_FIRST_BUCKET_US = 16;
+
+
+/**
+ * @brief One instance shared by every DevI2C. The counters accumulate until dump(),
+ * tick() closes the bus cost of one sample tick. The threads that use the bus record under its lock
+ */
+class I2CProfiler
+{
+public:
+    // Constructor
+    I2CProfiler();
+
+    // Destructor
+    ~I2CProfiler();
+
+
+    //Methods
+    uint32_t now() const;
+    void record(uint8_t address, uint8_t reg, uint16_t length, bool write, bool error, uint32_t start_us);
+    void tick();
+    void dump(I2C &bus, bool clear);
+    void reset();
+
+    static I2CProfiler &instance();
+
+
+
+protected:
+    struct DeviceStats
+    {
+        uint8_t address;
+        uint32_t nb_transactions;
+        uint32_t nb_bytes;
+        uint32_t nb_errors;
+    };
+
+    struct RegisterStats
+    {
+        uint8_t address;
+        uint8_t reg;            //As sent, with the auto-increment bit of the device if any
+        uint32_t nb_reads;
+        uint32_t nb_writes;
+        uint32_t nb_bytes;
+    };
+
+    // Everything record() and tick() update, copied at once for a report
+    struct Counters
+    {
+        DeviceStats devices[MAX_PROFILED_DEVICES];
+        int nb_devices;
+        RegisterStats registers[MAX_PROFILED_REGISTERS];
+        int nb_registers;
+        uint32_t latency[PROFILER_BUCKETS];     //Per transaction
+
+        // Sample ticks
+        uint32_t tick_transactions;             //Since the last tick
+        uint32_t tick_us;
+        uint32_t nb_ticks;
+        uint32_t max_tick_transactions;
+        uint32_t max_tick_us;
+        uint64_t total_tick_us;
+        uint32_t tick_cost[PROFILER_BUCKETS];   //Bus time per tick
+    };
+
+    static int bucket(uint32_t duration_us);
+    static void displayHistogram(const char *name, const uint32_t histogram[PROFILER_BUCKETS]);
+
+    Timer m_clock;
+    Counters m_counters;        //Updated under the bus lock
+    Counters m_report;          //Copy printed by dump(), static rather than on the stack of the caller
+};
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file IdleManager.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "IdleManager.hpp"
+#include <cstdlib>
+#include "Log.hpp"
+
+
+
+using namespace std;
+
+#define WAKE_UP_FLAG 0x01
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+IdleManager::IdleManager(LSM6DSLSensor &imu, PinName wake_pin) : m_imu(imu), m_wake_pin(wake_pin), m_wake_irq(wake_pin),
+    m_timeout_us(0), m_wake_threshold(LSM6DSL_WAKE_UP_THRESHOLD_LOW),
+    m_last_motion_us(0), m_active_since_us(0), m_total_active_us(0), m_total_idle_us(0), m_nb_idle(0){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+IdleManager::~IdleManager()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+void IdleManager::setTimeout(float timeout_s){
+    m_timeout_us = (timeout_s > 0) ? (int64_t)(timeout_s*1000000.0f) : 0;
+}
+
+float IdleManager::getTimeout() const{
+    return m_timeout_us/1000000.0f;
+}
+
+void IdleManager::setWakeThreshold(uint8_t threshold){
+    m_wake_threshold = threshold;
+}
+
+const uint8_t& IdleManager::getWakeThreshold() const{
+    return m_wake_threshold;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Starts counting the active time
+ *
+ * @param now_us
+ */
+void IdleManager::start(int64_t now_us)
+{
+    m_last_motion_us = now_us;
+    m_active_since_us = now_us;
+}
+
+/**
+ * @brief The time without motion counts again from now, the active time goes on
+ *
+ * @param now_us
+ */
+void IdleManager::restartTimeout(int64_t now_us)
+{
+    m_last_motion_us = now_us;
+}
+
+/**
+ * @brief Motion detection on the gyroscope samples already read for the output, costs no bus access
+ *
+ * @param gyro [mdps]
+ * @param gyr_offset [mdps]
+ * @param timestamp_us
+ */
+void IdleManager::update(const int32_t gyro[3], const float gyr_offset[3], int64_t timestamp_us)
+{
+    for(int i = 0; i < 3; i++)
+    {
+        if(abs((int32_t)(gyro[i] - gyr_offset[i])) > IDLE_GYRO_THRESHOLD)
+        {
+            m_last_motion_us = timestamp_us;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief True once the wearer has been still for the timeout
+ *
+ * @param now_us
+ * @return true
+ * @return false
+ */
+bool IdleManager::idleDue(int64_t now_us) const
+{
+    return m_timeout_us > 0 && now_us - m_last_motion_us >= m_timeout_us;
+}
+
+/**
+ * @brief Pauses the streaming until the LSM6DSL detects a motion.
+ * The accelerometer runs at a low-power ODR with the wake-up event on INT2, the gyroscope is off,
+ * the acquisition timer and the console input are stopped so the MCU can enter deep sleep.
+ * The caller must configure the IMU again for streaming.
+ *
+ * @param t acquisition timer, it doesn't count the idle time
+ * @param sample_period_us longest wake-up latency when INT2 is not wired
+ */
+void IdleManager::sleep(Timer &t, int64_t sample_period_us)
+{
+    int64_t now_us = t.elapsed_time().count();
+    m_total_active_us += now_us - m_active_since_us;
+    m_nb_idle++;
+
+    LOG_INFO("Idle: no motion for %d s, streaming paused\n", (int)(m_timeout_us/1000000));
+
+    // Wake-up detection sets a 416 Hz ODR, the low-power ODR must be set after it
+    m_imu.enable_wake_up_detection(LSM6DSL_INT2_PIN);
+    m_imu.set_wake_up_threshold(m_wake_threshold);
+    m_imu.configure(IDLE_ODR, 2.0f, 2000.0f, LSM6DSL_LOW_POWER_MODE);
+    m_imu.disable_g();
+
+    // The high resolution timer and the console RX interrupt both prevent deep sleep
+    FileHandle *console = mbed_file_handle(STDIN_FILENO);
+    console->enable_input(false);
+    t.stop();
+
+    m_idle_timer.reset();
+    m_idle_timer.start();
+    waitWakeUp(sample_period_us);
+    m_idle_timer.stop();
+
+    t.start();
+    console->enable_input(true);
+    m_imu.disable_wake_up_detection();
+
+    int64_t idle_us = m_idle_timer.elapsed_time().count();
+    m_total_idle_us += idle_us;
+    start(t.elapsed_time().count());
+
+    LOG_INFO("Active: motion after %d s idle\n", (int)(idle_us/1000000));
+    consoleLock();
+    display();
+    fflush(stdout);
+    consoleUnlock();
+}
+
+/**
+ * @brief Information for the user
+ *
+ */
+void IdleManager::display() const
+{
+    printf("Idle periods : %lu, total active : %d s, total idle : %d s\n",
+        (unsigned long)m_nb_idle,
+        (int)(m_total_active_us/1000000),
+        (int)(m_total_idle_us/1000000));
+}
+
+/**
+ * @brief INT2 rising edge
+ *
+ */
+void IdleManager::wakeIrq()
+{
+    m_flags.set(WAKE_UP_FLAG);
+}
+
+/**
+ * @brief Blocks in deep sleep until the wake-up event.
+ * Without INT2, the wake-up source is polled once per sample period
+ *
+ * @param sample_period_us
+ * @return true if woken up by a motion
+ */
+bool IdleManager::waitWakeUp(int64_t sample_period_us)
+{
+    if(m_wake_pin != NC)
+    {
+        m_flags.clear(WAKE_UP_FLAG);
+        m_wake_irq.rise(callback(this, &IdleManager::wakeIrq));
+        m_wake_irq.enable_irq();
+        m_flags.wait_any(WAKE_UP_FLAG);
+        m_wake_irq.disable_irq();
+        return true;
+    }
+
+    LSM6DSL_Event_Status_t status;
+    while (1) {
+        ThisThread::sleep_for(chrono::microseconds(sample_period_us));
+        if(m_imu.get_event_status(&status) == 0 && status.WakeUpStatus)
+        {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * @file IdleManager.hpp
+ * @author Corentin BENOIT
+ * @brief Wake-on-motion low-power mode using the LSM6DSL wake-up detection
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_IDLEMANAGER
+#define DEF_IDLEMANAGER
+
+#include "mbed.h"
+#include <cstdint>
+#include "../LSM6DSL/LSM6DSLSensor.h"
+
+// Motion detection while streaming
+const int32_t IDLE_GYRO_THRESHOLD = 5000;   //Angular rate above which the wearer is moving [mdps]
+
+// IMU settings while idle
+const float IDLE_ODR = 26.0f;               //Low-power accelerometer ODR [Hz]
+
+
+class IdleManager
+{
+public:
+    // Constructor
+    IdleManager(LSM6DSLSensor &imu, PinName wake_pin = NC);
+
+    // Destructor
+    ~IdleManager();
+
+
+    // Assessors
+    void setTimeout(float timeout_s);
+    float getTimeout() const;
+    void setWakeThreshold(uint8_t threshold);
+    const uint8_t &getWakeThreshold() const;
+
+    //Methods
+    void start(int64_t now_us);
+    void restartTimeout(int64_t now_us);
+    void update(const int32_t gyro[3], const float gyr_offset[3], int64_t timestamp_us);
+    bool idleDue(int64_t now_us) const;
+    void sleep(Timer &t, int64_t sample_period_us);
+    void display() const;
+
+
+
+protected:
+    void wakeIrq();
+    bool waitWakeUp(int64_t sample_period_us);
+
+    LSM6DSLSensor &m_imu;
+    PinName m_wake_pin;         //MCU pin wired to the LSM6DSL INT2, NC to poll the wake-up source
+    InterruptIn m_wake_irq;
+    EventFlags m_flags;
+    LowPowerTimer m_idle_timer; //Keeps counting in deep sleep
+
+    int64_t m_timeout_us;       //0 disables the idle mode
+    uint8_t m_wake_threshold;   //LSM6DSL WK_THS, 1 LSB = FS/64
+
+    int64_t m_last_motion_us;
+    int64_t m_active_since_us;
+    int64_t m_total_active_us;
+    int64_t m_total_idle_us;
+    uint32_t m_nb_idle;
+};
+#endif
@@ -43,6 +43,9 @@
 /* Includes ------------------------------------------------------------------*/
 #include "mbed.h"
 #include "pinmap.h"
+#if MBED_CONF_APP_I2C_PROFILER
+#include "I2CProfiler.hpp"
+#endif
 
 /* Classes -------------------------------------------------------------------*/
 /** Helper class DevI2C providing functions for multi-register I2C communication
@@ -82,8 +85,19 @@ public:
         tmp[0] = RegisterAddr;
         memcpy(tmp+1, pBuffer, NumByteToWrite);
 
+        /* The bus lock also guards the profiler, the threads that use the bus record from under it */
+        lock();
+#if MBED_CONF_APP_I2C_PROFILER
+        /* Once the bus is ours, the wait for the lock is not bus time */
+        uint32_t start_us = I2CProfiler::instance().now();
+#endif
         ret = write(DeviceAddr, (const char*)tmp, NumByteToWrite+1, false);
 
+#if MBED_CONF_APP_I2C_PROFILER
+        I2CProfiler::instance().record(DeviceAddr, RegisterAddr, NumByteToWrite, true, ret != 0, start_us);
+#endif
+        unlock();
+
         if(ret) return -1;
         return 0;
     }
@@ -104,6 +118,11 @@ public:
                  uint16_t NumByteToRead) {
         int ret;
 
+        /* One lock for both, another thread can't start a transfer between the register address and the read */
+        lock();
+#if MBED_CONF_APP_I2C_PROFILER
+        uint32_t start_us = I2CProfiler::instance().now();
+#endif
         /* Send device address, with no STOP condition */
         ret = write(DeviceAddr, (const char*)&RegisterAddr, 1, true);
         if(!ret) {
@@ -111,6 +130,11 @@ public:
             ret = read(DeviceAddr, (char*)pBuffer, NumByteToRead, false);
         }
 
+#if MBED_CONF_APP_I2C_PROFILER
+        I2CProfiler::instance().record(DeviceAddr, RegisterAddr, NumByteToRead, false, ret != 0, start_us);
+#endif
+        unlock();
+
         if(ret) return -1;
         return 0;
     }
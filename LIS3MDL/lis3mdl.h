@@ -249,6 +249,11 @@ extern "C" {
  */
 #define LIS3MDL_I2C_MULTIPLEBYTE_CMD                      ((uint8_t)0x80)
 
+/**
+ * @brief Multiple Byte. Mask for enabling address auto-increment on the SPI interface (MS bit).
+ */
+#define LIS3MDL_SPI_MULTIPLEBYTE_CMD                      ((uint8_t)0x40)
+
 /**
  * @brief I2C Device Address
  */
@@ -46,7 +46,7 @@
 */
 
 LIS3MDL::LIS3MDL(SPI *spi, PinName cs_pin, PinName int_pin, SPI_type_t spi_type) : 
-                _dev_spi(spi), _cs_pin(cs_pin), _int_pin(int_pin), _spi_type(spi_type)
+                _dev_spi(spi), _cs_pin(cs_pin), _int_pin(int_pin), _spi_type(spi_type), _sensitivity(0.14f)
 {
     assert (spi);
     if (cs_pin == NC) 
@@ -65,7 +65,7 @@ LIS3MDL::LIS3MDL(SPI *spi, PinName cs_pin, PinName int_pin, SPI_type_t spi_type)
 }  
 
 LIS3MDL::LIS3MDL(DevI2C *i2c, uint8_t address, PinName int_pin) :
-       _dev_i2c(i2c), _address(address), _cs_pin(NC), _int_pin(int_pin)  
+       _dev_i2c(i2c), _address(address), _cs_pin(NC), _int_pin(int_pin), _sensitivity(0.14f)
 {
     assert (i2c);
     _dev_spi = NULL;
@@ -155,6 +155,11 @@ MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_Init(MAGNETO_InitTypeDef *LIS3MDL_Init)
     return MAGNETO_ERROR;
   }
   
+  if(LIS3MDL_M_UpdateSensitivity() != MAGNETO_OK)
+  {
+    return MAGNETO_ERROR;
+  }
+  
   /* Configure interrupt lines */
   LIS3MDL_IO_ITConfig();
   
@@ -187,52 +192,101 @@ MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_Read_M_ID(uint8_t *m_id)
  */
 MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_M_GetAxesRaw(int16_t *pData)
 {
-  uint8_t tempReg[2] = {0, 0};
+  uint8_t tempReg[6] = {0, 0, 0, 0, 0, 0};
   
-  if(LIS3MDL_IO_Read(&tempReg[0], (LIS3MDL_M_OUT_X_L_M | LIS3MDL_I2C_MULTIPLEBYTE_CMD),
-                     2) != MAGNETO_OK)
+  /* X, Y and Z in one transfer */
+  if(LIS3MDL_IO_Read(&tempReg[0], LIS3MDL_MultipleByte(LIS3MDL_M_OUT_X_L_M), 6) != MAGNETO_OK)
   {
     return MAGNETO_ERROR;
   }
   
   pData[0] = ((((int16_t)tempReg[1]) << 8) + (int16_t)tempReg[0]);
+  pData[1] = ((((int16_t)tempReg[3]) << 8) + (int16_t)tempReg[2]);
+  pData[2] = ((((int16_t)tempReg[5]) << 8) + (int16_t)tempReg[4]);
   
-  if(LIS3MDL_IO_Read(&tempReg[0], (LIS3MDL_M_OUT_Y_L_M | LIS3MDL_I2C_MULTIPLEBYTE_CMD),
-                     2) != MAGNETO_OK)
-  {
-    return MAGNETO_ERROR;
-  }
-  
-  pData[1] = ((((int16_t)tempReg[1]) << 8) + (int16_t)tempReg[0]);
+  return MAGNETO_OK;
+}
+
+
+/**
+ * @brief Read data from LIS3MDL Magnetic sensor and calculate Magnetic in mgauss
+ * @param pData the pointer where the magnetometer data are stored
+ * @retval MAGNETO_OK in case of success, an error code otherwise
+ */
+MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_M_GetAxes(int32_t *pData)
+{
+  int16_t pDataRaw[3];
   
-  if(LIS3MDL_IO_Read(&tempReg[0], (LIS3MDL_M_OUT_Z_L_M | LIS3MDL_I2C_MULTIPLEBYTE_CMD),
-                     2) != MAGNETO_OK)
+  if(LIS3MDL_M_GetAxesRaw(pDataRaw) != MAGNETO_OK)
   {
     return MAGNETO_ERROR;
   }
   
-  pData[2] = ((((int16_t)tempReg[1]) << 8) + (int16_t)tempReg[0]);
+  /* The sensitivity was cached when the full scale was set */
+  pData[0] = (int32_t)(pDataRaw[0] * _sensitivity);
+  pData[1] = (int32_t)(pDataRaw[1] * _sensitivity);
+  pData[2] = (int32_t)(pDataRaw[2] * _sensitivity);
   
   return MAGNETO_OK;
 }
 
 
 /**
- * @brief Read data from LIS3MDL Magnetic sensor and calculate Magnetic in mgauss
- * @param pData the pointer where the magnetometer data are stored
+ * @brief  Set LIS3MDL output data rate and full scale, in continuous-conversion mode
+ * @param  odr the output data rate in Hz, the next supported value is used
+ * @param  fs the full scale in gauss
  * @retval MAGNETO_OK in case of success, an error code otherwise
  */
-MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_M_GetAxes(int32_t *pData)
+MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_M_Configure(float odr, float fs)
 {
-  uint8_t tempReg = 0x00;
-  int16_t pDataRaw[3];
-  float sensitivity = 0;
+  uint8_t ctrl[3] = {0, 0, 0};
   
-  if(LIS3MDL_M_GetAxesRaw(pDataRaw) != MAGNETO_OK)
+  uint8_t new_odr = (odr <=  0.625f) ? LIS3MDL_M_DO_0_625
+                  : (odr <=  1.25f ) ? LIS3MDL_M_DO_1_25
+                  : (odr <=  2.5f  ) ? LIS3MDL_M_DO_2_5
+                  : (odr <=  5.0f  ) ? LIS3MDL_M_DO_5
+                  : (odr <= 10.0f  ) ? LIS3MDL_M_DO_10
+                  : (odr <= 20.0f  ) ? LIS3MDL_M_DO_20
+                  : (odr <= 40.0f  ) ? LIS3MDL_M_DO_40
+                  :                    LIS3MDL_M_DO_80;
+  
+  uint8_t new_fs = (fs <=  4.0f) ? LIS3MDL_M_FS_4
+                 : (fs <=  8.0f) ? LIS3MDL_M_FS_8
+                 : (fs <= 12.0f) ? LIS3MDL_M_FS_12
+                 :                 LIS3MDL_M_FS_16;
+  
+  /* CTRL_REG1 to CTRL_REG3 in one read and one write */
+  if(LIS3MDL_IO_Read(ctrl, LIS3MDL_MultipleByte(LIS3MDL_M_CTRL_REG1_M), 3) != MAGNETO_OK)
   {
     return MAGNETO_ERROR;
   }
   
+  ctrl[0] &= ~(LIS3MDL_M_DO_MASK | LIS3MDL_M_OM_MASK);
+  ctrl[0] |= new_odr | LIS3MDL_M_OM_HP;
+  
+  ctrl[1] &= ~(LIS3MDL_M_FS_MASK);
+  ctrl[1] |= new_fs;
+  
+  ctrl[2] &= ~(LIS3MDL_M_MD_MASK);
+  ctrl[2] |= LIS3MDL_M_MD_CONTINUOUS;
+  
+  if(LIS3MDL_IO_Write(ctrl, LIS3MDL_MultipleByte(LIS3MDL_M_CTRL_REG1_M), 3) != MAGNETO_OK)
+  {
+    return MAGNETO_ERROR;
+  }
+  
+  return LIS3MDL_M_UpdateSensitivity();
+}
+
+
+/**
+ * @brief  Read the full scale once and cache its sensitivity
+ * @retval MAGNETO_OK in case of success, an error code otherwise
+ */
+MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_M_UpdateSensitivity(void)
+{
+  uint8_t tempReg = 0x00;
+  
   if(LIS3MDL_IO_Read(&tempReg, LIS3MDL_M_CTRL_REG2_M, 1) != MAGNETO_OK)
   {
     return MAGNETO_ERROR;
@@ -243,23 +297,19 @@ MAGNETO_StatusTypeDef LIS3MDL::LIS3MDL_M_GetAxes(int32_t *pData)
   switch(tempReg)
   {
     case LIS3MDL_M_FS_4:
-      sensitivity = 0.14;
+      _sensitivity = 0.14;
       break;
     case LIS3MDL_M_FS_8:
-      sensitivity = 0.29;
+      _sensitivity = 0.29;
       break;
     case LIS3MDL_M_FS_12:
-      sensitivity = 0.43;
+      _sensitivity = 0.43;
       break;
     case LIS3MDL_M_FS_16:
-      sensitivity = 0.58;
+      _sensitivity = 0.58;
       break;
   }
   
-  pData[0] = (int32_t)(pDataRaw[0] * sensitivity);
-  pData[1] = (int32_t)(pDataRaw[1] * sensitivity);
-  pData[2] = (int32_t)(pDataRaw[2] * sensitivity);
-  
   return MAGNETO_OK;
 }
 
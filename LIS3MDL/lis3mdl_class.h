@@ -82,6 +82,20 @@ class LIS3MDL : public MagneticSensor {
 		return LIS3MDL_M_GetAxesRaw(pData);
 	}
 
+	/** Sets the output data rate and the full scale, the sensitivity is read back once and cached
+	 * @param[in] odr output data rate in Hz, the next supported rate is used (0.625 to 80 Hz)
+	 * @param[in] fs full scale in gauss (4, 8, 12 or 16)
+	 */
+	int configure(float odr, float fs) {
+		return LIS3MDL_M_Configure(odr, fs);
+	}
+
+	/** Sensitivity of the current full scale in mgauss/LSB
+	 */
+	float get_m_sensitivity(void) {
+		return _sensitivity;
+	}
+
  protected:
 	/*** Methods ***/
 	MAGNETO_StatusTypeDef LIS3MDL_Init(MAGNETO_InitTypeDef *LIS3MDL_Init);
@@ -89,6 +103,16 @@ class LIS3MDL : public MagneticSensor {
 	MAGNETO_StatusTypeDef LIS3MDL_M_GetAxes(int32_t *pData);
 	MAGNETO_StatusTypeDef LIS3MDL_M_GetAxesRaw(int16_t *pData);
 	MAGNETO_StatusTypeDef LIS3MDL_Set_SpiInterface (void *handle, LIS3MDL_SPIMode_t spimode);
+	MAGNETO_StatusTypeDef LIS3MDL_M_Configure(float odr, float fs);
+	MAGNETO_StatusTypeDef LIS3MDL_M_UpdateSensitivity(void);
+
+	/**
+	 * @brief  Register address with the auto-increment bit of the interface in use
+	 */
+	uint8_t LIS3MDL_MultipleByte(uint8_t RegisterAddr)
+	{
+		return RegisterAddr | (_dev_spi ? LIS3MDL_SPI_MULTIPLEBYTE_CMD : LIS3MDL_I2C_MULTIPLEBYTE_CMD);
+	}
 
 	/**
 	 * @brief  Configures LIS3MDL interrupt lines for NUCLEO boards
@@ -185,6 +209,7 @@ class LIS3MDL : public MagneticSensor {
     DigitalOut  _cs_pin; 
     InterruptIn _int_pin;    
     SPI_type_t _spi_type;        
+    float _sensitivity;     /* mgauss/LSB, cached so that the axes reads don't read CTRL_REG2 */
 };
 
 #endif // __LIS3MDL_CLASS_H
@@ -863,6 +863,154 @@ int LSM6DSLSensor::set_g_fs(float fullScale)
   return 0;
 }
 
+/**
+ * @brief  Configure both sensors for a sample rate in a single register burst
+ * @param  rate the rate at which the data will be read [Hz]
+ * @param  acc_fs the accelerometer full scale [g]
+ * @param  gyro_fs the gyroscope full scale [dps]
+ * @param  mode high-performance or low-power mode
+ * @param  oversampling ratio between the ODR and the rate, for decimation by the caller
+ * @note   The lowest ODR at least equal to rate * oversampling is selected, the digital
+ *         low-pass filters are set so the bandwidth stays below rate / 2.
+ *         CTRL1_XL to CTRL8_XL are read once and written back in one transaction,
+ *         both sensors are left enabled.
+ * @retval 0 in case of success, an error code otherwise
+ */
+int LSM6DSLSensor::configure(float rate, float acc_fs, float gyro_fs, LSM6DSL_Power_Mode_t mode, uint8_t oversampling)
+{
+  uint8_t ctrl[8];    /* CTRL1_XL to CTRL8_XL */
+  uint8_t odr_code;
+  uint8_t xl_fs_code;
+  uint8_t g_fs_code;
+  float odr;
+  float target;
+
+  if ( rate <= 0.0f || oversampling == 0 )
+  {
+    return 1;
+  }
+
+  /* Lowest ODR at least equal to the requested rate, same code for both sensors. */
+  target = rate * oversampling;
+  odr_code = ( target <=   13.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_13Hz
+           : ( target <=   26.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_26Hz
+           : ( target <=   52.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_52Hz
+           : ( target <=  104.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_104Hz
+           : ( target <=  208.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_208Hz
+           : ( target <=  416.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_416Hz
+           : ( target <=  833.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_833Hz
+           : ( target <= 1660.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_1660Hz
+           : ( target <= 3330.0f ) ? LSM6DSL_ACC_GYRO_ODR_XL_3330Hz
+           :                         LSM6DSL_ACC_GYRO_ODR_XL_6660Hz;
+  odr = ( target <=   13.0f ) ? 13.0f
+      : ( target <=   26.0f ) ? 26.0f
+      : ( target <=   52.0f ) ? 52.0f
+      : ( target <=  104.0f ) ? 104.0f
+      : ( target <=  208.0f ) ? 208.0f
+      : ( target <=  416.0f ) ? 416.0f
+      : ( target <=  833.0f ) ? 833.0f
+      : ( target <= 1660.0f ) ? 1660.0f
+      : ( target <= 3330.0f ) ? 3330.0f
+      :                         6660.0f;
+
+  xl_fs_code = ( acc_fs <= 2.0f ) ? LSM6DSL_ACC_GYRO_FS_XL_2g
+             : ( acc_fs <= 4.0f ) ? LSM6DSL_ACC_GYRO_FS_XL_4g
+             : ( acc_fs <= 8.0f ) ? LSM6DSL_ACC_GYRO_FS_XL_8g
+             :                      LSM6DSL_ACC_GYRO_FS_XL_16g;
+
+  g_fs_code = ( gyro_fs <=  125.0f ) ? ( uint8_t )LSM6DSL_ACC_GYRO_FS_125_ENABLED
+            : ( gyro_fs <=  245.0f ) ? ( uint8_t )LSM6DSL_ACC_GYRO_FS_G_245dps
+            : ( gyro_fs <=  500.0f ) ? ( uint8_t )LSM6DSL_ACC_GYRO_FS_G_500dps
+            : ( gyro_fs <= 1000.0f ) ? ( uint8_t )LSM6DSL_ACC_GYRO_FS_G_1000dps
+            :                          ( uint8_t )LSM6DSL_ACC_GYRO_FS_G_2000dps;
+
+  /* Read the whole control block in one burst, IF_INC is enabled by init(). */
+  if ( LSM6DSL_ACC_GYRO_read_reg( (void *)this, LSM6DSL_ACC_GYRO_CTRL1_XL, ctrl, 8 ) == MEMS_ERROR )
+  {
+    return 1;
+  }
+
+  /* CTRL1_XL: ODR, full scale, LPF1 at ODR/2. */
+  ctrl[0] &= ~( LSM6DSL_ACC_GYRO_ODR_XL_MASK | LSM6DSL_ACC_GYRO_FS_XL_MASK | LSM6DSL_CTRL1_XL_LPF1_BW_SEL );
+  ctrl[0] |= odr_code | xl_fs_code;
+
+  /* CTRL2_G: ODR, full scale. */
+  ctrl[1] &= ~( LSM6DSL_ACC_GYRO_ODR_G_MASK | LSM6DSL_ACC_GYRO_FS_G_MASK | LSM6DSL_ACC_GYRO_FS_125_MASK );
+  ctrl[1] |= odr_code | g_fs_code;
+
+  /* CTRL6_C and CTRL7_G: power mode. */
+  ctrl[5] &= ~( LSM6DSL_CTRL6_C_XL_HM_MODE | LSM6DSL_CTRL6_C_FTYPE_MASK );
+  ctrl[6] &= ~LSM6DSL_CTRL7_G_G_HM_MODE;
+  if ( mode == LSM6DSL_LOW_POWER_MODE )
+  {
+    ctrl[5] |= LSM6DSL_CTRL6_C_XL_HM_MODE;
+    ctrl[6] |= LSM6DSL_CTRL7_G_G_HM_MODE;
+  }
+
+  /* Low-pass filters: without oversampling the ODR is the rate rounded up to the next
+     ODR, LPF1 at ODR/2 is enough. Otherwise LPF2 cuts at most at rate / 2. */
+  ctrl[3] &= ~LSM6DSL_CTRL4_C_LPF1_SEL_G;
+  ctrl[7] &= ~( LSM6DSL_CTRL8_XL_LPF2_XL_EN | LSM6DSL_CTRL8_XL_HPCF_MASK | LSM6DSL_CTRL8_XL_INPUT_COMPOSITE | LSM6DSL_CTRL8_XL_HP_SLOPE_XL_EN );
+  if ( oversampling > 1 )
+  {
+    float divider = 2.0f * odr / rate;
+
+    if ( divider <= 4.0f )
+    {
+      ctrl[0] |= LSM6DSL_CTRL1_XL_LPF1_BW_SEL;
+    }
+    else
+    {
+      ctrl[7] |= LSM6DSL_CTRL8_XL_LPF2_XL_EN | LSM6DSL_CTRL8_XL_INPUT_COMPOSITE;
+      ctrl[7] |= ( divider <=   9.0f ) ? LSM6DSL_CTRL8_XL_HPCF_ODR_9
+               : ( divider <=  50.0f ) ? LSM6DSL_CTRL8_XL_HPCF_ODR_50
+               : ( divider <= 100.0f ) ? LSM6DSL_CTRL8_XL_HPCF_ODR_100
+               :                         LSM6DSL_CTRL8_XL_HPCF_ODR_400;
+    }
+
+    /* Gyroscope LPF1, narrower for higher oversampling. */
+    ctrl[3] |= LSM6DSL_CTRL4_C_LPF1_SEL_G;
+    ctrl[5] |= ( oversampling < 4 ) ? LSM6DSL_ACC_GYRO_LP_G_NARROW : LSM6DSL_ACC_GYRO_LP_G_VERY_NARROW;
+  }
+
+  /* Write the whole control block back in one burst. */
+  if ( LSM6DSL_ACC_GYRO_write_reg( (void *)this, LSM6DSL_ACC_GYRO_CTRL1_XL, ctrl, 8 ) == MEMS_ERROR )
+  {
+    return 1;
+  }
+
+  _x_last_odr = odr;
+  _x_is_enabled = 1;
+  _g_last_odr = odr;
+  _g_is_enabled = 1;
+
+  return 0;
+}
+
+/**
+ * @brief  Set the SPI mode and clock, the frequency is limited to the sensor's 10 MHz
+ * @param  frequency the SPI clock in Hz
+ * @retval 0 in case of success, an error code otherwise
+ */
+int LSM6DSLSensor::configure_spi(int frequency)
+{
+  if ( _dev_spi == NULL )
+  {
+    return 1;
+  }
+  
+  if ( frequency > LSM6DSL_SPI_MAX_FREQUENCY )
+  {
+    frequency = LSM6DSL_SPI_MAX_FREQUENCY;
+  }
+  
+  /* CPOL = 1, CPHA = 1 */
+  _dev_spi->format(8, 3);
+  _dev_spi->frequency(frequency);
+  
+  return 0;
+}
+
 /**
  * @brief  Enable free fall detection
  * @param pin the interrupt pin to be used
@@ -98,8 +98,32 @@
 #define LSM6DSL_TAP_DURATION_TIME_MID_HIGH  0x0C
 #define LSM6DSL_TAP_DURATION_TIME_HIGH      0x0F  /**< Highest value of wake up threshold */
 
+#define LSM6DSL_CTRL1_XL_LPF1_BW_SEL  0x02  /**< Accelerometer LPF1 bandwidth ODR/4 instead of ODR/2 */
+#define LSM6DSL_CTRL4_C_LPF1_SEL_G    0x02  /**< Gyroscope digital LPF1 enable */
+#define LSM6DSL_CTRL6_C_XL_HM_MODE    0x10  /**< Accelerometer high-performance mode disable */
+#define LSM6DSL_CTRL6_C_FTYPE_MASK    0x03  /**< Gyroscope LPF1 bandwidth selection */
+#define LSM6DSL_CTRL7_G_G_HM_MODE     0x80  /**< Gyroscope high-performance mode disable */
+#define LSM6DSL_CTRL8_XL_LPF2_XL_EN   0x80  /**< Accelerometer LPF2 enable */
+#define LSM6DSL_CTRL8_XL_HPCF_MASK    0x60  /**< Accelerometer LPF2 cutoff selection */
+#define LSM6DSL_CTRL8_XL_HPCF_ODR_50  0x00
+#define LSM6DSL_CTRL8_XL_HPCF_ODR_100 0x20
+#define LSM6DSL_CTRL8_XL_HPCF_ODR_9   0x40
+#define LSM6DSL_CTRL8_XL_HPCF_ODR_400 0x60
+#define LSM6DSL_CTRL8_XL_INPUT_COMPOSITE 0x08  /**< LPF2 input: low noise instead of low latency */
+#define LSM6DSL_CTRL8_XL_HP_SLOPE_XL_EN  0x04  /**< Accelerometer high-pass/slope filter selection */
+
+#define LSM6DSL_SPI_MAX_FREQUENCY  10000000  /**< SPI clock limit of the sensor [Hz] */
+#define LSM6DSL_SPI_BURST_SIZE     33        /**< Longest SPI transaction done with a single buffer transfer, address included */
+#define LSM6DSL_SPI_READ           0x80      /**< Read bit of the SPI address byte */
+
 /* Typedefs ------------------------------------------------------------------*/
 
+typedef enum
+{
+  LSM6DSL_HIGH_PERFORMANCE_MODE,
+  LSM6DSL_LOW_POWER_MODE           /**< Low-power up to 52 Hz, normal mode at 104 and 208 Hz */
+} LSM6DSL_Power_Mode_t;
+
 typedef enum
 {
   LSM6DSL_INT1_PIN,
@@ -145,6 +169,7 @@ class LSM6DSLSensor : public MotionSensor, public GyroSensor
     virtual int get_g_fs(float *fullScale);
     virtual int set_x_fs(float fullScale);
     virtual int set_g_fs(float fullScale);
+    int configure(float rate, float acc_fs, float gyro_fs, LSM6DSL_Power_Mode_t mode = LSM6DSL_HIGH_PERFORMANCE_MODE, uint8_t oversampling = 1);
     int enable_x(void);
     int enable_g(void);
     int disable_x(void);
@@ -181,6 +206,7 @@ class LSM6DSLSensor : public MotionSensor, public GyroSensor
     int get_event_status(LSM6DSL_Event_Status_t *status);
     int read_reg(uint8_t reg, uint8_t *data);
     int write_reg(uint8_t reg, uint8_t data);
+    int configure_spi(int frequency = LSM6DSL_SPI_MAX_FREQUENCY);
     
     /**
      * @brief  Attaching an interrupt handler to the INT1 interrupt.
@@ -255,11 +281,16 @@ class LSM6DSLSensor : public MotionSensor, public GyroSensor
         /* Write Reg Address */
             _dev_spi->lock();
             _cs_pin = 0;           
-            if (_spi_type == SPI4W) {            
-                _dev_spi->write(RegisterAddr | 0x80);
-                for (int i=0; i<NumByteToRead; i++) {
-                    *(pBuffer+i) = _dev_spi->write(0x00);
-                }
+            if (_spi_type == SPI4W && NumByteToRead < LSM6DSL_SPI_BURST_SIZE) {
+                /* Address and data in one buffer transfer */
+                char tx[LSM6DSL_SPI_BURST_SIZE] = {(char)(RegisterAddr | LSM6DSL_SPI_READ)};
+                char rx[LSM6DSL_SPI_BURST_SIZE];
+                _dev_spi->write(tx, NumByteToRead + 1, rx, NumByteToRead + 1);
+                memcpy(pBuffer, rx + 1, NumByteToRead);
+            } else if (_spi_type == SPI4W) {
+                /* Longer reads go straight into the caller's buffer */
+                _dev_spi->write(RegisterAddr | LSM6DSL_SPI_READ);
+                _dev_spi->write(NULL, 0, (char *)pBuffer, (int) NumByteToRead);
             } else if (_spi_type == SPI3W){
                 /* Write RD Reg Address with RD bit*/
                 uint8_t TxByte = RegisterAddr | 0x80;    
@@ -285,8 +316,15 @@ class LSM6DSLSensor : public MotionSensor, public GyroSensor
         if (_dev_spi) { 
             _dev_spi->lock();
             _cs_pin = 0;
-            _dev_spi->write(RegisterAddr);                    
-            _dev_spi->write((char *)pBuffer, (int) NumByteToWrite, NULL, 0);                     
+            if (NumByteToWrite < LSM6DSL_SPI_BURST_SIZE) {
+                /* Address and data in one buffer transfer */
+                char tx[LSM6DSL_SPI_BURST_SIZE] = {(char)RegisterAddr};
+                memcpy(tx + 1, pBuffer, NumByteToWrite);
+                _dev_spi->write(tx, NumByteToWrite + 1, NULL, 0);
+            } else {
+                _dev_spi->write(RegisterAddr);                    
+                _dev_spi->write((char *)pBuffer, (int) NumByteToWrite, NULL, 0);                     
+            }
             _cs_pin = 1;                    
             _dev_spi->unlock();
             return 0;                    
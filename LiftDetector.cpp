@@ -0,0 +1,150 @@
+/**
+ * @file LiftDetector.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "LiftDetector.hpp"
+#include <cstring>
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+LiftDetector::LiftDetector(){
+    reset();
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+bool LiftDetector::isInCycle() const{
+    return m_in_cycle;
+}
+
+uint32_t LiftDetector::getCount() const{
+    return m_count;
+}
+
+const LiftEvent &LiftDetector::getEvent() const{
+    return m_event;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Forgets the cycle in progress and the count, the next cycle starts once the trunk was upright
+ *
+ */
+void LiftDetector::reset()
+{
+    m_in_cycle = false;
+    m_upright = false;
+    m_last_us = 0;
+    m_last_hip = 0.0f;
+    m_count = 0;
+    memset(&m_current, 0, sizeof(m_current));
+    memset(&m_event, 0, sizeof(m_event));
+}
+
+/**
+ * @brief New sample of the fused angles
+ *
+ * @param timestamp_us
+ * @param trunk_pitch [deg]
+ * @param hip_angle right, left [deg]
+ * @param torque global torque of the rods [Nm]
+ * @param touch the touch sensor detects a load
+ * @return true when a cycle ends and is reported, getEvent() holds it
+ */
+bool LiftDetector::update(int64_t timestamp_us, float trunk_pitch, const float hip_angle[2], float torque, bool touch)
+{
+    float hip = 0.5f*(hip_angle[0] + hip_angle[1]);
+    bool gap = (timestamp_us - m_last_us > LIFT_MAX_STEP_US);
+    float hip_step = hip - m_last_hip;
+    m_last_us = timestamp_us;
+    m_last_hip = hip;
+
+    if(gap)
+    {
+        //The samples stopped, the cycle can't be measured, nor the end of one already under way when they come back
+        m_in_cycle = false;
+        m_upright = false;
+    }
+    if(trunk_pitch < LIFT_END_FLEXION)
+    {
+        m_upright = true;
+    }
+
+    if(!m_in_cycle)
+    {
+        if(m_upright && trunk_pitch > LIFT_START_FLEXION && hip > LIFT_START_HIP)
+        {
+            memset(&m_current, 0, sizeof(m_current));
+            m_current.kind = LIFT_BEND;
+            m_current.start_us = timestamp_us;
+            m_in_cycle = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else if(hip_step < 0.0f)
+    {
+        //The rods push the hips back to standing
+        m_current.work += torque*(-hip_step)*LIFT_DEG_TO_RAD;
+    }
+
+    if(trunk_pitch > m_current.peak_flexion)
+    {
+        m_current.peak_flexion = trunk_pitch;
+    }
+    if(hip > m_current.peak_hip)
+    {
+        m_current.peak_hip = hip;
+    }
+    if(torque > m_current.peak_torque)
+    {
+        m_current.peak_torque = torque;
+    }
+    if(touch)
+    {
+        m_current.kind = LIFT_CARRY;
+    }
+
+    if(trunk_pitch >= LIFT_END_FLEXION)
+    {
+        return false;
+    }
+
+    m_in_cycle = false;
+    m_current.end_us = timestamp_us;
+    if(m_current.end_us - m_current.start_us < LIFT_MIN_DURATION_US || m_current.peak_flexion < LIFT_MIN_PEAK)
+    {
+        return false;
+    }
+    m_current.duration_ms = (uint32_t)((m_current.end_us - m_current.start_us)/1000);
+    m_current.index = ++m_count;
+    m_event = m_current;
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file LiftDetector.hpp
+ * @author Corentin BENOIT
+ * @brief Segments the bend and lift cycles of the wearer and summarises each one in a few bytes
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_LIFTDETECTOR
+#define DEF_LIFTDETECTOR
+
+#include <cstdint>
+
+const float LIFT_START_FLEXION = 20.0f;     //Trunk pitch that starts a cycle [deg]
+const float LIFT_START_HIP = 15.0f;         //Mean hip angle that must confirm it, the trunk alone may just lean [deg]
+const float LIFT_END_FLEXION = 10.0f;       //Trunk pitch that ends it, hysteresis [deg]
+const float LIFT_MIN_PEAK = 30.0f;          //Shallower cycles are not reported [deg]
+const int64_t LIFT_MIN_DURATION_US = 500000;    //Shorter cycles are not reported
+const int64_t LIFT_MAX_STEP_US = 100000;    //Longer gaps between two updates abort the cycle, low-power mode for instance
+const float LIFT_DEG_TO_RAD = 0.01745329f;
+
+// Kind of cycle
+enum LiftKind
+{
+    LIFT_BEND,      //Nothing held
+    LIFT_CARRY,     //The touch sensor detected a load during the cycle
+};
+
+/**
+ * @brief Summary of one cycle, what the output prints instead of the samples
+ */
+struct LiftEvent
+{
+    uint32_t index;             //Cycles reported since the start
+    LiftKind kind;
+    int64_t start_us;
+    int64_t end_us;
+    uint32_t duration_ms;
+    float peak_flexion;         //Trunk pitch [deg]
+    float peak_hip;             //Mean of both hips [deg]
+    float peak_torque;          //Global torque [Nm]
+    float work;                 //Assisted work, given back by the rods while the hips extend [J]
+};
+
+
+/**
+ * @brief Two states: upright, and in a cycle from the moment the trunk and the hips bend past their start angles
+ * until the trunk comes back under LIFT_END_FLEXION. Updated with every IMU sample, fixed size
+ */
+class LiftDetector
+{
+public:
+    // Constructor
+    LiftDetector();
+
+    // Destructor
+    ~LiftDetector() = default;
+
+
+    // Assessors
+    bool isInCycle() const;
+    uint32_t getCount() const;
+    const LiftEvent &getEvent() const;
+
+    //Methods
+    void reset();
+    bool update(int64_t timestamp_us, float trunk_pitch, const float hip_angle[2], float torque, bool touch);
+
+
+
+protected:
+    bool m_in_cycle;
+    bool m_upright;             //The trunk came under LIFT_END_FLEXION since the last gap, a cycle may start
+    int64_t m_last_us;
+    float m_last_hip;           //Mean hip angle of the last update, for the work [deg]
+    uint32_t m_count;
+    LiftEvent m_current;        //Being measured
+    LiftEvent m_event;          //Last reported
+};
+#endif
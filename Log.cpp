@@ -0,0 +1,67 @@
+/**
+ * @file Log.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "Log.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include "mbed.h"
+
+
+
+using namespace std;
+
+static Mutex s_console;
+
+/**
+ * @brief Takes the console: the bytes of the other writers reach the serial port before or after the holder's own
+ *
+ */
+void consoleLock()
+{
+    s_console.lock();
+}
+
+void consoleUnlock()
+{
+    s_console.unlock();
+}
+
+/**
+ * @brief Formats one message on the stack and writes it at once, errors and warnings on stderr as before
+ *
+ * @param level LOG_LEVEL_ERROR to LOG_LEVEL_DEBUG
+ * @param format printf format, the message carries its own new line
+ * @param ...
+ */
+void logWrite(int level, const char *format, ...)
+{
+    char line[LOG_LINE_SIZE];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if(length < 0)
+    {
+        return;
+    }
+    if(length >= LOG_LINE_SIZE)
+    {
+        length = LOG_LINE_SIZE - 1;
+        line[length - 1] = '\n';
+    }
+
+    FILE *stream = (level <= LOG_LEVEL_WARNING) ? stderr : stdout;
+    consoleLock();
+    fwrite(line, 1, length, stream);
+    fflush(stream);
+    consoleUnlock();
+}
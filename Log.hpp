@@ -0,0 +1,61 @@
+/**
+ * @file Log.hpp
+ * @author Corentin BENOIT
+ * @brief Console messages with a level fixed at compile time, printf formatting into a fixed buffer, no heap
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_LOG
+#define DEF_LOG
+
+// Levels, for the log-level option of mbed_app.json
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef MBED_CONF_APP_LOG_LEVEL
+#define MBED_CONF_APP_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+const int LOG_LINE_SIZE = 128;      //Longer messages are cut, the last character becomes a new line
+
+void logWrite(int level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+// Every writer of the console but the output thread holds the lock from its first write to its fflush, recursive
+void consoleLock();
+void consoleUnlock();
+
+// A level above MBED_CONF_APP_LOG_LEVEL keeps the format checks but leaves no call and no string in the image
+#define LOG_DISCARD(...) do { if(0) logWrite(LOG_LEVEL_NONE, __VA_ARGS__); } while (0)
+
+#if MBED_CONF_APP_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if MBED_CONF_APP_LOG_LEVEL >= LOG_LEVEL_WARNING
+#define LOG_WARNING(...) logWrite(LOG_LEVEL_WARNING, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if MBED_CONF_APP_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if MBED_CONF_APP_LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file MemoryGuard.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "MemoryGuard.hpp"
+#include "mbed_mem_trace.h"
+#include "mbed_stats.h"
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+MemoryGuard::MemoryGuard(){
+    m_sealed = false;
+    m_late_allocations = 0;
+    m_first_caller = NULL;
+    m_sealed_size = 0;
+    m_sealed_count = 0;
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+MemoryGuard::~MemoryGuard()
+{
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+bool MemoryGuard::isSealed() const{
+    return m_sealed;
+}
+
+uint32_t MemoryGuard::getLateAllocations() const{
+    return m_late_allocations;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Hooks the memory trace of mbed, to be called first in main(). Needs platform.memory-tracing-enabled
+ *
+ */
+void MemoryGuard::start()
+{
+    mbed_mem_trace_set_callback(traceCallback);
+}
+
+/**
+ * @brief End of the initialisation, every later allocation is an error
+ *
+ */
+void MemoryGuard::seal()
+{
+    mbed_stats_heap_t heap;
+    mbed_stats_heap_get(&heap);
+    m_sealed_size = heap.current_size;
+    m_sealed_count = heap.alloc_cnt;
+    m_late_allocations = 0;
+    m_first_caller = NULL;
+    m_sealed = true;
+}
+
+/**
+ * @brief Heap in use and its high-water mark, then what was allocated since seal(). Needs platform.heap-stats-enabled
+ *
+ */
+void MemoryGuard::display() const
+{
+    mbed_stats_heap_t heap;
+    mbed_stats_heap_get(&heap);
+
+    printf("Heap: %lu bytes in %lu blocks, max %lu bytes, %lu failed\n",
+        (unsigned long)heap.current_size,
+        (unsigned long)heap.alloc_cnt,
+        (unsigned long)heap.max_size,
+        (unsigned long)heap.alloc_fail_cnt);
+
+    if(!m_sealed)
+    {
+        printf("Heap: initialisation not over\n");
+    }
+    else if(m_late_allocations == 0)
+    {
+        printf("Heap: no allocation since the initialisation, %lu bytes in %lu blocks then\n",
+            (unsigned long)m_sealed_size,
+            (unsigned long)m_sealed_count);
+    }
+    else
+    {
+        printf("Heap: %lu allocations since the initialisation, the first from %p\n",
+            (unsigned long)m_late_allocations,
+            m_first_caller);
+    }
+}
+
+/**
+ * @brief Guard of the firmware
+ *
+ * @return MemoryGuard&
+ */
+MemoryGuard &MemoryGuard::instance()
+{
+    static MemoryGuard guard;
+    return guard;
+}
+
+/**
+ * @brief Called by mbed after each heap operation, nested allocations are not traced
+ *
+ * @param operation MBED_MEM_TRACE_MALLOC, _REALLOC, _CALLOC or _FREE
+ * @param result
+ * @param caller return address of the allocation
+ * @param ... arguments of the operation
+ */
+void MemoryGuard::traceCallback(uint8_t operation, void *result, void *caller, ...)
+{
+    MemoryGuard &guard = instance();
+    if(!guard.m_sealed || operation == MBED_MEM_TRACE_FREE)
+    {
+        return;
+    }
+
+    if(guard.m_late_allocations == 0)
+    {
+        guard.m_first_caller = caller;
+    }
+    guard.m_late_allocations = guard.m_late_allocations + 1;
+
+#if MBED_CONF_APP_HEAP_TRAP
+    error("Heap allocation after the initialisation, from %p\n", caller);
+#endif
+}
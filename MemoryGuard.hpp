@@ -0,0 +1,55 @@
+/**
+ * @file MemoryGuard.hpp
+ * @author Corentin BENOIT
+ * @brief Heap policy of the firmware: allocations are allowed during the initialisation only, then counted or trapped
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_MEMORYGUARD
+#define DEF_MEMORYGUARD
+
+#include "mbed.h"
+#include <cstdint>
+
+
+/**
+ * @brief One instance, on the memory trace callback of mbed. After seal() every malloc, calloc or realloc is an error:
+ * counted with its caller, or stopped with error() when the heap-trap option is set
+ */
+class MemoryGuard
+{
+public:
+    // Destructor
+    ~MemoryGuard();
+
+
+    // Assessors
+    bool isSealed() const;
+    uint32_t getLateAllocations() const;
+
+    //Methods
+    void start();
+    void seal();
+    void display() const;
+
+    static MemoryGuard &instance();
+
+
+
+protected:
+    // Constructor, through instance()
+    MemoryGuard();
+
+    static void traceCallback(uint8_t operation, void *result, void *caller, ...);
+
+    volatile bool m_sealed;
+    volatile uint32_t m_late_allocations;   //Since seal()
+    void *volatile m_first_caller;          //Of the first late allocation
+    uint32_t m_sealed_size;                 //Heap in use at seal() [bytes]
+    uint32_t m_sealed_count;                //Allocations before seal()
+};
+#endif
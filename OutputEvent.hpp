@@ -0,0 +1,38 @@
+/**
+ * @file OutputEvent.hpp
+ * @author Corentin BENOIT
+ * @brief Records of the event path, printed ahead of the samples still queued
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_OUTPUTEVENT
+#define DEF_OUTPUTEVENT
+
+#include <cstdint>
+#include "RuntimeConfig.hpp"
+#include "GaitDetector.hpp"
+
+// What an event record holds
+enum OutputEventKind
+{
+    EVENT_GAIT,
+};
+
+/**
+ * @brief One event, pushed as soon as it is detected instead of waiting for the next output tick
+ */
+struct OutputEvent
+{
+    OutputEventKind kind;
+    OutputFormat format;        //When it was detected, the output thread never reads the live settings
+    union
+    {
+        GaitEvent gait;
+    };
+};
+
+#endif
@@ -11,9 +11,8 @@
 #include "PotentiometerSensor.hpp"
 #include <cmath>
 #include <cstdint>
-#include <ostream>
 #include <stdint.h>
-#include <string>
+#include "Log.hpp"
 
 
 
@@ -127,7 +126,29 @@ uint16_t PotentiometerSensor::getRawData_u16() const
 float PotentiometerSensor::getRawDataOffsetPercentage_u16() const
 {
     AnalogIn pot(m_pin);
-    return map(pot.read_u16(), 0.0f, m_offset_standing, 100.0f, 0.0f);
+    return offsetPercentage(pot.read_u16());
+}
+
+/**
+ * @brief Converts a raw value already read, from [0; UINT16_MAX] to a percentage of [100; 0]% after offset
+ * 
+ * @param raw 
+ * @return float 
+ */
+float PotentiometerSensor::offsetPercentage(uint16_t raw) const
+{
+    return map(raw, 0.0f, m_offset_standing, 100.0f, 0.0f);
+}
+
+/**
+ * @brief Converts a raw value already read to an angle from the standing position, positive when the raw value decreases
+ * 
+ * @param raw 
+ * @return float [deg]
+ */
+float PotentiometerSensor::offsetAngle(uint16_t raw) const
+{
+    return (m_offset_standing - raw)*ACTIVE_ANGLE/(float)(UINT16_MAX - VOLTAGE_LIMITATION);
 }
 
 /**
@@ -227,10 +248,7 @@ float PotentiometerSensor::calculateAngle() const
  */
 void PotentiometerSensor::displayDistance(float result_position) const
 {
-    if(m_id == 0)
-        cout << "Right hip >  Distance : (" + to_string(result_position) + ") > Angle : (" + to_string((result_position*ACTIVE_ANGLE)/ACTIVE_LENGTH) +")" <<endl; // We have the distance 
-    else
-        cout << "Left hip >  Distance : (" + to_string(result_position) + ") > Angle : (" + to_string((result_position*ACTIVE_ANGLE)/ACTIVE_LENGTH) +")" <<endl; // We have the distance 
+    LOG_INFO("%s hip >  Distance : (%f) > Angle : (%f)\n", (m_id == 0) ? "Right" : "Left", result_position, (result_position*ACTIVE_ANGLE)/ACTIVE_LENGTH); // We have the distance
     wait_us(5E+4);
 }
 
@@ -241,10 +259,7 @@ void PotentiometerSensor::displayDistance(float result_position) const
  */
 void PotentiometerSensor::displayAngle(float result_position) const
 {
-    if(m_id == 0)
-        cout << "Right hip > Angle : (" + to_string(result_position) +")" <<endl; // We have the distance 
-    else
-        cout << "Left hip > Angle : (" + to_string(result_position) +")" <<endl; // We have the distance 
+    LOG_INFO("%s hip > Angle : (%f)\n", (m_id == 0) ? "Right" : "Left", result_position); // We have the distance
     wait_us(5E+4);
 }
 
@@ -317,7 +332,7 @@ float PotentiometerSensor::calculateTorque(float angle, char& sens) const
             }
             else
             {
-                cerr << "ERROR : The direction of the forces is not specified" << endl;
+                LOG_ERROR("ERROR : The direction of the forces is not specified\n");
             }
 
             break;
@@ -369,7 +384,7 @@ float PotentiometerSensor::calculateTorque(float angle, char& sens) const
             }
             else
             {
-                cerr << "ERROR : The direction of the forces is not specified" << endl;
+                LOG_ERROR("ERROR : The direction of the forces is not specified\n");
             }
             break;
         case 'r':
@@ -419,7 +434,7 @@ float PotentiometerSensor::calculateTorque(float angle, char& sens) const
             }
             else
             {
-                cerr << "ERROR : The direction of the forces is not specified" << endl;
+                LOG_ERROR("ERROR : The direction of the forces is not specified\n");
             }
             break;
         case 'y': 
@@ -470,11 +485,11 @@ float PotentiometerSensor::calculateTorque(float angle, char& sens) const
             }
             else
             {
-                cerr << "ERROR : The direction of the forces is not specified" << endl;
+                LOG_ERROR("ERROR : The direction of the forces is not specified\n");
             }
             break;
         default:
-            cerr << "ERROR : You didn't chose a type of gaz" << endl;
+            LOG_ERROR("ERROR : You didn't chose a type of gaz\n");
             break;
     }
     return torque;
@@ -518,7 +533,7 @@ void PotentiometerSensor::forceDirection(char& force_direction, uint16_t last_an
  */
 void PotentiometerSensor::displayTorque(float torque) const
 {
-    cout << "Global torque > [" + to_string(torque) + "] Nm "; // We have the distance 
+    LOG_INFO("Global torque > [%f] Nm ", torque); // We have the distance
     wait_us(5E+4);
 }
 
@@ -530,15 +545,19 @@ void PotentiometerSensor::chooseColor()
 {
    char color = ' ';
    bool condition = true;
-   string displayColor;
+   const char *displayColor = "";
 
    do {
-        cout << "What colour bars your exoskeleton has ? (b/g/r/y) : " << endl;             //Display
-        cin >> color ;                                                                      //User choose the color
+        LOG_INFO("What colour bars your exoskeleton has ? (b/g/r/y) : \n");                 //Display
+        int c;
+        do {
+            c = getchar();                                                                  //User choose the color
+        } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+        color = (char)c;
         condition = !((color == 'r') || (color == 'g') || (color == 'b') || (color == 'y'));//Security
 
         if (condition) {                                                                    //If the condition is not respected, here we go again
-            cerr << "You have not entered one of the requested colours"<<endl;
+            LOG_WARNING("You have not entered one of the requested colours\n");
         }
 
    }while (condition);
@@ -562,7 +581,7 @@ void PotentiometerSensor::chooseColor()
             break;
    }
 
-    cout << "You choose the "+ displayColor + " color"<<endl;
+    LOG_INFO("You choose the %s color\n", displayColor);
     m_color = color;
 }
 
@@ -12,7 +12,6 @@
 #ifndef DEF_POTENTIOMETERSENSOR
 #define DEF_POTENTIOMETERSENSOR
 
-#include <iostream>
 #include "mbed.h"
 #include <math.h>
 #include <cstdint>
@@ -58,6 +57,8 @@ public:
     float getRawData0to1() const; 
     uint16_t getRawData_u16() const; 
     float getRawDataOffsetPercentage_u16() const; 
+    float offsetPercentage(uint16_t raw) const;
+    float offsetAngle(uint16_t raw) const;
     float getRawDataOffset0to1() const; 
     uint16_t getRawDataOffset_u16() const; 
 
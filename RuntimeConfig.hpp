@@ -0,0 +1,72 @@
+/**
+ * @file RuntimeConfig.hpp
+ * @author Corentin BENOIT
+ * @brief Acquisition settings that can be changed at runtime from the serial link
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_RUNTIMECONFIG
+#define DEF_RUNTIMECONFIG
+
+#include <cstdint>
+#include "SampleRecord.hpp"
+#include "SampleQueue.hpp"
+#include "ExposureLog.hpp"
+
+// Separator between the printed columns, or the binary trace of SensorTrace.hpp
+enum OutputFormat
+{
+    FORMAT_TAB,     //Default, read by the Edge Impulse data forwarder
+    FORMAT_CSV,
+    FORMAT_TRACE,   //Raw data, replayed by the host build
+};
+
+const uint32_t DEFAULT_CHANNELS = CHANNEL_ACC | CHANNEL_GYRO | CHANNEL_TOUCH | CHANNEL_POT_RIGHT | CHANNEL_POT_LEFT;
+const uint32_t ALL_CHANNELS = DEFAULT_CHANNELS | CHANNEL_STEPS | CHANNEL_MAG | CHANNEL_BARO | CHANNEL_HIP | CHANNEL_TORQUE;  //Sample columns, the lift summaries, the gait and the safety events are asked for apart
+const uint32_t FUSED_CHANNELS = CHANNEL_HIP | CHANNEL_TORQUE | CHANNEL_LIFT | CHANNEL_EXPOSURE | CHANNEL_GAIT;    //Need the hip estimator
+const uint32_t IMU_CHANNELS = CHANNEL_ACC | CHANNEL_GYRO | FUSED_CHANNELS;    //Read the IMU on every tick, the motion detection of the idle mode needs them
+
+/**
+ * @brief Every setting of the acquisition, applied as a whole at a sample boundary.
+ * It is copied with each output sample, the one-shot requests of the commands go in CommandRequest
+ */
+struct RuntimeConfig
+{
+    float sampling_freq;        //Output rate [Hz]
+    float imu_freq;             //IMU rate and ODR [Hz]
+    float pot_freq;             //[Hz]
+    float touch_freq;           //[Hz]
+    float sensibility_acc;      //Accelerometer full scale [g]
+    float sensibility_gyro;     //Gyroscope full scale [dps]
+    uint32_t channels;          //Channel bits printed and sampled
+    OutputFormat format;
+    bool streaming;
+    int calibration_samples;    //N
+    float idle_timeout;         //Time without motion before the low-power mode [s], 0 disables it
+    float mag_freq;             //Magnetometer rate and ODR [Hz]
+    float sensibility_mag;      //Magnetometer full scale [gauss]
+    float baro_freq;            //Barometer ODR, one-shot conversions below 1 Hz [Hz]
+    OverflowPolicy overflow;    //Output queue full
+    char color;                 //Gas springs of the Laevo, for the torque: b, g, r or y
+};
+
+/**
+ * @brief One-shot requests of the commands, handed to the acquisition loop with the settings and forgotten once done
+ */
+struct CommandRequest
+{
+    bool calibrate;             //Calibration with RuntimeConfig::calibration_samples
+    bool bus_stats;             //I2C latency report
+    bool bus_profile;           //I2C profiler report
+    bool mem_report;            //Heap report
+    bool safety_report;         //Safety event counts and latencies
+    ExposureRequest exposure;   //Requests of the expo command
+};
+
+const CommandRequest NO_REQUEST = {false, false, false, false, false, {false, false, -1, 0, {0}}};
+
+#endif
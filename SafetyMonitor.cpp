@@ -0,0 +1,238 @@
+/**
+ * @file SafetyMonitor.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "SafetyMonitor.hpp"
+#include "Log.hpp"
+
+
+
+using namespace std;
+
+#define SAFETY_IRQ_FLAG 0x01
+
+SafetyMonitor *SafetyMonitor::s_instance = NULL;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+SafetyMonitor::SafetyMonitor(LSM6DSLSensor &imu) : m_imu(imu), m_clock(NULL), m_enabled(false), m_pending(DROP_NEWEST),
+    m_count(0), m_nb_latency(0), m_nb_late(0), m_latency_sum_us(0), m_latency_min_us(0), m_latency_max_us(0){
+    for(int kind = 0; kind < SAFETY_NB_KINDS; kind++)
+    {
+        m_last_us[kind] = -1;
+        m_nb_kind[kind] = 0;
+    }
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+SafetyMonitor::~SafetyMonitor()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+const bool& SafetyMonitor::isEnabled() const{
+    return m_enabled;
+}
+
+uint32_t SafetyMonitor::getCount() const{
+    return m_count;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Enables the free-fall and the impact detection on INT1, latched.
+ * Both force the accelerometer to 416 Hz and 2 g, the caller must configure the IMU again after it
+ *
+ * @param clock time base of the event timestamps
+ * @param acc_fs accelerometer full scale the IMU is configured at afterwards, the impact threshold scales with it [g]
+ * @return true if the sensor accepted the settings
+ */
+bool SafetyMonitor::enable(const Timer &clock, float acc_fs)
+{
+    m_clock = &clock;
+    s_instance = this;
+
+    //WK_THS counts sixty-fourths of the full scale
+    int threshold = (int)(SAFETY_IMPACT_MG*64.0f/(acc_fs*1000.0f) + 0.5f);
+    threshold = max(1, min((int)LSM6DSL_WAKE_UP_THRESHOLD_HIGH, threshold));
+
+    if(m_imu.enable_free_fall_detection(LSM6DSL_INT1_PIN) != 0
+        || m_imu.set_free_fall_threshold(SAFETY_FALL_THRESHOLD) != 0
+        || m_imu.enable_wake_up_detection(LSM6DSL_INT1_PIN) != 0
+        || m_imu.set_wake_up_threshold((uint8_t)threshold) != 0
+        || LSM6DSL_ACC_GYRO_W_LIR((void *)&m_imu, LSM6DSL_ACC_GYRO_LIR_ENABLED) == MEMS_ERROR)
+    {
+        LOG_ERROR("Safety: configuration failed\n");
+        return false;
+    }
+
+    m_imu.attach_int1_irq(&SafetyMonitor::eventIrq);
+    m_imu.enable_int1_irq();
+
+    //A source latched before now would hold INT1 high, and no edge would come again
+    uint8_t source;
+    m_imu.read_reg(LSM6DSL_ACC_GYRO_WAKE_UP_SRC, &source);
+
+    m_enabled = true;
+    return true;
+}
+
+/**
+ * @brief Stops both detections and the interrupt.
+ * The wake-up engine is shared with IdleManager, it must be disabled before the low-power mode
+ *
+ */
+void SafetyMonitor::disable()
+{
+    m_imu.disable_int1_irq();
+    LSM6DSL_ACC_GYRO_W_LIR((void *)&m_imu, LSM6DSL_ACC_GYRO_LIR_DISABLED);
+    m_imu.disable_wake_up_detection();
+    m_imu.disable_free_fall_detection();
+    m_enabled = false;
+}
+
+/**
+ * @brief Blocks until the next event, for the safety thread.
+ * A latched source stays set until it is read: a free fall lasting longer than a read gives several interrupts,
+ * they make one event until SAFETY_REFRACTORY_US passes without any
+ *
+ * @param event
+ */
+void SafetyMonitor::wait(SafetyEvent &event)
+{
+    while (1) {
+        int64_t irq_us;
+        while (!m_pending.pop(irq_us)) {
+            m_flags.wait_any(SAFETY_IRQ_FLAG);
+        }
+
+        //Releases INT1 for the next event
+        uint8_t source = 0;
+        m_imu.read_reg(LSM6DSL_ACC_GYRO_WAKE_UP_SRC, &source);
+        int64_t source_us = m_clock->elapsed_time().count();
+
+        SafetyEventKind kind = SAFETY_UNKNOWN;
+        if(source & LSM6DSL_ACC_GYRO_FF_EV_STATUS_MASK)
+        {
+            kind = SAFETY_FALL;
+        }
+        else if(source & LSM6DSL_ACC_GYRO_WU_EV_STATUS_MASK)
+        {
+            kind = SAFETY_IMPACT;
+        }
+
+        int64_t last_us = m_last_us[kind];
+        m_last_us[kind] = irq_us;
+        if(last_us >= 0 && irq_us - last_us < SAFETY_REFRACTORY_US)
+        {
+            continue;
+        }
+
+        m_count++;
+        m_nb_kind[kind]++;
+        event.index = m_count;
+        event.kind = kind;
+        event.irq_us = irq_us;
+        event.source_us = source_us;
+        return;
+    }
+}
+
+/**
+ * @brief Time from the interrupt of an event to its line out of the transmit buffer of the serial port, for the output thread
+ *
+ * @param latency_us
+ */
+void SafetyMonitor::recordLatency(int64_t latency_us)
+{
+    if(m_nb_latency == 0 || latency_us < m_latency_min_us)
+    {
+        m_latency_min_us = latency_us;
+    }
+    if(m_nb_latency == 0 || latency_us > m_latency_max_us)
+    {
+        m_latency_max_us = latency_us;
+    }
+    m_latency_sum_us += latency_us;
+    m_nb_latency++;
+    if(latency_us > SAFETY_LATENCY_TARGET_US)
+    {
+        m_nb_late++;
+    }
+}
+
+/**
+ * @brief Information for the user
+ *
+ */
+void SafetyMonitor::display() const
+{
+    //The safety thread updates them, a copy with the interrupts off is consistent
+    core_util_critical_section_enter();
+    uint32_t nb_kind[SAFETY_NB_KINDS];
+    for(int kind = 0; kind < SAFETY_NB_KINDS; kind++)
+    {
+        nb_kind[kind] = m_nb_kind[kind];
+    }
+    uint32_t nb_latency = m_nb_latency;
+    uint32_t nb_late = m_nb_late;
+    int64_t sum_us = m_latency_sum_us;
+    int64_t min_us = m_latency_min_us;
+    int64_t max_us = m_latency_max_us;
+    uint32_t nb_dropped = m_pending.getDroppedNewest();
+    core_util_critical_section_exit();
+
+    printf("Safety events : %lu fall, %lu impact, %lu unknown, %lu interrupts dropped\n",
+        (unsigned long)nb_kind[SAFETY_FALL],
+        (unsigned long)nb_kind[SAFETY_IMPACT],
+        (unsigned long)nb_kind[SAFETY_UNKNOWN],
+        (unsigned long)nb_dropped);
+    if(nb_latency > 0)
+    {
+        printf("Interrupt to line sent : min %ld us, mean %ld us, max %ld us, %lu over %ld us\n",
+            (long)min_us, (long)(sum_us/nb_latency), (long)max_us,
+            (unsigned long)nb_late, (long)SAFETY_LATENCY_TARGET_US);
+    }
+}
+
+/**
+ * @brief INT1 rising edge, one per latched source
+ *
+ */
+void SafetyMonitor::eventIrq()
+{
+    SafetyMonitor *self = s_instance;
+    if(self == NULL || self->m_clock == NULL)
+    {
+        return;
+    }
+    self->m_pending.push(self->m_clock->elapsed_time().count());
+    self->m_flags.set(SAFETY_IRQ_FLAG);
+}
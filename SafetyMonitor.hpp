@@ -0,0 +1,97 @@
+/**
+ * @file SafetyMonitor.hpp
+ * @author Corentin BENOIT
+ * @brief Free-fall and impact events detected by the LSM6DSL, on its INT1 interrupt
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_SAFETYMONITOR
+#define DEF_SAFETYMONITOR
+
+#include "mbed.h"
+#include <cstdint>
+#include "../LSM6DSL/LSM6DSLSensor.h"
+#include "SampleQueue.hpp"
+
+const uint8_t SAFETY_FALL_THRESHOLD = LSM6DSL_ACC_GYRO_FF_THS_312mg;    //FF_THS, every axis under it for 6 samples is a free fall
+const float SAFETY_IMPACT_MG = 1500.0f;         //Acceleration step between two samples that counts as an impact [mg]
+const int64_t SAFETY_REFRACTORY_US = 500000;    //Events of the same kind closer than this are one event
+const int64_t SAFETY_LINE_WIRE_US = 2600;       //A line of about 30 bytes on the wire at 115200 bauds
+const int64_t SAFETY_LATENCY_TARGET_US = 2000 + SAFETY_LINE_WIRE_US;   //From the interrupt to the line out of the serial port, 2 ms to its first byte
+const uint32_t SAFETY_PENDING_SIZE = 8;         //Interrupts waiting for their source to be read
+
+// What the source register says
+enum SafetyEventKind
+{
+    SAFETY_FALL,
+    SAFETY_IMPACT,
+    SAFETY_UNKNOWN,         //Neither source was set when it was read
+    SAFETY_NB_KINDS
+};
+
+/**
+ * @brief One event, what the output thread prints
+ */
+struct SafetyEvent
+{
+    uint32_t index;             //Events reported since the start
+    SafetyEventKind kind;
+    int64_t irq_us;             //INT1 rising edge
+    int64_t source_us;          //Source register read
+};
+
+
+/**
+ * @brief The free-fall and the wake-up engines of the LSM6DSL both drive INT1, latched. The interrupt only stamps
+ * the time and wakes the safety thread up; the thread reads WAKE_UP_SRC, which tells them apart and releases INT1.
+ * The wake-up threshold is set high so that only an impact trips it. INT1 is the only line wired on the board:
+ * while the events are on, the step detector has to stay off it
+ */
+class SafetyMonitor
+{
+public:
+    // Constructor
+    SafetyMonitor(LSM6DSLSensor &imu);
+
+    // Destructor
+    ~SafetyMonitor();
+
+
+    // Assessors
+    const bool &isEnabled() const;
+    uint32_t getCount() const;
+
+    //Methods
+    bool enable(const Timer &clock, float acc_fs);
+    void disable();
+    void wait(SafetyEvent &event);
+    void recordLatency(int64_t latency_us);
+    void display() const;
+
+
+
+protected:
+    static void eventIrq();
+    static SafetyMonitor *s_instance;   //The driver only takes plain function pointers
+
+    LSM6DSLSensor &m_imu;
+    const Timer *m_clock;
+    bool m_enabled;
+    EventFlags m_flags;
+    SampleQueue<int64_t, SAFETY_PENDING_SIZE> m_pending;    //Written by the interrupt, read by the safety thread
+
+    // Safety thread
+    int64_t m_last_us[SAFETY_NB_KINDS];     //Last event reported of each kind, -1 for none
+    uint32_t m_count;
+    uint32_t m_nb_kind[SAFETY_NB_KINDS];
+    uint32_t m_nb_latency;
+    uint32_t m_nb_late;                     //Over SAFETY_LATENCY_TARGET_US
+    int64_t m_latency_sum_us;
+    int64_t m_latency_min_us;
+    int64_t m_latency_max_us;
+};
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file SampleQueue.hpp
+ * @author Corentin BENOIT
+ * @brief Lock-free single-producer/single-consumer ring of POD records
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_SAMPLEQUEUE
+#define DEF_SAMPLEQUEUE
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+const int QUEUE_CACHE_LINE = 64;    //Indexes written by different threads never share a line
+
+// What push() does when the queue is full
+enum OverflowPolicy
+{
+    DROP_OLDEST,    //The oldest record is discarded, the output stays as recent as possible
+    DROP_NEWEST,    //The new record is discarded, the output has no gap in the middle
+};
+
+/**
+ * @brief Fixed capacity ring between one producer thread and one consumer thread, without lock nor allocation.
+ * The consumer claims a slot by moving the tail with a CAS before copying it. In DROP_OLDEST mode the producer
+ * moves the tail itself, and never overwrites the slot the consumer is still copying.
+ *
+ * @tparam T trivially copyable record
+ * @tparam Capacity power of two
+ */
+template <typename T, uint32_t Capacity>
+class SampleQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "T must be a POD record");
+
+public:
+    // Constructor
+    SampleQueue(OverflowPolicy policy = DROP_OLDEST) : m_policy(policy), m_head(0), m_tail(0), m_reading(NO_SLOT),
+        m_dropped_oldest(0), m_dropped_newest(0){
+    }
+
+
+    // Assessors
+    void setPolicy(OverflowPolicy policy){
+        m_policy.store(policy, std::memory_order_relaxed);
+    }
+
+    OverflowPolicy getPolicy() const{
+        return m_policy.load(std::memory_order_relaxed);
+    }
+
+    uint32_t getDroppedOldest() const{
+        return m_dropped_oldest.load(std::memory_order_relaxed);
+    }
+
+    uint32_t getDroppedNewest() const{
+        return m_dropped_newest.load(std::memory_order_relaxed);
+    }
+
+    uint32_t size() const{
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    static uint32_t capacity(){
+        return Capacity;
+    }
+
+
+    //Methods
+
+    /**
+     * @brief Producer side
+     *
+     * @param item
+     * @return true if the item was queued
+     */
+    bool push(const T &item)
+    {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t tail = m_tail.load(std::memory_order_seq_cst);
+
+        if(head - tail >= Capacity)
+        {
+            if(m_policy.load(std::memory_order_relaxed) == DROP_NEWEST)
+            {
+                m_dropped_newest.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            // If the CAS fails the consumer has just popped, there is room anyway
+            if(m_tail.compare_exchange_strong(tail, tail + 1, std::memory_order_seq_cst))
+            {
+                m_dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // The consumer claimed this slot one lap ago and is still copying it
+        if(m_reading.load(std::memory_order_seq_cst) == (head & MASK))
+        {
+            m_dropped_newest.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_slots[head & MASK] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side
+     *
+     * @param item
+     * @return true if an item was read
+     */
+    bool pop(T &item)
+    {
+        while (1) {
+            uint32_t tail = m_tail.load(std::memory_order_seq_cst);
+            if(tail == m_head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            m_reading.store(tail & MASK, std::memory_order_seq_cst);
+            if(m_tail.compare_exchange_strong(tail, tail + 1, std::memory_order_seq_cst))
+            {
+                item = m_slots[tail & MASK];
+                m_reading.store(NO_SLOT, std::memory_order_release);
+                return true;
+            }
+
+            // The producer dropped this record, try the next one
+            m_reading.store(NO_SLOT, std::memory_order_release);
+        }
+    }
+
+
+
+protected:
+    static const uint32_t MASK = Capacity - 1;
+    static const uint32_t NO_SLOT = 0xFFFFFFFF;
+
+    std::atomic<OverflowPolicy> m_policy;
+
+    alignas(QUEUE_CACHE_LINE) std::atomic<uint32_t> m_head;         //Written by the producer
+    alignas(QUEUE_CACHE_LINE) std::atomic<uint32_t> m_tail;         //Written by both in DROP_OLDEST mode
+    alignas(QUEUE_CACHE_LINE) std::atomic<uint32_t> m_reading;      //Slot the consumer is copying
+    alignas(QUEUE_CACHE_LINE) std::atomic<uint32_t> m_dropped_oldest;
+    std::atomic<uint32_t> m_dropped_newest;
+
+    alignas(QUEUE_CACHE_LINE) T m_slots[Capacity];
+};
+
+#endif
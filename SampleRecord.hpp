@@ -0,0 +1,82 @@
+/**
+ * @file SampleRecord.hpp
+ * @author Corentin BENOIT
+ * @brief Merged output record holding the latest value of each channel
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_SAMPLERECORD
+#define DEF_SAMPLERECORD
+
+#include <cstdint>
+#include "LiftDetector.hpp"
+
+// Channel bits, used to flag which channels were refreshed since the last output
+enum Channel
+{
+    CHANNEL_ACC       = 1 << 0,
+    CHANNEL_GYRO      = 1 << 1,
+    CHANNEL_TOUCH     = 1 << 2,
+    CHANNEL_POT_RIGHT = 1 << 3,
+    CHANNEL_POT_LEFT  = 1 << 4,
+    CHANNEL_STEPS     = 1 << 5,
+    CHANNEL_MAG       = 1 << 6,
+    CHANNEL_BARO      = 1 << 7,
+    CHANNEL_HIP       = 1 << 8,
+    CHANNEL_TORQUE    = 1 << 9,
+    CHANNEL_LIFT      = 1 << 10,
+    CHANNEL_EXPOSURE  = 1 << 11,
+    CHANNEL_GAIT      = 1 << 12,
+    CHANNEL_FALL      = 1 << 13,
+};
+
+/**
+ * @brief Latest value of every channel, stamped with the time of the output tick.
+ * Every sensor task only overwrites its own fields, at its own rate.
+ */
+struct SampleRecord
+{
+    int64_t timestamp_us;       //Time of the output tick
+    uint32_t updated;           //Channel bits refreshed since the last output
+
+    int32_t acc[3];             //[mg]
+    int32_t gyro[3];            //[mdps]
+    int16_t acc_raw[3];         //Output registers, kept for the binary trace
+    int16_t gyro_raw[3];
+    int64_t imu_timestamp_us;
+
+    int touch;                  //0 or 100
+    uint16_t touch_raw;         //ADC
+    int64_t touch_timestamp_us;
+
+    uint16_t pot_right_raw;     //ADC, scaled to a percentage after offset by the output
+    uint16_t pot_left_raw;
+    int64_t pot_timestamp_us;
+
+    uint32_t step_count;        //Steps since the pedometer was enabled
+    int64_t step_timestamp_us;  //Time of the last step
+
+    int32_t mag[3];             //[mgauss]
+    int64_t mag_timestamp_us;
+
+    float pressure;             //[hPa]
+    float altitude;             //Filtered, relative to the pressure when the channel was enabled [m]
+    int64_t baro_timestamp_us;
+
+    float hip_angle[2];         //Right, left, fused from the potentiometer and the gyroscope [deg]
+    float hip_velocity[2];      //[deg/s]
+    float hip_acceleration[2];  //[deg/s2]
+    int64_t hip_timestamp_us;   //Time of the IMU sample of the last update
+
+    float torque[2];            //Support torque of the right and left rods [Nm]
+    float torque_global;        //Mean of both
+
+    float trunk_pitch;          //0 with the IMU horizontal [deg]
+    LiftEvent lift;             //Last bend or lift cycle, flagged in updated when it ends
+};
+
+#endif
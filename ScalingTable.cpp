@@ -0,0 +1,112 @@
+/**
+ * @file ScalingTable.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "ScalingTable.hpp"
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+ScalingTable::ScalingTable(){
+    for(int i = 0; i < SCALE_NB_CHANNELS; i++)
+    {
+        m_scale[i] = 1.0f;
+        m_bias[i] = 0.0f;
+    }
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+float ScalingTable::getScale(int channel) const{
+    return m_scale[channel];
+}
+
+float ScalingTable::getBias(int channel) const{
+    return m_bias[channel];
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Output register to [-ratio; ratio] over [-range; range] mg
+ *
+ * @param sensitivity [mg/LSB]
+ * @param range half of the input range
+ * @param ratio half of the output range
+ */
+void ScalingTable::setAccelerometer(float sensitivity, float range, float ratio)
+{
+    for(int i = SCALE_ACC_X; i <= SCALE_ACC_Z; i++)
+    {
+        m_scale[i] = sensitivity*ratio/range;
+        m_bias[i] = 0.0f;
+    }
+}
+
+/**
+ * @brief Output register to [-ratio; ratio] over [-range; range] mdps, after the offset of the calibration
+ *
+ * @param sensitivity [mdps/LSB]
+ * @param range half of the input range
+ * @param ratio half of the output range
+ * @param offset [mdps]
+ */
+void ScalingTable::setGyroscope(float sensitivity, float range, float ratio, const float offset[3])
+{
+    for(int i = 0; i < 3; i++)
+    {
+        m_scale[SCALE_GYRO_X + i] = sensitivity*ratio/range;
+        m_bias[SCALE_GYRO_X + i] = -offset[i]*ratio/range;
+    }
+}
+
+/**
+ * @brief ADC value to a percentage of [100; 0]% between 0 and the standing offset, as getRawDataOffsetPercentage_u16()
+ *
+ * @param offset_right standing raw value
+ * @param offset_left
+ */
+void ScalingTable::setPotentiometers(float offset_right, float offset_left)
+{
+    m_scale[SCALE_POT_RIGHT] = (offset_right != 0.0f) ? -100.0f/offset_right : 0.0f;
+    m_bias[SCALE_POT_RIGHT] = 100.0f;
+    m_scale[SCALE_POT_LEFT] = (offset_left != 0.0f) ? -100.0f/offset_left : 0.0f;
+    m_bias[SCALE_POT_LEFT] = 100.0f;
+}
+
+/**
+ * @brief Scales every channel of one sample
+ *
+ * @param raw output registers and ADC values, in the order of ScaledChannel
+ * @param out
+ */
+void ScalingTable::apply(const int32_t raw[SCALE_NB_CHANNELS], float out[SCALE_NB_CHANNELS]) const
+{
+    for(int i = 0; i < SCALE_NB_CHANNELS; i++)
+    {
+        out[i] = (float)raw[i]*m_scale[i] + m_bias[i];
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file ScalingTable.hpp
+ * @author Corentin BENOIT
+ * @brief Raw sensor values to output units with one multiply-add per channel, the scales are computed at configuration time
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_SCALINGTABLE
+#define DEF_SCALINGTABLE
+
+#include <cstdint>
+
+// Channels of the table, in the order of apply()
+enum ScaledChannel
+{
+    SCALE_ACC_X,
+    SCALE_ACC_Y,
+    SCALE_ACC_Z,
+    SCALE_GYRO_X,
+    SCALE_GYRO_Y,
+    SCALE_GYRO_Z,
+    SCALE_POT_RIGHT,
+    SCALE_POT_LEFT,
+    SCALE_NB_CHANNELS
+};
+
+
+/**
+ * @brief out = raw*scale + bias. Folds the sensitivity, the range of the former map() calls, the gyroscope
+ * offsets and the potentiometer offsets, so the output never divides. Single precision, the FPU of the Cortex-M4 does it in hardware
+ */
+class ScalingTable
+{
+public:
+    // Constructor
+    ScalingTable();
+
+    // Destructor, trivial so the table can be copied into the output queue
+    ~ScalingTable() = default;
+
+
+    // Assessors
+    float getScale(int channel) const;
+    float getBias(int channel) const;
+
+    //Methods
+    void setAccelerometer(float sensitivity, float range, float ratio);
+    void setGyroscope(float sensitivity, float range, float ratio, const float offset[3]);
+    void setPotentiometers(float offset_right, float offset_left);
+    void apply(const int32_t raw[SCALE_NB_CHANNELS], float out[SCALE_NB_CHANNELS]) const;
+
+
+
+protected:
+    float m_scale[SCALE_NB_CHANNELS];
+    float m_bias[SCALE_NB_CHANNELS];
+};
+#endif
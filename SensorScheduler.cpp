@@ -0,0 +1,196 @@
+/**
+ * @file SensorScheduler.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "SensorScheduler.hpp"
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+SensorScheduler::SensorScheduler() : m_nb_tasks(0){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+SensorScheduler::~SensorScheduler()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Changes the rate of a task, the grid of deadlines restarts from its next deadline
+ *
+ * @param id
+ * @param rate [Hz]
+ */
+void SensorScheduler::setRate(int id, float rate){
+    if(id < 0 || id >= m_nb_tasks || rate <= 0)
+    {
+        return;
+    }
+    Task &task = m_tasks[id];
+    task.m_rate_mhz = (uint32_t)(rate*1000.0f);
+    task.m_origin_us = task.m_next_us - task.m_phase_us;
+    task.m_count = 0;
+}
+
+float SensorScheduler::getRate(int id) const{
+    if(id < 0 || id >= m_nb_tasks)
+    {
+        return 0;
+    }
+    return m_tasks[id].m_rate_mhz/1000.0f;
+}
+
+uint32_t SensorScheduler::getOverruns(int id) const{
+    if(id < 0 || id >= m_nb_tasks)
+    {
+        return 0;
+    }
+    return m_tasks[id].m_overruns;
+}
+
+const int& SensorScheduler::getNbTasks() const{
+    return m_nb_tasks;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Registers a periodic task, tasks due at the same time run in the order they were added
+ *
+ * @param task function called with the deadline it was scheduled for
+ * @param rate [Hz]
+ * @param phase_us offset of the first deadline after start()
+ * @return int id of the task, -1 if the task can't be added
+ */
+int SensorScheduler::addTask(void (*task)(int64_t timestamp_us), float rate, int64_t phase_us)
+{
+    if(m_nb_tasks >= MAX_SENSOR_TASKS || task == NULL || rate <= 0)
+    {
+        return -1;
+    }
+
+    Task &new_task = m_tasks[m_nb_tasks];
+    new_task.m_function = task;
+    new_task.m_rate_mhz = (uint32_t)(rate*1000.0f);
+    new_task.m_phase_us = phase_us;
+    new_task.m_origin_us = 0;
+    new_task.m_count = 0;
+    new_task.m_next_us = phase_us;
+    new_task.m_overruns = 0;
+
+    return m_nb_tasks++;
+}
+
+/**
+ * @brief Starts every task from the same time reference
+ *
+ * @param now_us
+ */
+void SensorScheduler::start(int64_t now_us)
+{
+    for(int i = 0; i < m_nb_tasks; i++)
+    {
+        m_tasks[i].m_origin_us = now_us;
+        m_tasks[i].m_count = 0;
+        m_tasks[i].m_overruns = 0;
+        m_tasks[i].m_next_us = deadline(m_tasks[i]);
+    }
+}
+
+/**
+ * @brief Earliest deadline among all tasks
+ *
+ * @return int64_t
+ */
+int64_t SensorScheduler::nextDeadline() const
+{
+    int64_t next = INT64_MAX;
+    for(int i = 0; i < m_nb_tasks; i++)
+    {
+        if(m_tasks[i].m_next_us < next)
+        {
+            next = m_tasks[i].m_next_us;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief Runs every task whose deadline is reached.
+ * A task late by more than one period skips the missed deadlines instead of running in burst,
+ * so the sensors stay on their time grid
+ *
+ * @param now_us
+ * @return int number of tasks run
+ */
+int SensorScheduler::runDue(int64_t now_us)
+{
+    int nb_run = 0;
+
+    for(int i = 0; i < m_nb_tasks; i++)
+    {
+        Task &task = m_tasks[i];
+        if(now_us < task.m_next_us)
+        {
+            continue;
+        }
+
+        task.m_function(task.m_next_us);
+        nb_run++;
+
+        task.m_count++;
+        task.m_next_us = deadline(task);
+
+        if(task.m_next_us <= now_us)
+        {
+            //Jump to the first deadline after now
+            uint32_t count = (uint32_t)(((now_us - task.m_origin_us - task.m_phase_us)*task.m_rate_mhz)/1000000000LL) + 1;
+            task.m_overruns += count - task.m_count;
+            task.m_count = count;
+            task.m_next_us = deadline(task);
+        }
+    }
+
+    return nb_run;
+}
+
+/**
+ * @brief Deadline number m_count of a task, computed from the origin so the rounding never accumulates
+ *
+ * @param task
+ * @return int64_t
+ */
+int64_t SensorScheduler::deadline(const Task &task) const
+{
+    return task.m_origin_us + task.m_phase_us + ((int64_t)task.m_count*1000000000LL)/task.m_rate_mhz;
+}
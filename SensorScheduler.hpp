@@ -0,0 +1,62 @@
+/**
+ * @file SensorScheduler.hpp
+ * @author Corentin BENOIT
+ * @brief Deterministic multi-rate scheduler, each sensor runs at its own rate
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_SENSORSCHEDULER
+#define DEF_SENSORSCHEDULER
+
+#include "mbed.h"
+#include <cstdint>
+
+const int MAX_SENSOR_TASKS = 8; //Number of tasks the scheduler can hold
+
+
+class SensorScheduler
+{
+public:
+    // Constructor
+    SensorScheduler();
+
+    // Destructor
+    ~SensorScheduler();
+
+
+    // Assessors
+    void setRate(int id, float rate);
+    float getRate(int id) const;
+    uint32_t getOverruns(int id) const;
+    const int &getNbTasks() const;
+
+    //Methods
+    int addTask(void (*task)(int64_t timestamp_us), float rate, int64_t phase_us = 0);
+    void start(int64_t now_us);
+    int64_t nextDeadline() const;
+    int runDue(int64_t now_us);
+
+
+
+protected:
+    struct Task
+    {
+        void (*m_function)(int64_t timestamp_us);
+        uint32_t m_rate_mhz;    //Rate in mHz, keeps the deadlines exact for rates like 416 Hz
+        int64_t m_phase_us;     //Offset of the first deadline, spreads the bus and ADC load
+        int64_t m_origin_us;    //Time of deadline number 0
+        uint32_t m_count;       //Number of the next deadline
+        int64_t m_next_us;      //Next deadline
+        uint32_t m_overruns;    //Deadlines skipped because the task was late
+    };
+
+    int64_t deadline(const Task &task) const;
+
+    Task m_tasks[MAX_SENSOR_TASKS];
+    int m_nb_tasks;
+};
+#endif
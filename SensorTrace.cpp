@@ -0,0 +1,294 @@
+/**
+ * @file SensorTrace.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "SensorTrace.hpp"
+#include <cstring>
+
+
+
+using namespace std;
+
+namespace
+{
+    // Little endian fields, whatever the host
+    uint8_t *put16(uint8_t *p, uint16_t value)
+    {
+        p[0] = value & 0xFF;
+        p[1] = value >> 8;
+        return p + 2;
+    }
+
+    uint8_t *put32(uint8_t *p, uint32_t value)
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            p[i] = (value >> (8*i)) & 0xFF;
+        }
+        return p + 4;
+    }
+
+    uint8_t *putFloat(uint8_t *p, float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return put32(p, bits);
+    }
+
+    const uint8_t *get16(const uint8_t *p, uint16_t &value)
+    {
+        value = p[0] | (p[1] << 8);
+        return p + 2;
+    }
+
+    const uint8_t *get32(const uint8_t *p, uint32_t &value)
+    {
+        value = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+        return p + 4;
+    }
+
+    const uint8_t *getFloat(const uint8_t *p, float &value)
+    {
+        uint32_t bits;
+        p = get32(p, bits);
+        memcpy(&value, &bits, sizeof(value));
+        return p;
+    }
+
+    // Sync, type and payload are written, appends the checksum
+    int seal(uint8_t *buffer, int payload)
+    {
+        uint8_t sum = 0;
+        for(int i = 1; i < 2 + payload; i++)
+        {
+            sum += buffer[i];
+        }
+        buffer[2 + payload] = sum;
+        return 3 + payload;
+    }
+}
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+SensorTrace::SensorTrace() : m_length(0), m_expected(0), m_nb_errors(0), m_header(), m_sample(){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+SensorTrace::~SensorTrace()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+const TraceHeader &SensorTrace::getHeader() const{
+    return m_header;
+}
+
+const TraceSample &SensorTrace::getSample() const{
+    return m_sample;
+}
+
+uint32_t SensorTrace::getNbErrors() const{
+    return m_nb_errors;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Decodes one byte of the stream. The bytes outside of a valid frame are skipped
+ *
+ * @param byte
+ * @return TRACE_HEADER or TRACE_SAMPLE when a frame is complete, TRACE_NONE otherwise
+ */
+TraceFrameType SensorTrace::push(uint8_t byte)
+{
+    if(m_length == 0)
+    {
+        if(byte == TRACE_SYNC)
+        {
+            m_frame[m_length++] = byte;
+        }
+        return TRACE_NONE;
+    }
+
+    if(m_length == 1)
+    {
+        if(byte == TRACE_HEADER) m_expected = 3 + TRACE_HEADER_PAYLOAD;
+        else if(byte == TRACE_SAMPLE) m_expected = 3 + TRACE_SAMPLE_PAYLOAD;
+        else
+        {
+            m_length = (byte == TRACE_SYNC) ? 1 : 0;
+            return TRACE_NONE;
+        }
+    }
+
+    m_frame[m_length++] = byte;
+    if(m_length < m_expected)
+    {
+        return TRACE_NONE;
+    }
+
+    m_length = 0;
+    uint8_t sum = 0;
+    for(int i = 1; i < m_expected - 1; i++)
+    {
+        sum += m_frame[i];
+    }
+    if(sum != m_frame[m_expected - 1])
+    {
+        m_nb_errors++;
+        return resync();
+    }
+
+    decode(m_frame[1], m_frame + 2);
+    return (TraceFrameType)m_frame[1];
+}
+
+/**
+ * @brief After a checksum error the sync byte may have been a data byte, or a corrupted type byte may have made the
+ * frame swallow the start of the next one: the bytes after the sync are decoded again
+ *
+ * @return TRACE_HEADER or TRACE_SAMPLE if a frame is complete among them, TRACE_NONE otherwise
+ */
+TraceFrameType SensorTrace::resync()
+{
+    uint8_t bytes[TRACE_MAX_FRAME];
+    int length = m_expected - 1;
+    memcpy(bytes, m_frame + 1, length);
+    m_length = 0;
+
+    //At most one frame fits in the bytes of a longer one, the next frame may start there
+    TraceFrameType type = TRACE_NONE;
+    for(int i = 0; i < length; i++)
+    {
+        TraceFrameType frame = push(bytes[i]);
+        if(frame != TRACE_NONE)
+        {
+            type = frame;
+        }
+    }
+    return type;
+}
+
+/**
+ * @brief Header frame
+ *
+ * @param header
+ * @param buffer at least TRACE_MAX_FRAME bytes
+ * @return frame length
+ */
+int SensorTrace::encodeHeader(const TraceHeader &header, uint8_t *buffer)
+{
+    uint8_t *p = buffer;
+    *p++ = TRACE_SYNC;
+    *p++ = TRACE_HEADER;
+    *p++ = header.version;
+    p = put32(p, header.channels);
+    p = putFloat(p, header.sampling_freq);
+    p = putFloat(p, header.acc_sensitivity);
+    p = putFloat(p, header.gyro_sensitivity);
+    for(int i = 0; i < 3; i++)
+    {
+        p = putFloat(p, header.gyr_offset[i]);
+    }
+    p = putFloat(p, header.pot_offset[0]);
+    p = putFloat(p, header.pot_offset[1]);
+    p = putFloat(p, header.imu_freq);
+    return seal(buffer, TRACE_HEADER_PAYLOAD);
+}
+
+/**
+ * @brief Sample frame
+ *
+ * @param sample
+ * @param buffer at least TRACE_MAX_FRAME bytes
+ * @return frame length
+ */
+int SensorTrace::encodeSample(const TraceSample &sample, uint8_t *buffer)
+{
+    uint8_t *p = buffer;
+    *p++ = TRACE_SYNC;
+    *p++ = TRACE_SAMPLE;
+    p = put32(p, sample.timestamp_us);
+    p = put16(p, sample.imu_age_us);
+    p = put16(p, sample.pot_age_us);
+    p = put16(p, sample.touch_age_us);
+    for(int i = 0; i < 3; i++)
+    {
+        p = put16(p, (uint16_t)sample.acc[i]);
+    }
+    for(int i = 0; i < 3; i++)
+    {
+        p = put16(p, (uint16_t)sample.gyro[i]);
+    }
+    p = put16(p, sample.pot_right);
+    p = put16(p, sample.pot_left);
+    p = put16(p, sample.touch);
+    return seal(buffer, TRACE_SAMPLE_PAYLOAD);
+}
+
+void SensorTrace::decode(uint8_t type, const uint8_t *payload)
+{
+    const uint8_t *p = payload;
+    uint16_t value;
+
+    if(type == TRACE_HEADER)
+    {
+        m_header.version = *p++;
+        p = get32(p, m_header.channels);
+        p = getFloat(p, m_header.sampling_freq);
+        p = getFloat(p, m_header.acc_sensitivity);
+        p = getFloat(p, m_header.gyro_sensitivity);
+        for(int i = 0; i < 3; i++)
+        {
+            p = getFloat(p, m_header.gyr_offset[i]);
+        }
+        p = getFloat(p, m_header.pot_offset[0]);
+        p = getFloat(p, m_header.pot_offset[1]);
+        p = getFloat(p, m_header.imu_freq);
+        return;
+    }
+
+    p = get32(p, m_sample.timestamp_us);
+    p = get16(p, m_sample.imu_age_us);
+    p = get16(p, m_sample.pot_age_us);
+    p = get16(p, m_sample.touch_age_us);
+    for(int i = 0; i < 3; i++)
+    {
+        p = get16(p, value);
+        m_sample.acc[i] = (int16_t)value;
+    }
+    for(int i = 0; i < 3; i++)
+    {
+        p = get16(p, value);
+        m_sample.gyro[i] = (int16_t)value;
+    }
+    p = get16(p, m_sample.pot_right);
+    p = get16(p, m_sample.pot_left);
+    p = get16(p, m_sample.touch);
+}
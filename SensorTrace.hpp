@@ -0,0 +1,101 @@
+/**
+ * @file SensorTrace.hpp
+ * @author Corentin BENOIT
+ * @brief Compact binary trace of the raw sensor data, streamed by the device and replayed by the host build
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_SENSORTRACE
+#define DEF_SENSORTRACE
+
+#include <cstdint>
+
+// Frame: sync, type, payload in little endian, checksum (sum of the type and the payload bytes)
+const uint8_t TRACE_SYNC = 0xA5;
+const uint8_t TRACE_VERSION = 1;
+const int TRACE_HEADER_PAYLOAD = 41;
+const int TRACE_SAMPLE_PAYLOAD = 28;
+const int TRACE_MAX_FRAME = 3 + TRACE_HEADER_PAYLOAD;
+const int TRACE_HEADER_PERIOD = 100;    //Samples between two headers, so a reader can start anywhere in the stream
+
+enum TraceFrameType
+{
+    TRACE_NONE = 0,
+    TRACE_HEADER = 'H',
+    TRACE_SAMPLE = 'S',
+};
+
+/**
+ * @brief Settings needed to scale the raw data, sent before the first sample and then periodically
+ */
+struct TraceHeader
+{
+    uint8_t version;
+    uint32_t channels;
+    float sampling_freq;        //[Hz]
+    float acc_sensitivity;      //[mg/LSB]
+    float gyro_sensitivity;     //[mdps/LSB]
+    float gyr_offset[3];        //[mdps]
+    float pot_offset[2];        //Standing raw value of the right and left potentiometers
+    float imu_freq;             //[Hz]
+};
+
+/**
+ * @brief Raw data of one output tick. Each channel is stamped with its age, so a replay feeds it at the time it was read
+ */
+struct TraceSample
+{
+    uint32_t timestamp_us;      //Output tick, wraps after 71 min
+    uint16_t imu_age_us;        //Saturated at 65535
+    uint16_t pot_age_us;
+    uint16_t touch_age_us;
+    int16_t acc[3];             //Output registers
+    int16_t gyro[3];
+    uint16_t pot_right;         //ADC, [0; UINT16_MAX]
+    uint16_t pot_left;
+    uint16_t touch;
+};
+
+
+/**
+ * @brief Encodes the frames, and decodes a byte stream that may hold text lines between them
+ */
+class SensorTrace
+{
+public:
+    // Constructor
+    SensorTrace();
+
+    // Destructor
+    ~SensorTrace();
+
+
+    // Assessors
+    const TraceHeader &getHeader() const;
+    const TraceSample &getSample() const;
+    uint32_t getNbErrors() const;
+
+    //Methods
+    TraceFrameType push(uint8_t byte);
+
+    static int encodeHeader(const TraceHeader &header, uint8_t *buffer);
+    static int encodeSample(const TraceSample &sample, uint8_t *buffer);
+
+
+
+protected:
+    void decode(uint8_t type, const uint8_t *payload);
+    TraceFrameType resync();
+
+    uint8_t m_frame[TRACE_MAX_FRAME];
+    int m_length;
+    int m_expected;             //Frame length once the type is known
+    uint32_t m_nb_errors;       //Checksum errors, those of the rescanned bytes included
+    TraceHeader m_header;
+    TraceSample m_sample;
+};
+#endif
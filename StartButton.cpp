@@ -9,6 +9,7 @@
  */
 
 #include "StartButton.hpp"
+#include "Log.hpp"
 
 
 
@@ -66,7 +67,7 @@ const PinName& StartButton::getPin() const{
 void StartButton::displayWait() const
 {
     DigitalIn startButton(m_pin);
-    cout<<"---------------------- click on the button to start the program -------------------"<<endl;
+    LOG_INFO("---------------------- click on the button to start the program -------------------\n");
     while (detection(startButton) == false) {}
     ThisThread::sleep_for(500ms);
 }
@@ -78,7 +79,7 @@ void StartButton::displayWait() const
 void StartButton::initDisplayIMU() const
 {
     DigitalIn startButton(m_pin);
-    cout<<"--------------------- click on the button when the IMU is stable ------------------"<<endl;
+    LOG_INFO("--------------------- click on the button when the IMU is stable ------------------\n");
     while (detection(startButton) == false) {}
     ThisThread::sleep_for(500ms);
 }
@@ -90,7 +91,7 @@ void StartButton::initDisplayIMU() const
 void StartButton::initDisplayPot() const
 {
     DigitalIn startButton(m_pin);
-    cout<<"--------------- click on the button when you are standing and stable --------------"<<endl;
+    LOG_INFO("--------------- click on the button when you are standing and stable --------------\n");
     while (detection(startButton) == false) {}
     ThisThread::sleep_for(500ms);
 }
@@ -113,7 +114,7 @@ bool StartButton::detection(DigitalIn startButton) const
     //error handling
     if(DigitalIn(startButton).is_connected() == 0)
     {
-        cerr<<"No button is connected"<<endl;
+        LOG_ERROR("No button is connected\n");
     }
 
     if(DigitalIn(startButton).read() == 0)
@@ -13,8 +13,6 @@
 #ifndef DEF_STARTBUTTON
 #define DEF_STARTBUTTON
 
-#include <iostream>
-#include <ostream>
 #include "mbed.h"
 
 
@@ -0,0 +1,197 @@
+/**
+ * @file StepCounter.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "StepCounter.hpp"
+#include "Log.hpp"
+
+
+
+using namespace std;
+
+StepCounter *StepCounter::s_instance = NULL;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+StepCounter::StepCounter(LSM6DSLSensor &imu) : m_imu(imu), m_clock(NULL), m_enabled(false), m_use_irq(true),
+    m_step_us(0), m_nb_irq(0), m_nb_fetched(0), m_hw_count(0), m_count(0){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+StepCounter::~StepCounter()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+const bool& StepCounter::isEnabled() const{
+    return m_enabled;
+}
+
+const uint32_t& StepCounter::getCount() const{
+    return m_count;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Enables the pedometer with the step detector on INT1.
+ * enable_pedometer() sets the accelerometer to 26 Hz and 2 g, the caller must configure the IMU again after it.
+ *
+ * @param clock time base of the step timestamps
+ * @param threshold LSM6DSL_PEDOMETER_THRESHOLD_LOW to LSM6DSL_PEDOMETER_THRESHOLD_HIGH
+ * @param use_irq false when INT1 carries other events: the step detector is left off it and the counter is polled
+ * @return true if the sensor accepted the settings
+ */
+bool StepCounter::enable(const Timer &clock, uint8_t threshold, bool use_irq)
+{
+    m_clock = &clock;
+    s_instance = this;
+
+    if(m_imu.enable_pedometer() != 0
+        || m_imu.set_pedometer_threshold(threshold) != 0
+        || m_imu.reset_step_counter() != 0)
+    {
+        LOG_ERROR("Pedometer: configuration failed\n");
+        return false;
+    }
+
+    m_nb_irq = 0;
+    m_nb_fetched = 0;
+    m_hw_count = 0;
+    m_count = 0;
+    m_step_us = 0;
+    m_use_irq = use_irq;
+
+    if(m_use_irq)
+    {
+        m_imu.attach_int1_irq(&StepCounter::stepIrq);
+        m_imu.enable_int1_irq();
+    }
+    else
+    {
+        LSM6DSL_ACC_GYRO_W_STEP_DET_on_INT1((void *)&m_imu, LSM6DSL_ACC_GYRO_INT1_PEDO_DISABLED);
+    }
+    m_enabled = true;
+    return true;
+}
+
+/**
+ * @brief Stops the pedometer and its interrupt
+ *
+ */
+void StepCounter::disable()
+{
+    if(m_use_irq)
+    {
+        m_imu.disable_int1_irq();
+    }
+    m_imu.disable_pedometer();
+    m_enabled = false;
+}
+
+/**
+ * @brief Gives the step count and the time of the last step.
+ * The hardware counter is only read when the step detector raised an interrupt, idle walking costs no bus access.
+ * Without the interrupt it is read at every call, and the step time is the time of the call that saw it move
+ *
+ * @param count steps since enable()
+ * @param step_timestamp_us time of the last step
+ * @return true if a step happened since the last call
+ */
+bool StepCounter::fetch(uint32_t &count, int64_t &step_timestamp_us)
+{
+    if(!m_enabled)
+    {
+        return false;
+    }
+
+    if(!m_use_irq)
+    {
+        return poll(count, step_timestamp_us);
+    }
+
+    core_util_critical_section_enter();
+    uint32_t nb_irq = m_nb_irq;
+    int64_t step_us = m_step_us;
+    core_util_critical_section_exit();
+
+    if(nb_irq == m_nb_fetched)
+    {
+        return false;
+    }
+    m_nb_fetched = nb_irq;
+
+    uint16_t hw_count;
+    if(m_imu.get_step_counter(&hw_count) == 0)
+    {
+        m_count += (uint16_t)(hw_count - m_hw_count);
+        m_hw_count = hw_count;
+    }
+
+    count = m_count;
+    step_timestamp_us = step_us;
+    return true;
+}
+
+/**
+ * @brief Reads the hardware counter, for the polled mode
+ *
+ * @param count steps since enable()
+ * @param step_timestamp_us time of the call, if the count moved
+ * @return true if a step happened since the last call
+ */
+bool StepCounter::poll(uint32_t &count, int64_t &step_timestamp_us)
+{
+    uint16_t hw_count;
+    if(m_imu.get_step_counter(&hw_count) != 0 || hw_count == m_hw_count)
+    {
+        return false;
+    }
+    m_count += (uint16_t)(hw_count - m_hw_count);
+    m_hw_count = hw_count;
+
+    count = m_count;
+    step_timestamp_us = m_clock->elapsed_time().count();
+    return true;
+}
+
+/**
+ * @brief INT1 rising edge, one per detected step
+ *
+ */
+void StepCounter::stepIrq()
+{
+    StepCounter *self = s_instance;
+    if(self == NULL || self->m_clock == NULL)
+    {
+        return;
+    }
+    self->m_step_us = self->m_clock->elapsed_time().count();
+    self->m_nb_irq = self->m_nb_irq + 1;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file StepCounter.hpp
+ * @author Corentin BENOIT
+ * @brief Step count and step events from the LSM6DSL embedded pedometer
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_STEPCOUNTER
+#define DEF_STEPCOUNTER
+
+#include "mbed.h"
+#include <cstdint>
+#include "../LSM6DSL/LSM6DSLSensor.h"
+
+
+class StepCounter
+{
+public:
+    // Constructor
+    StepCounter(LSM6DSLSensor &imu);
+
+    // Destructor
+    ~StepCounter();
+
+
+    // Assessors
+    const bool &isEnabled() const;
+    const uint32_t &getCount() const;
+
+    //Methods
+    bool enable(const Timer &clock, uint8_t threshold = LSM6DSL_PEDOMETER_THRESHOLD_MID_HIGH, bool use_irq = true);
+    void disable();
+    bool fetch(uint32_t &count, int64_t &step_timestamp_us);
+
+
+
+protected:
+    bool poll(uint32_t &count, int64_t &step_timestamp_us);
+    static void stepIrq();
+    static StepCounter *s_instance;     //The driver only takes plain function pointers
+
+    LSM6DSLSensor &m_imu;
+    const Timer *m_clock;
+    bool m_enabled;
+    bool m_use_irq;             //False: INT1 is taken, the counter is read at every fetch
+
+    // Written by the step detector interrupt
+    volatile int64_t m_step_us;
+    volatile uint32_t m_nb_irq;
+
+    uint32_t m_nb_fetched;      //Interrupts already handled
+    uint16_t m_hw_count;        //Last value of the 16 bits hardware counter
+    uint32_t m_count;           //Steps since enable(), doesn't wrap at 65535
+};
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file TorqueTable.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "TorqueTable.hpp"
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+TorqueTable::TorqueTable() : m_color(' '){
+    for(int i = 0; i < TORQUE_TABLE_SIZE; i++)
+    {
+        m_increase[i] = 0.0f;
+        m_decrease[i] = 0.0f;
+    }
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+char TorqueTable::getColor() const{
+    return m_color;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Samples both curves of the colour of the sensor, about 440 polynomial evaluations, between two samples
+ *
+ * @param sensor
+ */
+void TorqueTable::build(const PotentiometerSensor &sensor)
+{
+    char increase = 'i';
+    char decrease = 'd';
+    for(int i = 0; i < TORQUE_TABLE_SIZE; i++)
+    {
+        m_increase[i] = sensor.calculateTorque(i*TORQUE_STEP, increase);
+        m_decrease[i] = sensor.calculateTorque(i*TORQUE_STEP, decrease);
+    }
+    m_color = sensor.getColor();
+}
+
+/**
+ * @brief Torque at an angle, clamped to [0; TORQUE_MAX_ANGLE]
+ *
+ * @param angle [deg]
+ * @param direction 'i' or 'd', as calculateTorque
+ * @return float [Nm]
+ */
+float TorqueTable::lookup(float angle, char direction) const
+{
+    const float *curve = (direction == 'd') ? m_decrease : m_increase;
+    if(!(angle > 0.0f))
+    {
+        return curve[0];
+    }
+    if(angle >= TORQUE_MAX_ANGLE)
+    {
+        return curve[TORQUE_TABLE_SIZE - 1];
+    }
+    float position = angle/TORQUE_STEP;
+    int index = (int)position;
+    float fraction = position - index;
+    return curve[index] + fraction*(curve[index + 1] - curve[index]);
+}
+
+/**
+ * @brief Same rule as PotentiometerSensor::forceDirection, on the hip velocity instead of two ADC reads 10 ms apart.
+ * The ADC value decreases while the hip angle increases: 'd' while bending, 'i' while standing up
+ *
+ * @param direction kept inside the dead zone, the user holds the position
+ * @param velocity [deg/s]
+ */
+void TorqueTable::updateDirection(char &direction, float velocity)
+{
+    if(velocity > TORQUE_DEAD_ZONE)
+    {
+        direction = 'd';
+    }
+    else if(velocity < -TORQUE_DEAD_ZONE)
+    {
+        direction = 'i';
+    }
+}
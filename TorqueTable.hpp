@@ -0,0 +1,53 @@
+/**
+ * @file TorqueTable.hpp
+ * @author Corentin BENOIT
+ * @brief Support torque of one Laevo rod from the hip angle, sampled once from the polynomials of PotentiometerSensor::calculateTorque
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_TORQUETABLE
+#define DEF_TORQUETABLE
+
+#include "PotentiometerSensor.hpp"
+
+const float TORQUE_MAX_ANGLE = 110.0f;      //Range of the fitted curves, the yellow polynomials diverge above [deg]
+const float TORQUE_STEP = 0.5f;             //Between two entries [deg]
+const int TORQUE_TABLE_SIZE = 221;          //TORQUE_MAX_ANGLE/TORQUE_STEP + 1
+const float TORQUE_DEAD_ZONE = 10.0f;       //Hip velocity that keeps the last force direction [deg/s]
+
+
+/**
+ * @brief One entry per half degree for each force direction, linear interpolation in between. Replaces the 7 to 10
+ * double precision terms of calculateTorque, software emulated on the Cortex-M4, by two loads and one multiply-add.
+ * Built again when the colour of the gas springs changes
+ */
+class TorqueTable
+{
+public:
+    // Constructor
+    TorqueTable();
+
+    // Destructor
+    ~TorqueTable() = default;
+
+
+    // Assessors
+    char getColor() const;
+
+    //Methods
+    void build(const PotentiometerSensor &sensor);
+    float lookup(float angle, char direction) const;
+    static void updateDirection(char &direction, float velocity);
+
+
+
+protected:
+    char m_color;               //Of the sensor when the table was built
+    float m_increase[TORQUE_TABLE_SIZE];    //'i' curve [Nm]
+    float m_decrease[TORQUE_TABLE_SIZE];    //'d' curve [Nm]
+};
+#endif
@@ -88,6 +88,29 @@ int TouchSensor::detection() const
     }
 }
 
+/**
+ * @brief Same detection from a raw value already read, from [0; UINT16_MAX]
+ * 
+ * @param raw 
+ * @return int 
+ */
+int TouchSensor::detection(uint16_t raw) const
+{
+    int value = raw*100/UINT16_MAX;
+    return (value > TRESHOLD) ? 100 : 0;
+}
+
+/**
+ * @brief Retrieves the raw data, from [0; UINT16_MAX] uint16_t
+ * 
+ * @return uint16_t 
+ */
+uint16_t TouchSensor::getRawData_u16() const
+{
+    AnalogIn touchSensor(m_pin);
+    return touchSensor.read_u16();
+}
+
 
 
 
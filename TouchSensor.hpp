@@ -12,7 +12,6 @@
 #ifndef DEF_TOUCHSENSOR
 #define DEF_TOUCHSENSOR
 
-#include <iostream>
 #include "mbed.h"
 
 // Detection level for the touch sensor
@@ -37,6 +36,8 @@ public:
     //Methods
     void display() const;
     int detection() const;
+    int detection(uint16_t raw) const;
+    uint16_t getRawData_u16() const;
 
 
 
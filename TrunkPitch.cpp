@@ -0,0 +1,92 @@
+/**
+ * @file TrunkPitch.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "TrunkPitch.hpp"
+#include <cmath>
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+TrunkPitch::TrunkPitch(int axis, int sign) : m_axis(axis), m_sign(sign){
+    reset();
+}
+
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+bool TrunkPitch::isStarted() const{
+    return m_started;
+}
+
+float TrunkPitch::getPitch() const{
+    return m_pitch;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief The next update starts on the accelerometer
+ *
+ */
+void TrunkPitch::reset()
+{
+    m_started = false;
+    m_timestamp_us = 0;
+    m_pitch = 0.0f;
+}
+
+/**
+ * @brief New IMU sample
+ *
+ * @param acc [mg]
+ * @param rate pitch rate after the calibration offset, with the sign of the hip angles [deg/s]
+ * @param timestamp_us
+ */
+void TrunkPitch::update(const int32_t acc[3], float rate, int64_t timestamp_us)
+{
+    //A rotation of +w around the axis turns atan2(acc[c], acc[b]) by -w
+    int b = (m_axis + 1) % 3;
+    int c = (m_axis + 2) % 3;
+    float tilt = m_sign*atan2f(-(float)acc[c], (float)acc[b])*57.29578f;
+
+    float dt = (timestamp_us - m_timestamp_us)/1000000.0f;
+    if(m_started && dt <= 0.0f)
+    {
+        return;
+    }
+    if(!m_started || dt > PITCH_MAX_STEP)
+    {
+        m_pitch = tilt;
+        m_timestamp_us = timestamp_us;
+        m_started = true;
+        return;
+    }
+    m_timestamp_us = timestamp_us;
+
+    float gain = dt/(PITCH_TIME_CONSTANT + dt);
+    float predicted = m_pitch + rate*dt;
+    m_pitch = predicted + gain*(tilt - predicted);
+}
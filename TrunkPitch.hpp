@@ -0,0 +1,52 @@
+/**
+ * @file TrunkPitch.hpp
+ * @author Corentin BENOIT
+ * @brief Trunk pitch, complementary filter of the gyroscope pitch rate and the accelerometer tilt
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_TRUNKPITCH
+#define DEF_TRUNKPITCH
+
+#include <cstdint>
+
+const float PITCH_TIME_CONSTANT = 1.0f;     //Below it the gyroscope leads, above it the accelerometer [s]
+const float PITCH_MAX_STEP = 0.1f;          //Longer gaps restart on the accelerometer [s]
+
+
+/**
+ * @brief 0 with the IMU horizontal, as during the calibration, positive in the direction of the hip angles.
+ * The accelerometer tilt is measured in the plane normal to the pitch axis, so it holds whatever the roll
+ */
+class TrunkPitch
+{
+public:
+    // Constructor
+    TrunkPitch(int axis, int sign);
+
+    // Destructor
+    ~TrunkPitch() = default;
+
+
+    // Assessors
+    bool isStarted() const;
+    float getPitch() const;
+
+    //Methods
+    void reset();
+    void update(const int32_t acc[3], float rate, int64_t timestamp_us);
+
+
+
+protected:
+    int m_axis;                 //Gyroscope axis of the pitch: 0 X, 1 Y, 2 Z
+    int m_sign;                 //1 or -1
+    bool m_started;
+    int64_t m_timestamp_us;
+    float m_pitch;              //[deg]
+};
+#endif
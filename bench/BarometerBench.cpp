@@ -0,0 +1,199 @@
+/**
+ * @file BarometerBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check of BarometerSensor against the LPS22HB model, on a scripted pressure profile
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build only, the sensor talks to the model through the mbed shim of host/:
+ *   cmake --build build --target barometer_bench && ./build/barometer_bench
+ * The sensor is read at the task rate of main.cpp. The profile stands still, climbs a flight of stairs, stands still
+ * again, then drops back down at once: the plateaus check the altitude, the climb the lag, the drop the low-pass filter
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "mbed.h"
+#include "HostTime.hpp"
+#include "LPS22HBModel.hpp"
+#include "BarometerSensor.hpp"
+
+using namespace std;
+
+const float BENCH_HEIGHT = 3.0f;            //Flight of stairs [m]
+const float BENCH_START = 10.0f;            //Profile times from the configuration of the sensor [s]
+const float BENCH_CLIMB = 10.0f;
+const float BENCH_TOP = 15.0f;
+const float BENCH_BOTTOM = 10.0f;
+const float BENCH_GROUND = 150.0f;          //Altitude of the bench above the sea level [m]
+const float BENCH_MAX_PLATEAU_ERROR = 0.05f;    //Pass limits [m]
+const float BENCH_MAX_LAG = 0.6f;               //While climbing at 0.3 m/s [m]
+const float BENCH_STEP_MIN = 0.35f;             //Share of the drop after BARO_ALTITUDE_TAU
+const float BENCH_STEP_MAX = 0.70f;
+const float BENCH_STEP_FAST = 0.25f;            //Largest share of the drop 0.2 s after it, the filter is on
+const int64_t BENCH_ONE_SHOT_MARGIN_US = 1000;
+
+namespace
+{
+    LPS22HBModel s_model(LPS22HB_ADDRESS_HIGH);
+    DevI2C s_i2c(PB_11, PB_10);
+    BarometerSensor s_barometer(&s_i2c);
+
+    // Altitude of the profile relative to the ground [m]
+    float profile(float t)
+    {
+        float top = BENCH_START + BENCH_CLIMB + BENCH_TOP;
+        if(t < BENCH_START || t >= top)
+        {
+            return 0.0f;
+        }
+        return BENCH_HEIGHT*fminf(1.0f, (t - BENCH_START)/BENCH_CLIMB);
+    }
+
+    // Loads the profile into the model from now on, the drop lasts 1 ms
+    void script()
+    {
+        int64_t start_us = host::now();
+        float top = BENCH_START + BENCH_CLIMB + BENCH_TOP;
+        const float times[6] = {0.0f, BENCH_START, BENCH_START + BENCH_CLIMB, top, top + 0.001f, top + BENCH_BOTTOM};
+
+        s_model.clearProfile();
+        for(float t : times)
+        {
+            float altitude = (t == top) ? BENCH_HEIGHT : profile(t);
+            s_model.addPressure(start_us + (int64_t)(t*1e6f), LPS22HBModel::pressureAt(BENCH_GROUND + altitude));
+        }
+    }
+
+    bool check(bool condition, const char *what, float value)
+    {
+        printf("  %-44s %8.3f  %s\n", what, value, condition ? "ok" : "FAILED");
+        return condition;
+    }
+}
+
+/**
+ * @brief Runs the profile at one rate, reading the sensor as main.cpp does
+ *
+ * @param rate barometer ODR or one-shot rate [Hz]
+ * @return 0 if every check passed
+ */
+int runProfile(float rate)
+{
+    bool one_shot = rate < BARO_ONE_SHOT_RATE;
+    float task_rate = one_shot ? rate : rate/(BARO_FIFO_BURST - 1);
+    int64_t period_us = (int64_t)(1e6f/task_rate);
+
+    printf("%.1f Hz, %s, read every %lld ms:\n", rate, one_shot ? "one-shot" : "FIFO", (long long)(period_us/1000));
+
+    script();
+    s_barometer.configure(rate);
+    s_barometer.resetReference();
+
+    uint32_t first_sample = s_model.getSampleCount();
+    uint32_t first_overrun = s_model.getOverrunCount();
+    int64_t start_us = host::now();
+    float top = BENCH_START + BENCH_CLIMB + BENCH_TOP;
+    float end = top + BENCH_BOTTOM;
+
+    int nb_read = 0;
+    float worst_plateau = 0, worst_lag = 0, step_tau = -1, step_fast = -1;
+    bool one_shot_cleared = true;
+    int64_t tick_us = period_us;
+
+    while (host::now() - start_us < (int64_t)(end*1e6f)) {
+        host::advance(tick_us);
+        int read = s_barometer.update();
+        if(read < 0)
+        {
+            printf("  bus error\n");
+            return 1;
+        }
+        nb_read += read;
+
+        // The one-shot bit is set by the read and clears itself at the end of the conversion
+        if(one_shot)
+        {
+            host::advance(MODEL_ONE_SHOT_US + BENCH_ONE_SHOT_MARGIN_US);
+            one_shot_cleared = one_shot_cleared && (s_model.getRegister(LPS22HB_CTRL_REG2) & LPS22HB_ONE_SHOT) == 0;
+            tick_us = period_us - MODEL_ONE_SHOT_US - BENCH_ONE_SHOT_MARGIN_US;
+        }
+
+        float t = (host::now() - start_us)*1e-6f;
+        float altitude = s_barometer.getAltitude();
+        float error = altitude - profile(t);
+
+        // End of each plateau, five time constants after its start
+        float settle = 5.0f*fmaxf(BARO_ALTITUDE_TAU, 1.0f/rate);
+        if((t > settle && t < BENCH_START) || (t > BENCH_START + BENCH_CLIMB + settle && t < top) || t > top + settle)
+        {
+            worst_plateau = fmaxf(worst_plateau, fabsf(error));
+        }
+        else if(t > BENCH_START + settle && t < BENCH_START + BENCH_CLIMB)
+        {
+            worst_lag = fmaxf(worst_lag, -error);
+        }
+
+        // The drop, as the share done
+        float done = 1.0f - altitude/BENCH_HEIGHT;
+        if(step_fast < 0 && t >= top + 0.2f)
+        {
+            step_fast = done;
+        }
+        if(step_tau < 0 && t >= top + BARO_ALTITUDE_TAU)
+        {
+            step_tau = done;
+        }
+    }
+
+    int expected = (int)(end*rate);
+    uint32_t produced = s_model.getSampleCount() - first_sample;
+    bool ok = true;
+    ok &= check(abs(nb_read - expected) <= BARO_FIFO_BURST && (uint32_t)nb_read + BARO_FIFO_BURST >= produced,
+        "samples read", (float)nb_read);
+    ok &= check(s_model.getOverrunCount() == first_overrun, "samples lost", (float)(s_model.getOverrunCount() - first_overrun));
+    ok &= check(worst_plateau <= BENCH_MAX_PLATEAU_ERROR, "worst plateau error [m]", worst_plateau);
+    if(one_shot)
+    {
+        ok &= check(one_shot_cleared, "ONE_SHOT cleared after each conversion", one_shot_cleared ? 1.0f : 0.0f);
+    }
+    else
+    {
+        // The one-shot path reads too seldom for these, its filter only settles at the plateaus
+        ok &= check(worst_lag <= BENCH_MAX_LAG && worst_lag >= 0, "worst lag while climbing [m]", worst_lag);
+        ok &= check(step_fast <= BENCH_STEP_FAST, "drop done 0.2 s after it", step_fast);
+        ok &= check(step_tau >= BENCH_STEP_MIN && step_tau <= BENCH_STEP_MAX, "drop done after BARO_ALTITUDE_TAU", step_tau);
+    }
+
+    s_barometer.powerDown();
+    return ok ? 0 : 1;
+}
+
+int main()
+{
+    host::setDefaultRunLimit(0);
+    host::addTimeListener([](int64_t now_us){ s_model.update(now_us); });
+
+    if(s_barometer.init(NULL) != 0)
+    {
+        printf("FAILED, no barometer\n");
+        return 1;
+    }
+
+    int result = 0;
+    const float rates[4] = {10.0f, 25.0f, 75.0f, 0.5f};
+    for(float rate : rates)
+    {
+        result |= runProfile(rate);
+    }
+
+    s_model.report();
+    if(result != 0)
+    {
+        printf("FAILED\n");
+    }
+    return result;
+}
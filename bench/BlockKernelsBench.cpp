@@ -0,0 +1,193 @@
+/**
+ * @file BlockKernelsBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check and benchmark of the block kernels of BlockProcessor against their scalar reference
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build, or alone:
+ *   g++ -std=c++17 -O2 -I.. BlockKernelsBench.cpp ../BlockProcessor.cpp -o block_kernels_bench && ./block_kernels_bench
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "BlockProcessor.hpp"
+
+using namespace std;
+
+const int BENCH_BLOCK_LENGTHS[3] = {32, 64, 128};
+const int BENCH_NB_SAMPLES = 1 << 22;
+const int CHECK_NB_BLOCKS = 20000;
+
+// One block, three axes
+struct Block
+{
+    int16_t axes[BLOCK_AXES][128];
+    AxisBlock view;
+
+    Block(int length)
+    {
+        for(int i = 0; i < BLOCK_AXES; i++)
+        {
+            view.axis[i] = axes[i];
+        }
+        view.length = length;
+    }
+};
+
+// Values at the edges of the saturations, drawn more often than the others
+int16_t randomValue()
+{
+    const int16_t edges[8] = {INT16_MIN, INT16_MIN + 1, -1, 0, 1, INT16_MAX - 1, INT16_MAX, -16384};
+    if(rand() % 4 == 0)
+    {
+        return edges[rand() % 8];
+    }
+    return (int16_t)(rand() % 65536 - 32768);
+}
+
+void randomSettings(BlockProcessor &processor)
+{
+    int16_t bias[BLOCK_AXES];
+    int16_t gain[BLOCK_AXES];
+    for(int i = 0; i < BLOCK_AXES; i++)
+    {
+        bias[i] = randomValue();
+        gain[i] = randomValue();
+    }
+    processor.setBias(bias);
+    processor.setGain(gain, rand() % 16);
+
+    int16_t a = randomValue();
+    int16_t b = randomValue();
+    if(rand() % 4 == 0)
+    {
+        processor.setClamp(INT16_MIN, INT16_MAX);
+    }
+    else
+    {
+        processor.setClamp(min(a, b), max(a, b));
+    }
+}
+
+/**
+ * @brief Random settings and data on every length from 0 to 128, so the tails are covered too
+ *
+ * @return number of blocks that differ from the reference
+ */
+int checkExactness()
+{
+    int nb_mismatches = 0;
+    uint8_t data[128*BLOCK_SAMPLE_BYTES];
+    srand(1);
+
+    for(int b = 0; b < CHECK_NB_BLOCKS; b++)
+    {
+        int length = b % 129;
+        BlockProcessor processor;
+        randomSettings(processor);
+        for(int i = 0; i < length*BLOCK_SAMPLE_BYTES; i += 2)
+        {
+            int16_t value = randomValue();
+            data[i] = (uint8_t)value;
+            data[i + 1] = (uint8_t)(value >> 8);
+        }
+
+        Block simd(length);
+        Block reference(length);
+        processor.unpack(data, simd.view);
+        processor.unpackReference(data, reference.view);
+        bool same = true;
+        for(int i = 0; i < BLOCK_AXES; i++)
+        {
+            same = same && memcmp(simd.axes[i], reference.axes[i], length*sizeof(int16_t)) == 0;
+        }
+
+        processor.process(simd.view);
+        processor.processReference(reference.view);
+        for(int i = 0; i < BLOCK_AXES; i++)
+        {
+            same = same && memcmp(simd.axes[i], reference.axes[i], length*sizeof(int16_t)) == 0;
+        }
+
+        if(!same)
+        {
+            nb_mismatches++;
+        }
+    }
+    return nb_mismatches;
+}
+
+/**
+ * @brief Time per sample of unpack and process, both paths, for each block length
+ *
+ */
+void benchmark()
+{
+    vector<uint8_t> data(BENCH_NB_SAMPLES*BLOCK_SAMPLE_BYTES);
+    srand(2);
+    for(size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = (uint8_t)rand();
+    }
+
+    BlockProcessor processor;
+    const int16_t bias[BLOCK_AXES] = {-37, 112, -1024};
+    const int16_t gain[BLOCK_AXES] = {16384, 23170, -11585};
+    processor.setBias(bias);
+    processor.setGain(gain, 14);
+    processor.setClamp(-30000, 30000);
+
+    volatile int32_t sink = 0;
+    for(int l = 0; l < 3; l++)
+    {
+        int length = BENCH_BLOCK_LENGTHS[l];
+        int nb_blocks = BENCH_NB_SAMPLES/length;
+        Block block(length);
+        double ns[2];
+
+        for(int path = 0; path < 2; path++)
+        {
+            auto start = chrono::steady_clock::now();
+            for(int b = 0; b < nb_blocks; b++)
+            {
+                const uint8_t *bytes = &data[(size_t)b*length*BLOCK_SAMPLE_BYTES];
+                if(path == 0)
+                {
+                    processor.unpackReference(bytes, block.view);
+                    processor.processReference(block.view);
+                }
+                else
+                {
+                    processor.unpack(bytes, block.view);
+                    processor.process(block.view);
+                }
+                sink = sink + block.axes[0][0] + block.axes[1][length - 1] + block.axes[2][length/2];
+            }
+            ns[path] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/(nb_blocks*length);
+        }
+
+        printf("%3d samples: scalar %.2f ns per sample, %s %.2f ns per sample, %.1fx\n",
+            length, ns[0], BlockProcessor::getImplementation(), ns[1], ns[0]/ns[1]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int nb_mismatches = checkExactness();
+    printf("Blocks that differ from the scalar reference: %d of %d\n", nb_mismatches, CHECK_NB_BLOCKS);
+    benchmark();
+
+    if(nb_mismatches > 0)
+    {
+        printf("FAILED, not bit exact\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file ExposureBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check of the bins of ExposureLog, its edge validation and its KVStore round trip
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build only, the histograms are stored through the kv_set and kv_get of host/:
+ *   cmake --build build --target exposure_bench && ./build/exposure_bench
+ * HOST_KV_DIR is ignored, the store is the in-memory one
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "kvstore_global_api.h"
+#include "ExposureLog.hpp"
+
+using namespace std;
+
+const uint32_t BENCH_DT_US = 2404;          //One sample at 416 Hz
+
+namespace
+{
+    bool check(bool condition, const char *what)
+    {
+        printf("  %-56s %s\n", what, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Field by field, the padding of a copy is not defined
+    bool sameData(const ExposureData &a, const ExposureData &b)
+    {
+        return a.version == b.version
+            && memcmp(a.nb_edges, b.nb_edges, sizeof(a.nb_edges)) == 0
+            && memcmp(a.edges, b.edges, sizeof(a.edges)) == 0
+            && memcmp(a.time_us, b.time_us, sizeof(a.time_us)) == 0
+            && a.touch_us == b.touch_us
+            && a.total_us == b.total_us;
+    }
+
+    // Bin of the trunk histogram the angle is counted in, -1 if it went to more than one
+    int trunkBin(ExposureLog &log, float angle)
+    {
+        ExposureData before = log.getData();
+        const float angles[EXPOSURE_NB_SIGNALS] = {angle, 0.0f, 0.0f};
+        log.add(angles, false, BENCH_DT_US);
+
+        int bin = -1;
+        for(int i = 0; i < EXPOSURE_MAX_BINS; i++)
+        {
+            uint64_t added = log.getData().time_us[EXPOSURE_TRUNK][i] - before.time_us[EXPOSURE_TRUNK][i];
+            if(added == BENCH_DT_US && bin < 0)
+            {
+                bin = i;
+            }
+            else if(added != 0)
+            {
+                return -1;
+            }
+        }
+        return bin;
+    }
+}
+
+/**
+ * @brief Angles on the edges, just under them, negative, NaN and out of the lookup range
+ *
+ * @return number of failed checks
+ */
+int checkBins()
+{
+    printf("Bins:\n");
+    ExposureLog log;
+    const float nan = numeric_limits<float>::quiet_NaN();
+    const float inf = numeric_limits<float>::infinity();
+    int nb_failed = 0;
+
+    // Default trunk edges 0, 20, 45, 60, 90: bin i is [edges[i-1]; edges[i])
+    nb_failed += !check(trunkBin(log, 20.0f) == 2, "20 deg, on an edge, in the bin above it");
+    nb_failed += !check(trunkBin(log, 19.999f) == 1, "19.999 deg in the bin under it");
+    nb_failed += !check(trunkBin(log, 0.0f) == 1, "0 deg, on the first edge, in bin 1");
+    nb_failed += !check(trunkBin(log, -0.001f) == 0, "-0.001 deg in the first bin");
+    nb_failed += !check(trunkBin(log, 90.0f) == 5, "90 deg, on the last edge, in the last bin");
+    nb_failed += !check(trunkBin(log, nan) == 0, "NaN in the first bin");
+    nb_failed += !check(trunkBin(log, -inf) == 0, "-inf in the first bin");
+    nb_failed += !check(trunkBin(log, -1000.0f) == 0, "-1000 deg, under the lookup, in the first bin");
+    nb_failed += !check(trunkBin(log, 250.0f) == 5, "250 deg, over the lookup, in the last bin");
+    nb_failed += !check(trunkBin(log, inf) == 5, "inf in the last bin");
+
+    // Negative edges, and the last one at the top of the lookup
+    const int16_t edges[] = {-60, -30, 0, 180};
+    nb_failed += !check(log.setEdges(EXPOSURE_TRUNK, edges, 4), "edges -60, -30, 0, 180 accepted");
+    nb_failed += !check(trunkBin(log, -90.0f) == 0, "-90 deg in the first bin");
+    nb_failed += !check(trunkBin(log, -60.0f) == 1, "-60 deg, on a negative edge, in the bin above it");
+    nb_failed += !check(trunkBin(log, -30.5f) == 1, "-30.5 deg, floored to -31, in the bin under -30");
+    nb_failed += !check(trunkBin(log, -30.0f) == 2, "-30 deg in the bin above it");
+    nb_failed += !check(trunkBin(log, 179.99f) == 3, "179.99 deg in the bin under 180");
+    nb_failed += !check(trunkBin(log, 180.0f) == 4, "180 deg, on the last edge, in the last bin");
+    nb_failed += !check(trunkBin(log, 181.0f) == 4, "181 deg in the last bin");
+
+    // Totals, the touch time and clear
+    const float angles[EXPOSURE_NB_SIGNALS] = {10.0f, 45.0f, 95.0f};
+    log.clear();
+    log.add(angles, true, BENCH_DT_US);
+    log.add(angles, false, BENCH_DT_US);
+    const ExposureData &data = log.getData();
+    nb_failed += !check(data.total_us == 2*BENCH_DT_US && data.touch_us == BENCH_DT_US, "total and touch time");
+    nb_failed += !check(data.time_us[EXPOSURE_HIP_RIGHT][2] == 2*BENCH_DT_US && data.time_us[EXPOSURE_HIP_LEFT][4] == 2*BENCH_DT_US,
+        "each hip in its own histogram");
+    return nb_failed;
+}
+
+/**
+ * @brief Invalid edges are refused and leave the histogram as it was
+ *
+ * @return number of failed checks
+ */
+int checkEdges()
+{
+    printf("Edges:\n");
+    ExposureLog log;
+    const float angles[EXPOSURE_NB_SIGNALS] = {30.0f, 30.0f, 30.0f};
+    log.add(angles, false, BENCH_DT_US);
+    ExposureData before = log.getData();
+
+    const int16_t valid[] = {0, 30};
+    const int16_t descending[] = {30, 0};
+    const int16_t equal[] = {0, 30, 30};
+    const int16_t low[] = {-91, 0};
+    const int16_t high[] = {0, 181};
+    int16_t many[EXPOSURE_MAX_EDGES + 1];
+    for(int i = 0; i <= EXPOSURE_MAX_EDGES; i++)
+    {
+        many[i] = (int16_t)(i*10);
+    }
+
+    int nb_failed = 0;
+    nb_failed += !check(!log.setEdges(-1, valid, 2), "signal -1 refused");
+    nb_failed += !check(!log.setEdges(EXPOSURE_NB_SIGNALS, valid, 2), "signal EXPOSURE_NB_SIGNALS refused");
+    nb_failed += !check(!log.setEdges(EXPOSURE_TRUNK, valid, 0), "no edge refused");
+    nb_failed += !check(!log.setEdges(EXPOSURE_TRUNK, many, EXPOSURE_MAX_EDGES + 1), "EXPOSURE_MAX_EDGES + 1 edges refused");
+    nb_failed += !check(!log.setEdges(EXPOSURE_TRUNK, descending, 2), "descending edges refused");
+    nb_failed += !check(!log.setEdges(EXPOSURE_TRUNK, equal, 3), "equal edges refused");
+    nb_failed += !check(!log.setEdges(EXPOSURE_TRUNK, low, 2), "edge under EXPOSURE_MIN_ANGLE refused");
+    nb_failed += !check(!log.setEdges(EXPOSURE_TRUNK, high, 2), "edge over EXPOSURE_MAX_ANGLE refused");
+    nb_failed += !check(sameData(before, log.getData()), "nothing changed by the refused edges");
+
+    nb_failed += !check(log.setEdges(EXPOSURE_TRUNK, many, EXPOSURE_MAX_EDGES), "EXPOSURE_MAX_EDGES edges accepted");
+    const ExposureData &data = log.getData();
+    bool cleared = true;
+    for(int i = 0; i < EXPOSURE_MAX_BINS; i++)
+    {
+        cleared = cleared && data.time_us[EXPOSURE_TRUNK][i] == 0;
+    }
+    nb_failed += !check(cleared && data.time_us[EXPOSURE_HIP_RIGHT][2] == BENCH_DT_US, "only the time of that histogram cleared");
+    return nb_failed;
+}
+
+/**
+ * @brief Saves a shift with its own edges and loads it in a new log, then corrupted copies that must be ignored
+ *
+ * @return number of failed checks
+ */
+int checkStore()
+{
+    printf("KVStore:\n");
+    int nb_failed = 0;
+    ExposureLog empty;
+    nb_failed += !check(!empty.load(), "nothing loaded before the first save");
+
+    ExposureLog log;
+    const int16_t edges[] = {-20, 10, 40, 70, 100, 130};
+    log.setEdges(EXPOSURE_HIP_RIGHT, edges, 6);
+    for(int n = 0; n < 1000; n++)
+    {
+        const float angles[EXPOSURE_NB_SIGNALS] = {n*0.1f - 10.0f, n*0.15f - 20.0f, n*0.12f};
+        log.add(angles, n%3 == 0, BENCH_DT_US);
+    }
+    nb_failed += !check(ExposureLog::save(log.getData()), "saved");
+
+    ExposureLog restored;
+    nb_failed += !check(restored.load(), "loaded");
+    nb_failed += !check(sameData(log.getData(), restored.getData()), "same data");
+
+    // The lookup follows the loaded edges
+    const float angles[EXPOSURE_NB_SIGNALS] = {50.0f, -5.0f, 75.0f};
+    log.add(angles, false, BENCH_DT_US);
+    restored.add(angles, false, BENCH_DT_US);
+    nb_failed += !check(sameData(log.getData(), restored.getData()), "same bins after the load");
+
+    ExposureData other = log.getData();
+    other.version = EXPOSURE_VERSION + 1;
+    ExposureLog::save(other);
+    nb_failed += !check(!restored.load(), "other layout version ignored");
+
+    other = log.getData();
+    other.nb_edges[EXPOSURE_HIP_LEFT] = EXPOSURE_MAX_EDGES + 1;
+    ExposureLog::save(other);
+    nb_failed += !check(!restored.load(), "too many edges ignored");
+
+    kv_set(EXPOSURE_KEY, &other, sizeof(other) - 8, 0);
+    nb_failed += !check(!restored.load(), "shorter value ignored");
+    nb_failed += !check(sameData(log.getData(), restored.getData()), "log kept by the ignored loads");
+    return nb_failed;
+}
+
+/**
+ * @brief Time of one sample in the three histograms
+ *
+ */
+void benchmark()
+{
+    const int nb_updates = 1 << 22;
+    ExposureLog log;
+
+    auto start = chrono::steady_clock::now();
+    for(int n = 0; n < nb_updates; n++)
+    {
+        const float angles[EXPOSURE_NB_SIGNALS] = {(float)(n%200) - 50.0f, (float)(n%130), (float)(n%110)};
+        log.add(angles, (n & 1) != 0, BENCH_DT_US);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/nb_updates;
+    printf("%.1f ns per sample on the host (%llu us recorded)\n", ns, (unsigned long long)log.getData().total_us);
+}
+
+int main()
+{
+    unsetenv("HOST_KV_DIR");
+
+    int nb_failed = checkBins();
+    nb_failed += checkEdges();
+    nb_failed += checkStore();
+    benchmark();
+
+    if(nb_failed > 0)
+    {
+        printf("FAILED, %d checks\n", nb_failed);
+        return 1;
+    }
+    return 0;
+}
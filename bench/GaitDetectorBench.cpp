@@ -0,0 +1,335 @@
+/**
+ * @file GaitDetectorBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check of GaitDetector on synthetic gait traces fed through potentiometer-only hip estimators
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build, or alone:
+ *   g++ -std=c++17 -O2 -I.. GaitDetectorBench.cpp ../GaitDetector.cpp ../HipEstimator.cpp -o gait_detector_bench
+ *   ./gait_detector_bench
+ * The potentiometers are simulated as in hip_estimator_bench and feed the estimators of the detector as in main.cpp,
+ * without the gyroscope. The truth events are the extrema of the noise-free hip angles, found on a 0.1 ms grid
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "GaitDetector.hpp"
+#include "HipEstimator.hpp"
+
+using namespace std;
+
+const double BENCH_IMU_FREQ = 416.0;        //imu_freq of main.cpp
+const double BENCH_POT_FREQ = 200.0;        //pot_freq of main.cpp
+const double BENCH_POT_NOISE = 0.5;         //[deg]
+const double BENCH_ADC_LSB = 255.0/65535.0; //[deg/LSB]
+const double BENCH_RAMP = 1.5;              //Start and end of a walk, the amplitude grows or shrinks [s]
+const double BENCH_MATCH = 0.1;             //A detection further than this from its truth is false [s]
+const double BENCH_MAX_ERROR = 0.05;        //Pass limits: worst timing error [s]
+const double BENCH_MIN_DETECTED = 0.98;     //Share of the truth events
+const double BENCH_MAX_CADENCE_ERROR = 0.02;
+const double BENCH_PI = 3.14159265358979;
+
+/**
+ * @brief One part of the trace. Walking: stride time, peak flexion and extension of the hips, the left one half a
+ * stride behind. Otherwise standing, with squats of both hips together every squat_period seconds
+ */
+struct Segment
+{
+    const char *name;
+    double duration;            //[s]
+    double stride;              //[s], 0 for standing
+    double flexion;             //[deg]
+    double extension;
+    double squat_period;        //[s], 0 for none
+};
+
+const Segment SEGMENTS[] = {
+    {"standing", 5.0, 0.0, 0.0, 0.0, 0.0},
+    {"normal walk", 30.0, 1.1, 30.0, -10.0, 0.0},
+    {"squats", 12.0, 0.0, 0.0, 0.0, 3.0},
+    {"slow walk", 30.0, 1.5, 18.0, -6.0, 0.0},
+    {"standing", 8.0, 0.0, 0.0, 0.0, 0.0},
+    {"fast walk", 30.0, 0.9, 36.0, -15.0, 0.0},
+    {"standing", 5.0, 0.0, 0.0, 0.0, 0.0},
+};
+const int BENCH_NB_SEGMENTS = sizeof(SEGMENTS)/sizeof(SEGMENTS[0]);
+
+struct Pose
+{
+    double hip[2];              //Right, left [deg]
+    int segment;
+    bool steady;                //Walking at full amplitude, scored
+};
+
+/**
+ * @brief Hip angle over one stride: a fundamental and a second harmonic, so the flexion is a plateau
+ * and the extension a sharper peak about 57% of the stride later, as in a real gait, scaled to the peaks
+ *
+ */
+double strideAngle(double phase, double flexion, double extension)
+{
+    static double shape_min = 0.0, shape_max = 0.0;
+    if(shape_max == 0.0)
+    {
+        for(int i = 0; i < 10000; i++)
+        {
+            double x = i/10000.0;
+            double y = cos(2*BENCH_PI*x) - 0.15*cos(4*BENCH_PI*x - 0.8);
+            shape_min = (y < shape_min) ? y : shape_min;
+            shape_max = (y > shape_max) ? y : shape_max;
+        }
+    }
+    double shape = cos(2*BENCH_PI*phase) - 0.15*cos(4*BENCH_PI*phase - 0.8);
+    return extension + (shape - shape_min)*(flexion - extension)/(shape_max - shape_min);
+}
+
+Pose motion(double t)
+{
+    Pose pose;
+    double start = 0.0;
+    int s = 0;
+    while (s < BENCH_NB_SEGMENTS - 1 && t >= start + SEGMENTS[s].duration) {
+        start += SEGMENTS[s].duration;
+        s++;
+    }
+    const Segment &segment = SEGMENTS[s];
+    double local = t - start;
+    pose.segment = s;
+    pose.steady = false;
+    pose.hip[0] = pose.hip[1] = 0.8*sin(2*BENCH_PI*0.15*t);      //Weight shifts
+
+    if(segment.stride > 0.0)
+    {
+        double envelope = 1.0;
+        if(local < BENCH_RAMP)
+        {
+            envelope = 0.5*(1 - cos(BENCH_PI*local/BENCH_RAMP));
+        }
+        else if(local > segment.duration - BENCH_RAMP)
+        {
+            envelope = 0.5*(1 - cos(BENCH_PI*(segment.duration - local)/BENCH_RAMP));
+        }
+        pose.steady = (envelope >= 1.0);
+        for(int side = 0; side < 2; side++)
+        {
+            double phase = local/segment.stride + 0.5*side;
+            pose.hip[side] += envelope*strideAngle(phase - floor(phase), segment.flexion, segment.extension);
+        }
+    }
+    else if(segment.squat_period > 0.0)
+    {
+        double phase = fmod(local, segment.squat_period)/segment.squat_period;
+        double squat = (phase < 0.6) ? 0.5*(1 - cos(2*BENCH_PI*phase/0.6)) : 0.0;
+        pose.hip[0] += 85.0*squat;      //One hip a bit further than the other
+        pose.hip[1] += 80.0*squat;
+    }
+    return pose;
+}
+
+struct TruthEvent
+{
+    double t;
+    int side;
+    GaitEventKind kind;
+    bool steady;
+    bool matched;
+};
+
+/**
+ * @brief Extrema of the noise-free hip angles, during the walks only
+ *
+ */
+vector<TruthEvent> truthEvents(double duration)
+{
+    vector<TruthEvent> events;
+    const double dt = 1e-4;
+    double last_velocity[2] = {0, 0};
+    Pose last = motion(0);
+    for(double t = dt; t < duration; t += dt)
+    {
+        Pose pose = motion(t);
+        for(int side = 0; side < 2; side++)
+        {
+            double velocity = (pose.hip[side] - last.hip[side])/dt;
+            if(SEGMENTS[pose.segment].stride > 0.0 && last_velocity[side]*velocity < 0.0)
+            {
+                GaitEventKind kind = (velocity < 0.0) ? GAIT_HEEL_STRIKE : GAIT_TOE_OFF;
+                events.push_back({t - 0.5*dt, side, kind, pose.steady, false});
+            }
+            last_velocity[side] = velocity;
+        }
+        last = pose;
+    }
+    return events;
+}
+
+/**
+ * @brief Runs the whole trace through two hip estimators and the detector
+ *
+ * @return 0 if within the limits
+ */
+int checkSynthetic()
+{
+    double duration = 0.0;
+    for(int s = 0; s < BENCH_NB_SEGMENTS; s++)
+    {
+        duration += SEGMENTS[s].duration;
+    }
+    vector<TruthEvent> truth = truthEvents(duration);
+
+    mt19937 random(1);
+    normal_distribution<double> normal(0.0, 1.0);
+    const double dt = 1.0/BENCH_IMU_FREQ;
+    HipEstimator estimators[2];
+    GaitDetector detector;
+    double next_pot = 0.0;
+    int nb_false = 0;
+    int nb_detected[BENCH_NB_SEGMENTS] = {0};
+    double error_sum = 0.0;
+    double error_max = 0.0;
+    int nb_matched = 0;
+    int64_t latency_max_us = 0;
+    double cadence_error[BENCH_NB_SEGMENTS] = {0};
+
+    for(int n = 0; n*dt < duration; n++)
+    {
+        double t = n*dt;
+        if(t >= next_pot)
+        {
+            Pose pose = motion(next_pot);
+            int64_t pot_us = (int64_t)(next_pot*1e6);
+            for(int side = 0; side < 2; side++)
+            {
+                double angle = round((pose.hip[side] + BENCH_POT_NOISE*normal(random))/BENCH_ADC_LSB)*BENCH_ADC_LSB;
+                if(!estimators[side].isStarted())
+                {
+                    estimators[side].start(angle, pot_us);
+                }
+                estimators[side].predict(pot_us);
+                estimators[side].updatePot(angle);
+            }
+            next_pot += 1.0/BENCH_POT_FREQ;
+        }
+
+        // The estimates are extrapolated to the IMU sample, where main.cpp runs the detector
+        float angles[2], velocities[2];
+        for(int side = 0; side < 2; side++)
+        {
+            estimators[side].predict((int64_t)(t*1e6));
+            angles[side] = estimators[side].getAngle();
+            velocities[side] = estimators[side].getVelocity();
+        }
+
+        int nb_events = detector.update((int64_t)(t*1e6), angles, velocities);
+        for(int i = 0; i < nb_events; i++)
+        {
+            const GaitEvent &event = detector.getEvent(i);
+            double event_t = event.timestamp_us/1e6;
+            TruthEvent *best = NULL;
+            for(TruthEvent &candidate : truth)
+            {
+                if(!candidate.matched && candidate.side == event.side && candidate.kind == event.kind
+                    && fabs(candidate.t - event_t) < BENCH_MATCH && (best == NULL || fabs(candidate.t - event_t) < fabs(best->t - event_t)))
+                {
+                    best = &candidate;
+                }
+            }
+            if(event.detected_us - event.timestamp_us > latency_max_us)
+            {
+                latency_max_us = event.detected_us - event.timestamp_us;
+            }
+            if(best == NULL)
+            {
+                nb_false++;
+                printf("  false %s %s at %.3f s, %.1f deg\n", event.side ? "left" : "right",
+                    (event.kind == GAIT_HEEL_STRIKE) ? "heel strike" : "toe-off", event_t, event.angle);
+                continue;
+            }
+            best->matched = true;
+            if(best->steady)
+            {
+                double error = fabs(best->t - event_t);
+                error_sum += error;
+                error_max = (error > error_max) ? error : error_max;
+                nb_matched++;
+            }
+        }
+
+        // Cadence at the end of the steady part of each walk
+        Pose pose = motion(t);
+        Pose next = motion(t + dt);
+        const Segment &segment = SEGMENTS[pose.segment];
+        if(segment.stride > 0.0 && pose.steady && !next.steady)
+        {
+            double truth_cadence = 120.0/segment.stride;
+            cadence_error[pose.segment] = fabs(detector.getCadence() - truth_cadence)/truth_cadence;
+        }
+    }
+
+    int nb_steady[BENCH_NB_SEGMENTS] = {0};
+    for(const TruthEvent &event : truth)
+    {
+        if(event.steady)
+        {
+            nb_steady[motion(event.t).segment]++;
+            nb_detected[motion(event.t).segment] += event.matched ? 1 : 0;
+        }
+    }
+
+    bool passed = (nb_false == 0) && (error_max < BENCH_MAX_ERROR);
+    printf("Synthetic gait, %.0f s:\n", duration);
+    for(int s = 0; s < BENCH_NB_SEGMENTS; s++)
+    {
+        if(SEGMENTS[s].stride > 0.0)
+        {
+            double share = nb_steady[s] ? (double)nb_detected[s]/nb_steady[s] : 0.0;
+            printf("  %-12s stride %.1f s: %d/%d events detected, cadence error %.1f%%\n",
+                SEGMENTS[s].name, SEGMENTS[s].stride, nb_detected[s], nb_steady[s], 100*cadence_error[s]);
+            passed = passed && share >= BENCH_MIN_DETECTED && cadence_error[s] < BENCH_MAX_CADENCE_ERROR;
+        }
+    }
+    printf("  timing error %.1f ms mean, %.1f ms worst, detected %.1f ms at most after the extremum\n",
+        1000*error_sum/(nb_matched ? nb_matched : 1), 1000*error_max, latency_max_us/1000.0);
+    printf("  %d false events (standing, squats, walk starts and stops included)\n", nb_false);
+    return passed ? 0 : 1;
+}
+
+/**
+ * @brief Time of one detector update on a walk
+ *
+ */
+void benchmark()
+{
+    const int nb_updates = 1 << 20;
+    GaitDetector detector;
+    int nb_events = 0;
+
+    auto start = chrono::steady_clock::now();
+    for(int n = 1; n <= nb_updates; n++)
+    {
+        float phase = n*(2*3.14159265f/(1.1f*BENCH_IMU_FREQ));
+        float angles[2] = {10.0f + 20.0f*cosf(phase), 10.0f - 20.0f*cosf(phase)};
+        float velocities[2] = {-20.0f*sinf(phase)*100.0f, 20.0f*sinf(phase)*100.0f};
+        nb_events += detector.update((int64_t)n*2404, angles, velocities);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/nb_updates;
+    printf("%.1f ns per update on the host (%d events, cadence %.1f steps/min)\n", ns, nb_events, detector.getCadence());
+}
+
+int main()
+{
+    int result = checkSynthetic();
+    benchmark();
+    if(result != 0)
+    {
+        printf("FAILED\n");
+    }
+    return result;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file HipEstimatorBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host accuracy check of HipEstimator against the potentiometer alone with numeric differentiation
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build, or alone:
+ *   g++ -std=c++17 -O2 -I.. HipEstimatorBench.cpp ../HipEstimator.cpp ../SensorTrace.cpp -o hip_estimator_bench
+ *   ./hip_estimator_bench [trace.bin]
+ * Without argument the motion is synthetic and the truth is known. A binary trace (fmt trace) is replayed instead,
+ * there is no truth then: the angle is compared to the potentiometer and the noise of each derivative is measured
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "HipEstimator.hpp"
+#include "SensorTrace.hpp"
+
+using namespace std;
+
+const double BENCH_IMU_FREQ = 416.0;        //imu_freq of main.cpp
+const double BENCH_POT_FREQ = 200.0;        //pot_freq of main.cpp
+const double BENCH_DURATION = 90.0;         //[s]
+const double BENCH_POT_NOISE = 0.5;         //[deg]
+const double BENCH_GYRO_NOISE = 0.07;       //LSM6DSL at 416 Hz [dps]
+const double BENCH_GYRO_LSB = 0.00875;      //250 dps full scale [dps/LSB]
+const double BENCH_ADC_LSB = 255.0/65535.0; //ACTIVE_ANGLE over the ADC range [deg/LSB]
+const double BENCH_PI = 3.14159265358979;
+const double BENCH_VELOCITY_FACTOR = 5.0;       //Pass limits, per segment: the angle no worse than the potentiometer,
+const double BENCH_ACCELERATION_FACTOR = 50.0;  //the derivatives this many times better than its differences
+const int BENCH_SEGMENTS = 3;
+const char *SEGMENT_NAMES[BENCH_SEGMENTS] = {"bending", "walking", "fast lifts"};
+
+// Trunk pitch and thigh angles of the synthetic motion, the hip is their difference
+struct Pose
+{
+    double trunk;               //[deg]
+    double thigh;
+};
+
+/**
+ * @brief 30 s of bending with still thighs, 30 s of walking, 30 s of fast lifts with squats
+ *
+ */
+Pose motion(double t, int &segment)
+{
+    Pose pose;
+    if(t < 30.0)
+    {
+        segment = 0;
+        pose.trunk = 25.0*(1.0 - cos(2.0*BENCH_PI*t/5.0)) + 3.0*sin(2.0*BENCH_PI*0.7*t);
+        pose.thigh = 2.0*sin(2.0*BENCH_PI*0.2*t);
+    }
+    else if(t < 60.0)
+    {
+        segment = 1;
+        pose.trunk = 4.0*sin(2.0*BENCH_PI*1.8*t);
+        pose.thigh = 22.0*sin(2.0*BENCH_PI*0.9*t);
+    }
+    else
+    {
+        segment = 2;
+        double phase = fmod(t, 2.5)/2.5;
+        double lift = (phase < 0.5) ? 0.5*(1.0 - cos(4.0*BENCH_PI*phase)) : 0.0;
+        pose.trunk = 60.0*lift + 2.0*sin(2.0*BENCH_PI*2.3*t);
+        pose.thigh = -25.0*lift;
+    }
+    return pose;
+}
+
+struct Errors
+{
+    double angle[BENCH_SEGMENTS];
+    double velocity[BENCH_SEGMENTS];
+    double acceleration[BENCH_SEGMENTS];
+    int nb[BENCH_SEGMENTS];
+
+    Errors()
+    {
+        for(int i = 0; i < BENCH_SEGMENTS; i++)
+        {
+            angle[i] = velocity[i] = acceleration[i] = 0;
+            nb[i] = 0;
+        }
+    }
+
+    void add(int segment, double d_angle, double d_velocity, double d_acceleration)
+    {
+        angle[segment] += d_angle*d_angle;
+        velocity[segment] += d_velocity*d_velocity;
+        acceleration[segment] += d_acceleration*d_acceleration;
+        nb[segment]++;
+    }
+
+    double rmsAngle(int segment) const
+    {
+        return sqrt(angle[segment]/nb[segment]);
+    }
+
+    double rmsVelocity(int segment) const
+    {
+        return sqrt(velocity[segment]/nb[segment]);
+    }
+
+    double rmsAcceleration(int segment) const
+    {
+        return sqrt(acceleration[segment]/nb[segment]);
+    }
+
+    void display(const char *name) const
+    {
+        for(int i = 0; i < BENCH_SEGMENTS; i++)
+        {
+            printf("  %-22s %-10s angle %6.2f deg, velocity %7.2f deg/s, acceleration %8.1f deg/s2\n",
+                name, SEGMENT_NAMES[i], rmsAngle(i), rmsVelocity(i), rmsAcceleration(i));
+        }
+    }
+};
+
+/**
+ * @brief Synthetic motion with a known truth. The potentiometer loses contact for 50 ms every 7 s,
+ * the gyroscope bias starts at 1.5 dps and drifts
+ *
+ * @return number of segments where the estimator doesn't beat the potentiometer
+ */
+int checkSynthetic()
+{
+    mt19937 random(1);
+    normal_distribution<double> normal(0.0, 1.0);
+    const double dt = 1.0/BENCH_IMU_FREQ;
+    const double h = 1e-4;
+
+    HipEstimator estimator;
+    Errors fused;
+    Errors differentiated;
+    double bias = 1.5;
+    double next_pot = 0.0;
+    double pots[3] = {0, 0, 0};     //Last three potentiometer angles, for the backward differences
+    int nb_pots = 0;
+
+    for(int n = 0; n*dt < BENCH_DURATION; n++)
+    {
+        double t = n*dt;
+        int segment;
+
+        // Potentiometer at its own rate, before the IMU sample of the same tick as in main.cpp
+        if(t >= next_pot)
+        {
+            Pose pose = motion(next_pot, segment);
+            double angle = pose.trunk - pose.thigh + BENCH_POT_NOISE*normal(random);
+            if(fmod(next_pot, 7.0) < 0.05)
+            {
+                angle = 255.0;      //Wiper off the membrane, the ADC reads 0
+            }
+            angle = round(angle/BENCH_ADC_LSB)*BENCH_ADC_LSB;
+            int64_t pot_us = (int64_t)(next_pot*1e6);
+
+            if(!estimator.isStarted())
+            {
+                estimator.start(angle, pot_us);
+            }
+            estimator.predict(pot_us);
+            estimator.updatePot(angle);
+
+            pots[2] = pots[1];
+            pots[1] = pots[0];
+            pots[0] = angle;
+            nb_pots++;
+            next_pot += 1.0/BENCH_POT_FREQ;
+        }
+
+        // Gyroscope: trunk pitch rate, bias, noise, quantization
+        Pose before = motion(t - h, segment);
+        Pose after = motion(t + h, segment);
+        Pose now = motion(t, segment);
+        double trunk_rate = (after.trunk - before.trunk)/(2*h);
+        bias += 0.02*sqrt(dt)*normal(random);
+        double rate = round((trunk_rate + bias + BENCH_GYRO_NOISE*normal(random))/BENCH_GYRO_LSB)*BENCH_GYRO_LSB;
+        estimator.predict((int64_t)(t*1e6));
+        estimator.updateGyro(rate);
+
+        // Out of the scores: the first second of each segment, the motion jumps there, and the potentiometer
+        // dropouts with the next 3 samples
+        if(fmod(t, 30.0) < 1.0 || nb_pots < 3 || fmod(t, 7.0) < 0.07)
+        {
+            continue;
+        }
+        double angle = now.trunk - now.thigh;
+        double velocity = ((after.trunk - after.thigh) - (before.trunk - before.thigh))/(2*h);
+        double acceleration = ((after.trunk - after.thigh) - 2*angle + (before.trunk - before.thigh))/(h*h);
+
+        fused.add(segment, estimator.getAngle() - angle, estimator.getVelocity() - velocity, estimator.getAcceleration() - acceleration);
+        differentiated.add(segment, pots[0] - angle,
+            (pots[0] - pots[1])*BENCH_POT_FREQ - velocity,
+            (pots[0] - 2*pots[1] + pots[2])*BENCH_POT_FREQ*BENCH_POT_FREQ - acceleration);
+    }
+
+    printf("Synthetic motion, RMS errors against the truth:\n");
+    differentiated.display("potentiometer, diff:");
+    fused.display("estimator:");
+    printf("  gyroscope bias %.2f dps, estimated %.2f dps, %lu potentiometer samples rejected\n",
+        bias, estimator.getGyroBias(), (unsigned long)estimator.getRejected());
+
+    int nb_failed = 0;
+    for(int i = 0; i < BENCH_SEGMENTS; i++)
+    {
+        double angle_ratio = fused.rmsAngle(i)/differentiated.rmsAngle(i);
+        double velocity_ratio = differentiated.rmsVelocity(i)/fused.rmsVelocity(i);
+        double acceleration_ratio = differentiated.rmsAcceleration(i)/fused.rmsAcceleration(i);
+        bool passed = angle_ratio <= 1.0 && velocity_ratio >= BENCH_VELOCITY_FACTOR && acceleration_ratio >= BENCH_ACCELERATION_FACTOR;
+        printf("  %-10s angle %.2f of the potentiometer, velocity %.1fx and acceleration %.0fx better than its differences: %s\n",
+            SEGMENT_NAMES[i], angle_ratio, velocity_ratio, acceleration_ratio, passed ? "ok" : "FAILED");
+        if(!passed)
+        {
+            nb_failed++;
+        }
+    }
+    return nb_failed;
+}
+
+/**
+ * @brief Recorded trace: no truth, the estimator is compared to the potentiometer angle and the roughness of each
+ * velocity is its RMS change from one output tick to the next
+ *
+ * @param path
+ * @return 0, or 1 if the file can't be read
+ */
+int checkTrace(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if(file == NULL)
+    {
+        printf("Can't open %s\n", path);
+        return 1;
+    }
+
+    SensorTrace trace;
+    HipEstimator estimators[2];
+    double last_pot[2] = {0, 0};
+    double last_fused_velocity[2] = {0, 0};
+    double last_diff_velocity[2] = {0, 0};
+    double residual[2] = {0, 0};
+    double fused_roughness[2] = {0, 0};
+    double diff_roughness[2] = {0, 0};
+    int nb = 0;
+    uint32_t last_pot_us = 0;
+    bool header = false;
+    int c;
+
+    while ((c = fgetc(file)) != EOF) {
+        TraceFrameType type = trace.push((uint8_t)c);
+        if(type == TRACE_HEADER)
+        {
+            header = true;
+        }
+        if(type != TRACE_SAMPLE || !header)
+        {
+            continue;
+        }
+
+        const TraceHeader &h = trace.getHeader();
+        const TraceSample &s = trace.getSample();
+        uint32_t imu_us = s.timestamp_us - s.imu_age_us;
+        uint32_t pot_us = s.timestamp_us - s.pot_age_us;
+        uint16_t raw[2] = {s.pot_right, s.pot_left};
+        // Pitch rate on the default axis of main.cpp, Y
+        double rate = (s.gyro[1]*h.gyro_sensitivity - h.gyr_offset[1])/1000.0;
+        bool new_pot = (pot_us != last_pot_us);
+
+        for(int side = 0; side < 2; side++)
+        {
+            // As PotentiometerSensor::offsetAngle()
+            double angle = (h.pot_offset[side] - raw[side])*255.0/65535.0;
+            if(!estimators[side].isStarted())
+            {
+                estimators[side].start(angle, pot_us);
+            }
+            if(new_pot)
+            {
+                estimators[side].predict(pot_us);
+                estimators[side].updatePot(angle);
+            }
+            estimators[side].predict(imu_us);
+            estimators[side].updateGyro(rate);
+
+            double fused_velocity = estimators[side].getVelocity();
+            double diff_velocity = (angle - last_pot[side])*h.sampling_freq;
+            if(nb > 1)
+            {
+                residual[side] += (estimators[side].getAngle() - angle)*(estimators[side].getAngle() - angle);
+                fused_roughness[side] += (fused_velocity - last_fused_velocity[side])*(fused_velocity - last_fused_velocity[side]);
+                diff_roughness[side] += (diff_velocity - last_diff_velocity[side])*(diff_velocity - last_diff_velocity[side]);
+            }
+            last_pot[side] = angle;
+            last_fused_velocity[side] = fused_velocity;
+            last_diff_velocity[side] = diff_velocity;
+        }
+        last_pot_us = pot_us;
+        nb++;
+    }
+    fclose(file);
+
+    printf("Trace %s, %d samples:\n", path, nb);
+    for(int side = 0; side < 2; side++)
+    {
+        int n = (nb > 2) ? nb - 2 : 1;
+        printf("  %s: estimator - potentiometer %.2f deg RMS, velocity change per tick %.2f deg/s RMS (diff %.2f), %lu rejected\n",
+            (side == 0) ? "right" : "left",
+            sqrt(residual[side]/n), sqrt(fused_roughness[side]/n), sqrt(diff_roughness[side]/n),
+            (unsigned long)estimators[side].getRejected());
+    }
+    return 0;
+}
+
+/**
+ * @brief Time of one IMU update, prediction and gyroscope, plus one potentiometer update every other sample
+ *
+ */
+void benchmark()
+{
+    const int nb_updates = 1 << 20;
+    HipEstimator estimator;
+    estimator.start(10.0f, 0);
+
+    auto start = chrono::steady_clock::now();
+    for(int n = 1; n <= nb_updates; n++)
+    {
+        estimator.predict((int64_t)n*2404);
+        estimator.updateGyro(0.5f*sinf(n*0.01f));
+        if(n % 2 == 0)
+        {
+            estimator.updatePot(10.0f + sinf(n*0.01f));
+        }
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/nb_updates;
+    printf("%.1f ns per IMU update on the host (angle %.2f)\n", ns, estimator.getAngle());
+}
+
+int main(int argc, char **argv)
+{
+    if(argc > 1)
+    {
+        return checkTrace(argv[1]);
+    }
+
+    int nb_failed = checkSynthetic();
+    benchmark();
+
+    if(nb_failed > 0)
+    {
+        printf("FAILED, %d segments\n", nb_failed);
+        return 1;
+    }
+    return 0;
+}
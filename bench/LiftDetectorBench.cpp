@@ -0,0 +1,222 @@
+/**
+ * @file LiftDetectorBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check of TrunkPitch and LiftDetector on a scripted sequence of bend and lift cycles
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build, or alone:
+ *   g++ -std=c++17 -O2 -I.. LiftDetectorBench.cpp ../LiftDetector.cpp ../TrunkPitch.cpp -o lift_detector_bench
+ *   ./lift_detector_bench
+ * The IMU is simulated at imu_freq on the default hip-gyro-axis, the trunk pitch goes through TrunkPitch as in main.cpp.
+ * Each cycle bends the trunk and the hips together along a raised cosine, the rods give a torque proportional to the hip angle
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "LiftDetector.hpp"
+#include "TrunkPitch.hpp"
+
+using namespace std;
+
+const double BENCH_IMU_FREQ = 416.0;        //imu_freq of main.cpp
+const double BENCH_GYRO_NOISE = 0.07;       //[dps]
+const double BENCH_GYRO_BIAS = 0.5;         //Left after the calibration [dps]
+const double BENCH_ACC_NOISE = 3.0;         //[mg]
+const double BENCH_STANDING = 2.0;          //Between two cycles [s]
+const double BENCH_TORQUE_PER_DEG = 0.3;    //Rods [Nm/deg]
+const double BENCH_GAP = 0.2;               //Samples missing in the gap cycle, around its peak [s]
+const double BENCH_MAX_PEAK_ERROR = 1.5;    //Pass limits: trunk flexion through TrunkPitch [deg]
+const double BENCH_MAX_TIME_ERROR = 0.05;   //Start and end of a cycle [s]
+const double BENCH_MAX_WORK_ERROR = 0.02;   //Relative
+const double BENCH_PI = 3.14159265358979;
+
+/**
+ * @brief One scripted cycle, a raised cosine on the trunk and on the mean hip angle
+ */
+struct Cycle
+{
+    const char *name;
+    double duration;            //[s]
+    double flexion;             //Peak trunk pitch [deg]
+    double hip;                 //Peak hip angle [deg]
+    bool touch;                 //Load held
+    bool gap;                   //BENCH_GAP without samples around the peak
+    bool reported;              //What the detector must do with it
+};
+
+const Cycle CYCLES[] = {
+    {"bend 60/70", 2.0, 60.0, 70.0, false, false, true},
+    {"bend 60/70", 2.0, 60.0, 70.0, false, false, true},
+    {"bend 60/70", 2.0, 60.0, 70.0, false, false, true},
+    {"carry 60/70", 2.0, 60.0, 70.0, true, false, true},
+    {"carry 60/70", 2.0, 60.0, 70.0, true, false, true},
+    {"short 0.6 s", 0.6, 60.0, 70.0, false, false, false},      //About 0.4 s above the start angles
+    {"shallow 28 deg", 2.0, 28.0, 40.0, false, false, false},
+    {"gap at the peak", 2.0, 60.0, 70.0, false, true, false},
+    {"bend 60/70", 2.0, 60.0, 70.0, false, false, true},
+};
+const int BENCH_NB_CYCLES = sizeof(CYCLES)/sizeof(CYCLES[0]);
+
+/**
+ * @brief Time into a cycle when its shape crosses level on the way up, or on the way down
+ *
+ * @param duration [s]
+ * @param level share of the peak, in ]0; 1[
+ * @param down
+ * @return [s]
+ */
+double crossing(double duration, double level, bool down)
+{
+    double t = duration*acos(1.0 - 2.0*level)/(2.0*BENCH_PI);
+    return down ? duration - t : t;
+}
+
+/**
+ * @brief Runs the sequence and compares every summary to the script
+ *
+ * @return number of failed checks
+ */
+int checkScript()
+{
+    mt19937 random(1);
+    normal_distribution<double> normal(0.0, 1.0);
+    const double dt = 1.0/BENCH_IMU_FREQ;
+
+    TrunkPitch trunk(1, 1);
+    LiftDetector lifts;
+    int nb_failed = 0;
+    uint32_t expected_index = 0;
+    double cycle_start = BENCH_STANDING;
+
+    for(int i = 0; i < BENCH_NB_CYCLES; i++)
+    {
+        const Cycle &cycle = CYCLES[i];
+        double end = cycle_start + cycle.duration + BENCH_STANDING;
+        double gap_start = cycle_start + 0.5*(cycle.duration - BENCH_GAP);
+        int nb_reported = 0;
+        LiftEvent event = {};
+
+        for(double t = (i == 0) ? 0.0 : cycle_start - BENCH_STANDING + dt; t < end; t += dt)
+        {
+            if(cycle.gap && t >= gap_start && t < gap_start + BENCH_GAP)
+            {
+                continue;
+            }
+
+            double phase = (t - cycle_start)/cycle.duration;
+            double shape = (phase > 0.0 && phase < 1.0) ? 0.5*(1.0 - cos(2.0*BENCH_PI*phase)) : 0.0;
+            double rate = (phase > 0.0 && phase < 1.0) ? cycle.flexion*BENCH_PI/cycle.duration*sin(2.0*BENCH_PI*phase) : 0.0;
+            double pitch = cycle.flexion*shape*BENCH_PI/180.0;
+
+            // Pitch around Y: the tilt TrunkPitch reads is atan2(-x, z)
+            int32_t acc[3] = {
+                (int32_t)lround(-1000.0*sin(pitch) + BENCH_ACC_NOISE*normal(random)),
+                (int32_t)lround(BENCH_ACC_NOISE*normal(random)),
+                (int32_t)lround(1000.0*cos(pitch) + BENCH_ACC_NOISE*normal(random)),
+            };
+            int64_t timestamp_us = (int64_t)(t*1e6);
+            trunk.update(acc, (float)(rate + BENCH_GYRO_BIAS + BENCH_GYRO_NOISE*normal(random)), timestamp_us);
+
+            float hip = (float)(cycle.hip*shape);
+            const float hips[2] = {hip, hip};
+            bool touch = cycle.touch && shape > 0.5;
+            if(lifts.update(timestamp_us, trunk.getPitch(), hips, (float)(BENCH_TORQUE_PER_DEG*hip), touch))
+            {
+                event = lifts.getEvent();
+                nb_reported++;
+            }
+        }
+
+        bool ok = (nb_reported == (cycle.reported ? 1 : 0));
+        if(cycle.reported && nb_reported == 1)
+        {
+            // Starts with the trunk and the hips past their angles, ends with the trunk back under LIFT_END_FLEXION
+            double start_level = fmax(LIFT_START_FLEXION/cycle.flexion, LIFT_START_HIP/cycle.hip);
+            double start = cycle_start + crossing(cycle.duration, start_level, false);
+            double stop = cycle_start + crossing(cycle.duration, LIFT_END_FLEXION/cycle.flexion, true);
+
+            // The rods give back the work from the peak to the hip angle at the end of the cycle
+            double phase = (event.end_us*1e-6 - cycle_start)/cycle.duration;
+            double hip_end = cycle.hip*0.5*(1.0 - cos(2.0*BENCH_PI*phase));
+            double work = 0.5*BENCH_TORQUE_PER_DEG*(cycle.hip*cycle.hip - hip_end*hip_end)*BENCH_PI/180.0;
+
+            expected_index++;
+            ok = event.index == expected_index
+                && event.kind == (cycle.touch ? LIFT_CARRY : LIFT_BEND)
+                && fabs(event.start_us*1e-6 - start) <= BENCH_MAX_TIME_ERROR
+                && fabs(event.end_us*1e-6 - stop) <= BENCH_MAX_TIME_ERROR
+                && fabs(event.peak_flexion - cycle.flexion) <= BENCH_MAX_PEAK_ERROR
+                && fabs(event.peak_hip - cycle.hip) <= 0.01
+                && fabs(event.peak_torque - BENCH_TORQUE_PER_DEG*cycle.hip) <= 0.01
+                && fabs(event.work - work) <= BENCH_MAX_WORK_ERROR*work;
+            printf("  %-16s #%lu %-5s %5.2f-%5.2f s (%5.2f-%5.2f), flexion %5.1f deg, hip %5.1f deg, torque %4.1f Nm, work %5.2f J (%5.2f): %s\n",
+                cycle.name, (unsigned long)event.index, (event.kind == LIFT_CARRY) ? "carry" : "bend",
+                event.start_us*1e-6, event.end_us*1e-6, start, stop,
+                event.peak_flexion, event.peak_hip, event.peak_torque, event.work, work, ok ? "ok" : "FAILED");
+        }
+        else
+        {
+            printf("  %-16s %d reported, %s expected: %s\n", cycle.name, nb_reported, cycle.reported ? "1" : "none", ok ? "ok" : "FAILED");
+        }
+
+        if(!ok)
+        {
+            nb_failed++;
+        }
+        cycle_start = end;
+    }
+
+    if(lifts.getCount() != expected_index)
+    {
+        printf("  %lu cycles counted, %lu expected: FAILED\n", (unsigned long)lifts.getCount(), (unsigned long)expected_index);
+        nb_failed++;
+    }
+    return nb_failed;
+}
+
+/**
+ * @brief Time of one IMU sample through TrunkPitch and LiftDetector
+ *
+ */
+void benchmark()
+{
+    const int nb_updates = 1 << 20;
+    TrunkPitch trunk(1, 1);
+    LiftDetector lifts;
+    uint32_t nb_events = 0;
+
+    auto start = chrono::steady_clock::now();
+    for(int n = 1; n <= nb_updates; n++)
+    {
+        // One 60/70 cycle every 5 s
+        float phase = n*0.003f;
+        float shape = 0.5f*(1.0f - cosf(phase));
+        float pitch = 60.0f*shape*(float)BENCH_PI/180.0f;
+        int32_t acc[3] = {(int32_t)(-1000.0f*sinf(pitch)), 0, (int32_t)(1000.0f*cosf(pitch))};
+        const float hips[2] = {70.0f*shape, 70.0f*shape};
+        trunk.update(acc, 30.0f*0.003f*sinf(phase)*(float)BENCH_IMU_FREQ, (int64_t)n*2404);
+        nb_events += lifts.update((int64_t)n*2404, trunk.getPitch(), hips, 21.0f*shape, false);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/nb_updates;
+    printf("%.1f ns per IMU sample on the host (%lu cycles)\n", ns, (unsigned long)nb_events);
+}
+
+int main()
+{
+    printf("Scripted cycles, %.0f Hz:\n", BENCH_IMU_FREQ);
+    int nb_failed = checkScript();
+    benchmark();
+
+    if(nb_failed > 0)
+    {
+        printf("FAILED, %d checks\n", nb_failed);
+        return 1;
+    }
+    return 0;
+}
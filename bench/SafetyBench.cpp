@@ -0,0 +1,180 @@
+/**
+ * @file SafetyBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check of SafetyMonitor against the LSM6DSL model, on the synthetic walk and on a recorded fall
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build only, the monitor talks to the model through the mbed shim of host/:
+ *   cmake --build build --target safety_bench && ./build/safety_bench [motion.csv]
+ * The recording defaults to bench/fall_motion.csv: walking, a free fall from 7.000 s to 7.350 s then an impact until
+ * 7.370 s, in a 10 s loop. Every fall and impact must come out once, in time, and the walks must give no event
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "mbed.h"
+#include "HostTime.hpp"
+#include "LSM6DSLModel.hpp"
+#include "SafetyMonitor.hpp"
+
+using namespace std;
+
+const int64_t BENCH_WALK_US = 30000000;         //Synthetic walk, no event expected
+const int64_t BENCH_LOOP_US = 10000000;         //Of the recording
+const int BENCH_NB_LOOPS = 3;
+const int64_t BENCH_FALL_US = 7000000;          //Start of the free fall in the loop
+const int64_t BENCH_IMPACT_US = 7350000;
+const int64_t BENCH_FALL_DELAY_US = 30000;      //Pass limits: FF_DUR is 6 samples, 14 ms at 416 Hz
+const int64_t BENCH_IMPACT_DELAY_US = 10000;    //A few samples
+const int BENCH_MAX_EVENTS = 64;
+
+namespace
+{
+    LSM6DSLModel s_model(0xD4, PD_11, PD_12);
+    DevI2C s_i2c(PB_11, PB_10);
+    LSM6DSLSensor s_imu(&s_i2c, LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, PD_11);
+    SafetyMonitor s_safety(s_imu);
+    Timer s_clock;
+    Thread s_thread(osPriorityAboveNormal, 4096, NULL, "safety");
+
+    // Written by the safety thread only
+    SafetyEvent s_events[BENCH_MAX_EVENTS];
+    volatile int s_nb_events = 0;
+
+    void safetyRun()
+    {
+        while (1) {
+            SafetyEvent event;
+            s_safety.wait(event);
+            if(s_nb_events < BENCH_MAX_EVENTS)
+            {
+                s_events[s_nb_events] = event;
+                s_nb_events = s_nb_events + 1;
+            }
+        }
+    }
+
+    const char *kindName(SafetyEventKind kind)
+    {
+        const char *names[SAFETY_NB_KINDS] = {"fall", "impact", "unknown"};
+        return names[kind];
+    }
+}
+
+/**
+ * @brief The synthetic walk of the model, two steps a second, must give no event
+ *
+ * @return number of failed checks
+ */
+int checkWalk()
+{
+    printf("Synthetic walk, %lld s:\n", (long long)(BENCH_WALK_US/1000000));
+    int first = s_nb_events;
+    host::advance(BENCH_WALK_US);
+
+    for(int i = first; i < s_nb_events; i++)
+    {
+        printf("  false %s at %lld ms\n", kindName(s_events[i].kind), (long long)(s_events[i].irq_us/1000));
+    }
+    bool ok = s_nb_events == first;
+    printf("  %d events: %s\n", s_nb_events - first, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Plays the recording BENCH_NB_LOOPS times, each fall and each impact must be reported once and in time,
+ * the walk around them must give nothing else
+ *
+ * @param path
+ * @return number of failed checks
+ */
+int checkFall(const char *path)
+{
+    printf("Recorded fall, %s:\n", path);
+    if(!s_model.loadMotion(path))
+    {
+        printf("  FAILED, no motion\n");
+        return 1;
+    }
+
+    //The recording plays from a multiple of its length on the virtual clock, the clock of the monitor is behind
+    int64_t start_us = ((host::now() + BENCH_LOOP_US - 1)/BENCH_LOOP_US)*BENCH_LOOP_US;
+    host::advance(start_us - host::now());
+    int64_t offset_us = host::now() - s_clock.elapsed_time().count();
+    int first = s_nb_events;
+    host::advance(BENCH_NB_LOOPS*BENCH_LOOP_US);
+
+    int nb_failed = 0;
+    int nb_found[BENCH_NB_LOOPS][2] = {};
+    if(s_nb_events == BENCH_MAX_EVENTS)
+    {
+        printf("  over %d events in all: FAILED\n", BENCH_MAX_EVENTS);
+        nb_failed++;
+    }
+    for(int i = first; i < s_nb_events; i++)
+    {
+        const SafetyEvent &event = s_events[i];
+        int64_t t_us = event.irq_us + offset_us - start_us;
+        int loop = (int)(t_us/BENCH_LOOP_US);
+        int64_t in_loop_us = t_us - loop*BENCH_LOOP_US;
+
+        bool fall = event.kind == SAFETY_FALL && in_loop_us >= BENCH_FALL_US && in_loop_us <= BENCH_FALL_US + BENCH_FALL_DELAY_US;
+        bool impact = event.kind == SAFETY_IMPACT && in_loop_us >= BENCH_IMPACT_US && in_loop_us <= BENCH_IMPACT_US + BENCH_IMPACT_DELAY_US;
+        if(fall || impact)
+        {
+            nb_found[loop][impact ? 1 : 0]++;
+        }
+        else
+        {
+            nb_failed++;
+        }
+        printf("  #%lu %-7s loop %d at %7.3f s, source read after %4lld us: %s\n",
+            (unsigned long)event.index, kindName(event.kind), loop, in_loop_us*1e-6,
+            (long long)(event.source_us - event.irq_us), (fall || impact) ? "ok" : "FAILED, not expected");
+    }
+
+    for(int loop = 0; loop < BENCH_NB_LOOPS; loop++)
+    {
+        for(int kind = 0; kind < 2; kind++)
+        {
+            if(nb_found[loop][kind] != 1)
+            {
+                printf("  loop %d: %s reported %d times: FAILED\n", loop, kindName((SafetyEventKind)kind), nb_found[loop][kind]);
+                nb_failed++;
+            }
+        }
+    }
+    return nb_failed;
+}
+
+int main(int argc, char **argv)
+{
+    host::setDefaultRunLimit(0);
+    host::addTimeListener([](int64_t now_us){ s_model.update(now_us); });
+
+    //As main.cpp: the events first, they force the accelerometer settings, then the IMU settings
+    s_clock.start();
+    if(s_imu.init(NULL) != 0 || !s_safety.enable(s_clock, 2.0f) || s_imu.configure(416.0f, 2.0f, 250.0f) != 0)
+    {
+        printf("FAILED, no IMU\n");
+        return 1;
+    }
+    s_thread.start(safetyRun);
+
+    int nb_failed = checkWalk();
+    nb_failed += checkFall((argc > 1) ? argv[1] : BENCH_FALL_MOTION);
+    s_safety.display();
+
+    if(nb_failed > 0)
+    {
+        printf("FAILED, %d checks\n", nb_failed);
+    }
+
+    //The safety thread still waits on the clock of the shim, the statics must not be destroyed under it
+    fflush(stdout);
+    _exit((nb_failed > 0) ? 1 : 0);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file SampleQueueBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host stress test and throughput benchmark of SampleQueue
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build, sample_queue_tsan being the same stress run under ThreadSanitizer (HOST_TSAN option):
+ *   cmake --build build --target sample_queue_tsan && ./build/sample_queue_tsan 200000
+ * Throughput:
+ *   cmake --build build --target sample_queue_bench && ./build/sample_queue_bench
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "SampleQueue.hpp"
+
+using namespace std;
+
+// Same order of size as the output record of the firmware
+struct BenchRecord
+{
+    uint32_t sequence;
+    uint32_t payload[31];   //Every word holds the sequence, a torn copy shows up as a mismatch
+};
+
+const uint32_t BENCH_CAPACITY = 32;
+
+/**
+ * @brief One producer and one consumer. Flat out the producer overflows the queue and the policy is exercised,
+ * paced it waits for room and nothing is dropped
+ *
+ * @param policy
+ * @param nb_items
+ * @param paced
+ * @return true if every record popped was complete and in order, and every record is accounted for
+ */
+bool run(OverflowPolicy policy, uint32_t nb_items, bool paced)
+{
+    unique_ptr<SampleQueue<BenchRecord, BENCH_CAPACITY>> owner(new SampleQueue<BenchRecord, BENCH_CAPACITY>(policy));
+    SampleQueue<BenchRecord, BENCH_CAPACITY> &queue = *owner;
+
+    atomic<bool> done(false);
+    bool ok = true;
+    uint32_t nb_popped = 0;
+
+    auto start = chrono::steady_clock::now();
+
+    thread consumer([&]() {
+        BenchRecord record;
+        uint32_t last = 0;
+        bool first = true;
+        while (1) {
+            if(!queue.pop(record))
+            {
+                if(done.load()) break;
+                this_thread::yield();
+                continue;
+            }
+            for(int i = 0; i < 31; i++)
+            {
+                if(record.payload[i] != record.sequence) ok = false;
+            }
+            if(!first && record.sequence <= last) ok = false;
+            first = false;
+            last = record.sequence;
+            nb_popped++;
+        }
+    });
+
+    BenchRecord record;
+    for(uint32_t n = 0; n < nb_items; n++)
+    {
+        record.sequence = n;
+        for(int i = 0; i < 31; i++) record.payload[i] = n;
+        while (paced && queue.size() >= queue.capacity()) {
+            this_thread::yield();
+        }
+        queue.push(record);
+    }
+    done.store(true);
+    consumer.join();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%s %s: %u pushed, %u popped, %u dropped oldest, %u dropped newest, %.2f M records/s popped, %s\n",
+        (policy == DROP_OLDEST) ? "drop-oldest" : "drop-newest",
+        paced ? "paced" : "flat out",
+        nb_items, nb_popped,
+        queue.getDroppedOldest(), queue.getDroppedNewest(),
+        nb_popped/seconds/1e6,
+        ok ? "OK" : "CORRUPTED");
+
+    return ok && nb_popped + queue.getDroppedOldest() + queue.getDroppedNewest() == nb_items;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t nb_items = (argc > 1) ? (uint32_t)atoi(argv[1]) : 2000000;
+
+    bool ok = true;
+    ok = run(DROP_OLDEST, nb_items, false) && ok;
+    ok = run(DROP_NEWEST, nb_items, false) && ok;
+    ok = run(DROP_OLDEST, nb_items, true) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file ScalingBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check and benchmark of ScalingTable against the former map() path of the output
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build, or alone:
+ *   g++ -std=c++17 -O2 -I.. ScalingBench.cpp ../ScalingTable.cpp -o scaling_bench && ./scaling_bench
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "ScalingTable.hpp"
+
+using namespace std;
+
+const double BENCH_G0 = 9.812865328;    //g0 of main.cpp
+const float BENCH_RATIO = 100.0f;       //acc_ratio and gyr_ratio of main.cpp
+const int BENCH_NB_SAMPLES = 1 << 20;
+
+// Full scales and sensitivities of the LSM6DSL
+const float ACC_FS[4] = {2.0f, 4.0f, 8.0f, 16.0f};
+const float ACC_SENSITIVITY[4] = {0.061f, 0.122f, 0.244f, 0.488f};
+const float GYRO_FS[5] = {125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f};
+const float GYRO_SENSITIVITY[5] = {4.375f, 8.75f, 17.5f, 35.0f, 70.0f};
+
+// map() of PotentiometerSensor.cpp
+double map(double x, double in_min, double in_max, double out_min, double out_max)
+{
+    return ((double)x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// Former output path: register to integer mg or mdps in the sensor task, then map() in the output
+float referenceAcc(int16_t raw, float sensitivity, float fs)
+{
+    int32_t acc = (int32_t)(raw * sensitivity);
+    return map(acc, -fs*BENCH_G0*100.0f, fs*BENCH_G0*100.0f, -BENCH_RATIO, BENCH_RATIO);
+}
+
+float referenceGyro(int16_t raw, float sensitivity, float fs, float offset)
+{
+    int32_t gyro = (int32_t)(raw * sensitivity);
+    return map(gyro - offset, -fs*1000.0f, fs*1000.0f, -BENCH_RATIO, BENCH_RATIO);
+}
+
+float referencePot(uint16_t raw, float offset)
+{
+    return map(raw, 0.0f, offset, 100.0f, 0.0f);
+}
+
+/**
+ * @brief Every register value at every full scale, plus every ADC value
+ *
+ * @return worst difference, in LSB of the former path: 1 mg, 1 mdps, or one ADC step
+ */
+double checkAgreement()
+{
+    const float gyr_offset[3] = {-312.4f, 87.9f, 1021.6f};
+    const float pot_offset[2] = {41234.5f, 38765.25f};
+    double worst = 0;
+    int32_t raw[SCALE_NB_CHANNELS];
+    float out[SCALE_NB_CHANNELS];
+
+    for(int a = 0; a < 4; a++)
+    {
+        for(int g = 0; g < 5; g++)
+        {
+            ScalingTable table;
+            float acc_range = ACC_FS[a]*BENCH_G0*100.0f;
+            float gyro_range = GYRO_FS[g]*1000.0f;
+            table.setAccelerometer(ACC_SENSITIVITY[a], acc_range, BENCH_RATIO);
+            table.setGyroscope(GYRO_SENSITIVITY[g], gyro_range, BENCH_RATIO, gyr_offset);
+            table.setPotentiometers(pot_offset[0], pot_offset[1]);
+
+            double acc_lsb = BENCH_RATIO/acc_range;
+            double gyro_lsb = BENCH_RATIO/gyro_range;
+
+            for(int32_t value = -32768; value <= 32767; value++)
+            {
+                uint16_t adc = (uint16_t)(value + 32768);
+                for(int i = 0; i < 3; i++)
+                {
+                    raw[SCALE_ACC_X + i] = value;
+                    raw[SCALE_GYRO_X + i] = value;
+                }
+                raw[SCALE_POT_RIGHT] = adc;
+                raw[SCALE_POT_LEFT] = adc;
+                table.apply(raw, out);
+
+                for(int i = 0; i < 3; i++)
+                {
+                    double acc_error = fabs(out[SCALE_ACC_X + i] - referenceAcc(value, ACC_SENSITIVITY[a], ACC_FS[a]))/acc_lsb;
+                    double gyro_error = fabs(out[SCALE_GYRO_X + i] - referenceGyro(value, GYRO_SENSITIVITY[g], GYRO_FS[g], gyr_offset[i]))/gyro_lsb;
+                    worst = max(worst, max(acc_error, gyro_error));
+                }
+                for(int i = 0; i < 2; i++)
+                {
+                    double pot_lsb = 100.0/pot_offset[i];
+                    double pot_error = fabs(out[SCALE_POT_RIGHT + i] - referencePot(adc, pot_offset[i]))/pot_lsb;
+                    worst = max(worst, pot_error);
+                }
+            }
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief Time per sample of both paths, on the same random samples
+ *
+ */
+void benchmark()
+{
+    vector<int32_t> samples(BENCH_NB_SAMPLES*SCALE_NB_CHANNELS);
+    srand(1);
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+        samples[i] = (i % SCALE_NB_CHANNELS >= SCALE_POT_RIGHT) ? rand() % 65536 : rand() % 65536 - 32768;
+    }
+
+    const float gyr_offset[3] = {-312.4f, 87.9f, 1021.6f};
+    ScalingTable table;
+    table.setAccelerometer(0.061f, 2.0f*BENCH_G0*100.0f, BENCH_RATIO);
+    table.setGyroscope(8.75f, 250.0f*1000.0f, BENCH_RATIO, gyr_offset);
+    table.setPotentiometers(41234.5f, 38765.25f);
+
+    volatile float sink = 0;
+    float out[SCALE_NB_CHANNELS];
+
+    auto start = chrono::steady_clock::now();
+    for(int n = 0; n < BENCH_NB_SAMPLES; n++)
+    {
+        const int32_t *raw = &samples[n*SCALE_NB_CHANNELS];
+        float sum = 0;
+        for(int i = 0; i < 3; i++)
+        {
+            sum += referenceAcc(raw[SCALE_ACC_X + i], 0.061f, 2.0f);
+            sum += referenceGyro(raw[SCALE_GYRO_X + i], 8.75f, 250.0f, gyr_offset[i]);
+        }
+        sum += referencePot(raw[SCALE_POT_RIGHT], 41234.5f);
+        sum += referencePot(raw[SCALE_POT_LEFT], 38765.25f);
+        sink = sink + sum;
+    }
+    double map_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/BENCH_NB_SAMPLES;
+
+    start = chrono::steady_clock::now();
+    for(int n = 0; n < BENCH_NB_SAMPLES; n++)
+    {
+        table.apply(&samples[n*SCALE_NB_CHANNELS], out);
+        float sum = 0;
+        for(int i = 0; i < SCALE_NB_CHANNELS; i++)
+        {
+            sum += out[i];
+        }
+        sink = sink + sum;
+    }
+    double table_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/BENCH_NB_SAMPLES;
+
+    printf("map(): %.1f ns per sample, table: %.1f ns per sample, %.1fx\n", map_ns, table_ns, map_ns/table_ns);
+}
+
+int main(int argc, char **argv)
+{
+    double worst = checkAgreement();
+    printf("Worst difference with the map() path: %.3f LSB\n", worst);
+    benchmark();
+
+    if(worst > 1.0)
+    {
+        printf("FAILED, more than 1 LSB\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file SensorTraceBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check of the frames of SensorTrace: round trip, text between the frames, corrupted and cut frames
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build, or alone:
+ *   g++ -std=c++17 -O2 -I.. SensorTraceBench.cpp ../SensorTrace.cpp -o sensor_trace_bench && ./sensor_trace_bench
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "SensorTrace.hpp"
+
+using namespace std;
+
+namespace
+{
+    bool check(bool condition, const char *what)
+    {
+        printf("  %-64s %s\n", what, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    TraceHeader makeHeader()
+    {
+        TraceHeader header = {};
+        header.version = TRACE_VERSION;
+        header.channels = 0x3ff;
+        header.sampling_freq = 100.0f;
+        header.acc_sensitivity = 0.061f;
+        header.gyro_sensitivity = 8.75f;
+        header.gyr_offset[0] = -120.5f;
+        header.gyr_offset[1] = 310.25f;
+        header.gyr_offset[2] = 42.0f;
+        header.pot_offset[0] = 32894.2f;
+        header.pot_offset[1] = 32640.8f;
+        header.imu_freq = 416.0f;
+        return header;
+    }
+
+    // Sync bytes in the payload, so a false start is possible inside the frame
+    TraceSample makeSample(uint32_t n)
+    {
+        TraceSample sample = {};
+        sample.timestamp_us = 10000*n;
+        sample.imu_age_us = 1200;
+        sample.pot_age_us = (uint16_t)(0xA5A5 + n);
+        sample.touch_age_us = 65535;
+        for(int i = 0; i < 3; i++)
+        {
+            sample.acc[i] = (int16_t)(n*100 - 16000*i);
+            sample.gyro[i] = (int16_t)(0xA5 + i);
+        }
+        sample.pot_right = (uint16_t)(30000 + n);
+        sample.pot_left = 0xA553;
+        sample.touch = 512;
+        return sample;
+    }
+
+    // Field by field, the padding is not sent
+    bool sameSample(const TraceSample &a, const TraceSample &b)
+    {
+        bool same = a.timestamp_us == b.timestamp_us && a.imu_age_us == b.imu_age_us && a.pot_age_us == b.pot_age_us
+            && a.touch_age_us == b.touch_age_us && a.pot_right == b.pot_right && a.pot_left == b.pot_left && a.touch == b.touch;
+        for(int i = 0; i < 3; i++)
+        {
+            same = same && a.acc[i] == b.acc[i] && a.gyro[i] == b.gyro[i];
+        }
+        return same;
+    }
+
+    bool sameHeader(const TraceHeader &a, const TraceHeader &b)
+    {
+        return a.version == b.version && a.channels == b.channels && a.sampling_freq == b.sampling_freq
+            && a.acc_sensitivity == b.acc_sensitivity && a.gyro_sensitivity == b.gyro_sensitivity
+            && memcmp(a.gyr_offset, b.gyr_offset, sizeof(a.gyr_offset)) == 0
+            && memcmp(a.pot_offset, b.pot_offset, sizeof(a.pot_offset)) == 0 && a.imu_freq == b.imu_freq;
+    }
+
+    void appendSample(vector<uint8_t> &stream, const TraceSample &sample)
+    {
+        uint8_t frame[TRACE_MAX_FRAME];
+        int length = SensorTrace::encodeSample(sample, frame);
+        stream.insert(stream.end(), frame, frame + length);
+    }
+
+    /**
+     * @brief Decodes the whole stream
+     *
+     * @param stream
+     * @param trace
+     * @param samples decoded, in order
+     * @return number of headers decoded
+     */
+    int decodeStream(const vector<uint8_t> &stream, SensorTrace &trace, vector<TraceSample> &samples)
+    {
+        int nb_headers = 0;
+        for(uint8_t byte : stream)
+        {
+            TraceFrameType type = trace.push(byte);
+            if(type == TRACE_SAMPLE)
+            {
+                samples.push_back(trace.getSample());
+            }
+            else if(type == TRACE_HEADER)
+            {
+                nb_headers++;
+            }
+        }
+        return nb_headers;
+    }
+
+    /**
+     * @brief A bad frame, then a valid one that must come out as it is
+     *
+     * @param bad bytes of the bad frame
+     * @param what
+     * @return 1 if the check failed
+     */
+    int checkFollowed(const vector<uint8_t> &bad, const char *what)
+    {
+        vector<uint8_t> stream = bad;
+        TraceSample valid = makeSample(7);
+        appendSample(stream, valid);
+
+        SensorTrace trace;
+        vector<TraceSample> samples;
+        decodeStream(stream, trace, samples);
+        return !check(samples.size() == 1 && sameSample(samples[0], valid), what);
+    }
+}
+
+/**
+ * @brief Header and samples through the encoder and the decoder, with text lines between them
+ *
+ * @return number of failed checks
+ */
+int checkRoundTrip()
+{
+    printf("Round trip:\n");
+    vector<uint8_t> stream;
+    uint8_t frame[TRACE_MAX_FRAME];
+    TraceHeader header = makeHeader();
+    int length = SensorTrace::encodeHeader(header, frame);
+    stream.insert(stream.end(), frame, frame + length);
+
+    const char *line = "safety\t1\tfall\t26483\t185\r\n";
+    const int nb_samples = 50;
+    for(int n = 0; n < nb_samples; n++)
+    {
+        appendSample(stream, makeSample(n));
+        if(n%10 == 0)
+        {
+            stream.insert(stream.end(), line, line + strlen(line));
+        }
+    }
+
+    SensorTrace trace;
+    vector<TraceSample> samples;
+    int nb_headers = decodeStream(stream, trace, samples);
+
+    bool same = (int)samples.size() == nb_samples;
+    for(int n = 0; same && n < nb_samples; n++)
+    {
+        same = sameSample(samples[n], makeSample(n));
+    }
+    int nb_failed = 0;
+    nb_failed += !check(nb_headers == 1 && sameHeader(trace.getHeader(), header), "header decoded");
+    nb_failed += !check(same, "every sample decoded, the text lines skipped");
+    nb_failed += !check(trace.getNbErrors() == 0, "no checksum error");
+    return nb_failed;
+}
+
+/**
+ * @brief One corrupted or missing byte before a valid frame: the bad frame is dropped, the next one is decoded
+ *
+ * @return number of failed checks
+ */
+int checkCorrupted()
+{
+    printf("Corrupted frames:\n");
+    uint8_t frame[TRACE_MAX_FRAME];
+    int length = SensorTrace::encodeSample(makeSample(3), frame);
+    int nb_failed = 0;
+
+    vector<uint8_t> bad(frame, frame + length);
+    bad[10] ^= 0x10;
+    nb_failed += checkFollowed(bad, "data byte flipped");
+
+    bad.assign(frame, frame + length);
+    bad[1] = TRACE_HEADER;
+    nb_failed += checkFollowed(bad, "type byte turned into a header, longer than the frame");
+
+    bad.assign(frame, frame + length);
+    bad.pop_back();
+    nb_failed += checkFollowed(bad, "checksum byte lost");
+
+    bad.assign(frame, frame + length/2);
+    nb_failed += checkFollowed(bad, "frame cut in the middle");
+
+    bad.assign(1, TRACE_SYNC);
+    nb_failed += checkFollowed(bad, "stray sync byte");
+
+    bad.assign(frame, frame + length);
+    bad[0] = 0x00;
+    nb_failed += checkFollowed(bad, "sync byte lost, the frame is skipped");
+
+    // The error count of a bad frame
+    bad.assign(frame, frame + length);
+    bad[10] ^= 0x10;
+    SensorTrace trace;
+    vector<TraceSample> samples;
+    decodeStream(bad, trace, samples);
+    nb_failed += !check(trace.getNbErrors() >= 1 && samples.empty(), "checksum error counted, nothing decoded");
+    return nb_failed;
+}
+
+/**
+ * @brief Time to decode one sample frame
+ *
+ */
+void benchmark()
+{
+    const int nb_frames = 1 << 18;
+    vector<uint8_t> stream;
+    for(int n = 0; n < 256; n++)
+    {
+        appendSample(stream, makeSample(n));
+    }
+
+    SensorTrace trace;
+    uint32_t nb_decoded = 0;
+    auto start = chrono::steady_clock::now();
+    for(int n = 0; n < nb_frames/256; n++)
+    {
+        for(uint8_t byte : stream)
+        {
+            nb_decoded += (trace.push(byte) == TRACE_SAMPLE);
+        }
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/nb_frames;
+    printf("%.1f ns per sample frame on the host (%lu decoded)\n", ns, (unsigned long)nb_decoded);
+}
+
+int main()
+{
+    int nb_failed = checkRoundTrip();
+    nb_failed += checkCorrupted();
+    benchmark();
+
+    if(nb_failed > 0)
+    {
+        printf("FAILED, %d checks\n", nb_failed);
+        return 1;
+    }
+    return 0;
+}
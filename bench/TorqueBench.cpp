@@ -0,0 +1,140 @@
+/**
+ * @file TorqueBench.cpp
+ * @author Corentin BENOIT
+ * @brief Host check and benchmark of TorqueTable against the polynomials of PotentiometerSensor::calculateTorque
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Built with the host build only, PotentiometerSensor needs the mbed shim of host/:
+ *   cmake --build build --target torque_bench && ./build/torque_bench
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "TorqueTable.hpp"
+
+using namespace std;
+
+const int BENCH_NB_SAMPLES = 1 << 20;
+const char BENCH_COLORS[4] = {'b', 'g', 'r', 'y'};
+const double BENCH_MAX_ERROR = 0.05;        //[Nm]
+const double BENCH_BUDGET_NS = 1000.0;      //Whole stage per sample, both hips and the global torque
+
+/**
+ * @brief Every colour and direction, every 0.01 deg of the table range
+ *
+ * @return worst difference with calculateTorque [Nm]
+ */
+double checkAgreement()
+{
+    PotentiometerSensor sensor(A3, 0);
+    TorqueTable table;
+    double worst = 0;
+
+    for(int c = 0; c < 4; c++)
+    {
+        sensor.setColor(BENCH_COLORS[c]);
+        table.build(sensor);
+        double color_worst = 0;
+        for(int n = 0; n <= (int)(TORQUE_MAX_ANGLE*100); n++)
+        {
+            float angle = n*0.01f;
+            for(char direction : {'i', 'd'})
+            {
+                double error = fabs(table.lookup(angle, direction) - sensor.calculateTorque(angle, direction));
+                if(error > color_worst)
+                {
+                    color_worst = error;
+                }
+            }
+        }
+        printf("  %c: worst difference %.4f Nm\n", BENCH_COLORS[c], color_worst);
+        if(color_worst > worst)
+        {
+            worst = color_worst;
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief Time of the torque stage of one sample, direction, torque of both hips and global torque,
+ * with the table and with the polynomials
+ *
+ * @return ns per sample with the table
+ */
+double benchmark()
+{
+    vector<float> angles(2*BENCH_NB_SAMPLES);
+    vector<float> velocities(2*BENCH_NB_SAMPLES);
+    srand(1);
+    for(size_t i = 0; i < angles.size(); i++)
+    {
+        angles[i] = (rand() % 12000)*0.01f - 5.0f;
+        velocities[i] = (rand() % 400) - 200.0f;
+    }
+
+    PotentiometerSensor sensors[2] = {PotentiometerSensor(A3, 0), PotentiometerSensor(A2, 1)};
+    TorqueTable tables[2];
+    for(int side = 0; side < 2; side++)
+    {
+        sensors[side].setColor('b');
+        tables[side].build(sensors[side]);
+    }
+
+    volatile float sink = 0;
+    char directions[2] = {'i', 'i'};
+
+    auto start = chrono::steady_clock::now();
+    for(int n = 0; n < BENCH_NB_SAMPLES; n++)
+    {
+        float torque[2];
+        for(int side = 0; side < 2; side++)
+        {
+            TorqueTable::updateDirection(directions[side], velocities[2*n + side]);
+            torque[side] = sensors[side].calculateTorque(angles[2*n + side], directions[side]);
+        }
+        sink = sink + calculateGlobalTorque(torque[0], torque[1]);
+    }
+    double polynomial_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/BENCH_NB_SAMPLES;
+
+    start = chrono::steady_clock::now();
+    for(int n = 0; n < BENCH_NB_SAMPLES; n++)
+    {
+        float torque[2];
+        for(int side = 0; side < 2; side++)
+        {
+            TorqueTable::updateDirection(directions[side], velocities[2*n + side]);
+            torque[side] = tables[side].lookup(angles[2*n + side], directions[side]);
+        }
+        sink = sink + calculateGlobalTorque(torque[0], torque[1]);
+    }
+    double table_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/BENCH_NB_SAMPLES;
+
+    printf("polynomials: %.1f ns per sample, table: %.1f ns per sample, %.1fx\n", polynomial_ns, table_ns, polynomial_ns/table_ns);
+    return table_ns;
+}
+
+int main(int argc, char **argv)
+{
+    printf("Table against calculateTorque:\n");
+    double worst = checkAgreement();
+    double table_ns = benchmark();
+
+    if(worst > BENCH_MAX_ERROR)
+    {
+        printf("FAILED, more than %.2f Nm\n", BENCH_MAX_ERROR);
+        return 1;
+    }
+    if(table_ns > BENCH_BUDGET_NS)
+    {
+        printf("FAILED, more than %.0f ns per sample\n", BENCH_BUDGET_NS);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file HostBoard.cpp
+ * @author Corentin BENOIT
+ * @brief Sensors and analog inputs of the simulated board
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "mbed.h"
+#include "HostI2CDevice.hpp"
+#include "LSM6DSLModel.hpp"
+#include "LPS22HBModel.hpp"
+#include "TraceReplay.hpp"
+#include <cstdlib>
+
+const int64_t HOST_SIGNAL_PERIOD_US = 2000000;     //Period of the synthetic analog signals
+
+
+
+using namespace std;
+
+namespace
+{
+    // The magnetometer is a register file answering read_id(), WHO_AM_I is 0x0F
+    LSM6DSLModel s_lsm6dsl(0xD4, PD_11, PD_12);
+    HostI2CDevice s_lis3mdl("LIS3MDL", 0x3C, 0x80);    //Auto-increment on the MSB of the register
+    LPS22HBModel s_lps22hb(0xBA);
+
+    TraceReplay s_replay;
+
+    float phase(int64_t now_us)
+    {
+        return (float)(now_us % HOST_SIGNAL_PERIOD_US)/HOST_SIGNAL_PERIOD_US;
+    }
+
+    // Pressed half of the time
+    float touch(int64_t now_us)
+    {
+        return (phase(now_us) < 0.5f) ? 0.9f : 0.1f;
+    }
+
+    // Knee angles in phase opposition
+    float potRight(int64_t now_us)
+    {
+        return 0.5f + 0.2f*sinf(2.0f*(float)M_PI*phase(now_us));
+    }
+
+    float potLeft(int64_t now_us)
+    {
+        return 0.5f - 0.2f*sinf(2.0f*(float)M_PI*phase(now_us));
+    }
+
+    struct HostBoard
+    {
+        HostBoard()
+        {
+            s_lis3mdl.setRegister(0x0F, 0x3D);
+
+            host::setAnalogSource(A0, touch);
+            host::setAnalogSource(A3, potRight);
+            host::setAnalogSource(A2, potLeft);
+
+            // Recorded motion instead of the synthetic walk
+            const char *motion = getenv("HOST_IMU_MOTION");
+            if(motion != NULL)
+            {
+                s_lsm6dsl.loadMotion(motion);
+            }
+
+            // A trace of the device drives the IMU and the analog inputs, the run stops at its end
+            const char *trace = getenv("HOST_TRACE");
+            if(trace != NULL)
+            {
+                const char *offset = getenv("HOST_TRACE_OFFSET_US");
+                if(s_replay.load(trace, (offset != NULL) ? strtoll(offset, NULL, 10) : 0, s_lsm6dsl))
+                {
+                    host::setAnalogSource(A0, [](int64_t now_us){ return s_replay.touch(now_us); });
+                    host::setAnalogSource(A3, [](int64_t now_us){ return s_replay.potRight(now_us); });
+                    host::setAnalogSource(A2, [](int64_t now_us){ return s_replay.potLeft(now_us); });
+                    host::setDefaultRunLimit(s_replay.getEnd());
+                }
+            }
+            host::addTimeListener([](int64_t now_us){ s_lsm6dsl.update(now_us); s_lps22hb.update(now_us); });
+            host::addExitHook(HostI2CDevice::reportAll);
+        }
+    } s_board;
+}
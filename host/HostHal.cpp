@@ -0,0 +1,313 @@
+/**
+ * @file HostHal.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "mbed.h"
+#include "HostI2CDevice.hpp"
+#include <cstdarg>
+#include <poll.h>
+#include <unistd.h>
+
+const int EVENT_FLAGS_POLL_US = 100;    //Virtual time between two checks of a waiting EventFlags
+const size_t CONSOLE_CHUNK = 256;       //Bytes converted at a time on stdout
+
+
+
+using namespace std;
+
+namespace
+{
+    recursive_mutex s_i2c_mutex;
+
+    /**
+     * @brief Bus time of one transfer: start, address byte, data bytes and stop, 9 clocks a byte
+     *
+     * @param length data bytes
+     * @param frequency [Hz]
+     * @return [us]
+     */
+    int64_t busTime(int length, int frequency)
+    {
+        return ((int64_t)(length + 1)*9 + 2)*1000000/frequency;
+    }
+
+    /**
+     * @brief Writes stdio output to the console as the retarget layer of mbed does with platform.stdio-convert-newlines:
+     * "\n" leaves as "\r\n" unless a "\r" came just before. mbed_file_handle() stays below it, as on the board
+     *
+     * @return size, or -1 on an error of the console
+     */
+    ssize_t writeConvertedStdout(void *cookie, const char *buffer, size_t size)
+    {
+        static char previous = 0;
+        char converted[2*CONSOLE_CHUNK];
+
+        for(size_t done = 0; done < size; done += CONSOLE_CHUNK)
+        {
+            size_t length = 0;
+            for(size_t i = done; i < size && i < done + CONSOLE_CHUNK; i++)
+            {
+                if(buffer[i] == '\n' && previous != '\r')
+                {
+                    converted[length++] = '\r';
+                }
+                converted[length++] = buffer[i];
+                previous = buffer[i];
+            }
+
+            for(size_t written = 0; written < length; )
+            {
+                ssize_t ret = ::write(STDOUT_FILENO, converted + written, length - written);
+                if(ret <= 0)
+                {
+                    return -1;
+                }
+                written += ret;
+            }
+        }
+        return size;
+    }
+
+    // Replaces stdout before main(), what was printed until then leaves first
+    struct ConvertedStdout
+    {
+        ConvertedStdout()
+        {
+            cookie_io_functions_t functions = {NULL, writeConvertedStdout, NULL, NULL};
+            FILE *converted = fopencookie(NULL, "w", functions);
+            if(converted != NULL)
+            {
+                fflush(stdout);
+                stdout = converted;
+            }
+        }
+    } s_converted_stdout;
+}
+
+/*
+----------------------------------------------------------
+-------------------------TIMER-----------------------------
+----------------------------------------------------------
+*/
+
+void mbed::Timer::start()
+{
+    if(!m_running)
+    {
+        m_start_us = host::readClock();
+        m_running = true;
+    }
+}
+
+void mbed::Timer::stop()
+{
+    if(m_running)
+    {
+        m_elapsed_us += host::readClock() - m_start_us;
+        m_running = false;
+    }
+}
+
+void mbed::Timer::reset()
+{
+    m_elapsed_us = 0;
+    m_start_us = host::readClock();
+}
+
+std::chrono::microseconds mbed::Timer::elapsed_time() const
+{
+    int64_t elapsed_us = m_elapsed_us;
+    if(m_running)
+    {
+        elapsed_us += host::readClock() - m_start_us;
+    }
+    return std::chrono::microseconds(elapsed_us);
+}
+
+/*
+----------------------------------------------------------
+--------------------------I2C------------------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Read transfer, NACK if no model answers the address
+ *
+ * @return 0 if acknowledged
+ */
+int mbed::I2C::read(int address, char *data, int length, bool repeated)
+{
+    HostI2CDevice *device = HostI2CDevice::find(address);
+    if(device == NULL)
+    {
+        host::advance(busTime(0, m_frequency));
+        return 1;
+    }
+
+    int ret = device->read((uint8_t *)data, length);
+    int64_t bus_us = busTime(length, m_frequency);
+    device->countTransfer(length, bus_us);
+    host::advance(bus_us);
+    return ret;
+}
+
+/**
+ * @brief Write transfer, NACK if no model answers the address
+ *
+ * @return 0 if acknowledged
+ */
+int mbed::I2C::write(int address, const char *data, int length, bool repeated)
+{
+    HostI2CDevice *device = HostI2CDevice::find(address);
+    if(device == NULL)
+    {
+        host::advance(busTime(0, m_frequency));
+        return 1;
+    }
+
+    int ret = device->write((const uint8_t *)data, length);
+    int64_t bus_us = busTime(length, m_frequency);
+    device->countTransfer(length, bus_us);
+    host::advance(bus_us);
+    return ret;
+}
+
+void mbed::I2C::lock()
+{
+    //The thread holding the bus may wait for the virtual time of its transfer, which only passes if this one waits too
+    while (!s_i2c_mutex.try_lock()) {
+        host::advance(1);
+    }
+}
+
+void mbed::I2C::unlock()
+{
+    s_i2c_mutex.unlock();
+}
+
+/*
+----------------------------------------------------------
+-----------------------CONSOLE-----------------------------
+----------------------------------------------------------
+*/
+
+ssize_t mbed::FileHandle::read(void *buffer, size_t size)
+{
+    return ::read(m_fd, buffer, size);
+}
+
+ssize_t mbed::FileHandle::write(const void *buffer, size_t size)
+{
+    return ::write(m_fd, buffer, size);
+}
+
+short mbed::FileHandle::poll(short events) const
+{
+    struct pollfd fd = {m_fd, events, 0};
+    if(::poll(&fd, 1, 0) <= 0)
+    {
+        return 0;
+    }
+    return fd.revents;
+}
+
+bool mbed::FileHandle::readable() const
+{
+    return m_input && (poll(POLLIN) & POLLIN);
+}
+
+mbed::FileHandle *mbed::mbed_file_handle(int fd)
+{
+    static FileHandle handles[] = {FileHandle(STDIN_FILENO), FileHandle(STDOUT_FILENO), FileHandle(STDERR_FILENO)};
+    return (fd >= 0 && fd < 3) ? &handles[fd] : NULL;
+}
+
+/*
+----------------------------------------------------------
+-------------------------RTOS------------------------------
+----------------------------------------------------------
+*/
+
+osStatus rtos::Thread::start(mbed::Callback<void()> task)
+{
+    m_handle = host::startThread([task]{ task(); });
+    return osOK;
+}
+
+uint32_t rtos::EventFlags::set(uint32_t flags)
+{
+    m_flags |= flags;
+    return m_flags;
+}
+
+uint32_t rtos::EventFlags::clear(uint32_t flags)
+{
+    uint32_t previous = m_flags;
+    m_flags &= ~flags;
+    return previous;
+}
+
+uint32_t rtos::EventFlags::get() const
+{
+    return m_flags;
+}
+
+uint32_t rtos::EventFlags::wait_any(uint32_t flags, uint32_t millisec, bool clear)
+{
+    return wait(flags, false, millisec, clear);
+}
+
+uint32_t rtos::EventFlags::wait_all(uint32_t flags, uint32_t millisec, bool clear)
+{
+    return wait(flags, true, millisec, clear);
+}
+
+/**
+ * @brief Lets the virtual time pass until the flags are set, the models fire their ISRs meanwhile
+ *
+ */
+uint32_t rtos::EventFlags::wait(uint32_t flags, bool all, uint32_t millisec, bool clear)
+{
+    int64_t deadline_us = host::now() + (int64_t)millisec*1000;
+
+    while (1) {
+        uint32_t current = m_flags;
+        bool set = all ? (current & flags) == flags : (current & flags) != 0;
+        if(set)
+        {
+            if(clear)
+            {
+                m_flags &= ~flags;
+            }
+            return current;
+        }
+        if(millisec != osWaitForever && host::now() >= deadline_us)
+        {
+            return osFlagsErrorTimeout;
+        }
+        host::advance(EVENT_FLAGS_POLL_US);
+    }
+}
+
+
+/*
+----------------------------------------------------------
+-------------------------ERROR-----------------------------
+----------------------------------------------------------
+*/
+
+void error(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    fflush(stdout);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    _exit(1);
+}
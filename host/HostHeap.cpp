@@ -0,0 +1,166 @@
+/**
+ * @file HostHeap.cpp
+ * @author Corentin BENOIT
+ * @brief Replaces malloc, calloc, realloc and free of glibc to count the heap as mbed_stats_heap_get() and to call
+ * the mbed memory trace callback. The blocks still come from glibc
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <malloc.h>
+#include "mbed_mem_trace.h"
+#include "mbed_stats.h"
+
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void *pointer);
+}
+
+namespace
+{
+    std::atomic<mbed_mem_trace_cb_t> s_callback(nullptr);
+    std::atomic<uint32_t> s_current_size(0);
+    std::atomic<uint32_t> s_max_size(0);
+    std::atomic<uint32_t> s_total_size(0);
+    std::atomic<uint32_t> s_alloc_cnt(0);
+    std::atomic<uint32_t> s_alloc_fail_cnt(0);
+    thread_local bool t_in_callback = false;
+
+    void allocated(void *pointer)
+    {
+        if(pointer == nullptr)
+        {
+            s_alloc_fail_cnt++;
+            return;
+        }
+        uint32_t size = malloc_usable_size(pointer);
+        uint32_t current = (s_current_size += size);
+        s_total_size += size;
+        s_alloc_cnt++;
+
+        uint32_t max = s_max_size.load();
+        while (current > max && !s_max_size.compare_exchange_weak(max, current)) {
+        }
+    }
+
+    void released(void *pointer)
+    {
+        if(pointer != nullptr)
+        {
+            s_current_size -= malloc_usable_size(pointer);
+            s_alloc_cnt--;
+        }
+    }
+
+    // Same rule as mbed: an allocation made by the callback is counted but not traced
+    template <typename... A>
+    void trace(uint8_t operation, void *result, void *caller, A... args)
+    {
+        mbed_mem_trace_cb_t callback = s_callback.load();
+        if(callback != nullptr && !t_in_callback)
+        {
+            t_in_callback = true;
+            callback(operation, result, caller, args...);
+            t_in_callback = false;
+        }
+    }
+}
+
+void mbed_mem_trace_set_callback(mbed_mem_trace_cb_t callback)
+{
+    s_callback = callback;
+}
+
+void mbed_stats_heap_get(mbed_stats_heap_t *stats)
+{
+    stats->current_size = s_current_size;
+    stats->max_size = s_max_size;
+    stats->total_size = s_total_size;
+    stats->reserved_size = 0;
+    stats->alloc_cnt = s_alloc_cnt;
+    stats->alloc_fail_cnt = s_alloc_fail_cnt;
+    stats->overhead_size = 0;
+}
+
+extern "C"
+{
+    void *malloc(size_t size)
+    {
+        void *result = __libc_malloc(size);
+        allocated(result);
+        trace(MBED_MEM_TRACE_MALLOC, result, __builtin_return_address(0), size);
+        return result;
+    }
+
+    void *calloc(size_t count, size_t size)
+    {
+        void *result = __libc_calloc(count, size);
+        allocated(result);
+        trace(MBED_MEM_TRACE_CALLOC, result, __builtin_return_address(0), count, size);
+        return result;
+    }
+
+    void *realloc(void *pointer, size_t size)
+    {
+        size_t previous = (pointer != nullptr) ? malloc_usable_size(pointer) : 0;
+        void *result = __libc_realloc(pointer, size);
+        if(result != nullptr || size == 0)
+        {
+            if(pointer != nullptr)
+            {
+                s_current_size -= previous;
+                s_alloc_cnt--;
+            }
+            if(result != nullptr)
+            {
+                allocated(result);
+            }
+        }
+        else
+        {
+            s_alloc_fail_cnt++;
+        }
+        trace(MBED_MEM_TRACE_REALLOC, result, __builtin_return_address(0), pointer, size);
+        return result;
+    }
+
+    void *memalign(size_t alignment, size_t size)
+    {
+        void *result = __libc_memalign(alignment, size);
+        allocated(result);
+        trace(MBED_MEM_TRACE_MALLOC, result, __builtin_return_address(0), size);
+        return result;
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size)
+    {
+        return memalign(alignment, size);
+    }
+
+    int posix_memalign(void **pointer, size_t alignment, size_t size)
+    {
+        void *result = memalign(alignment, size);
+        if(result == nullptr)
+        {
+            return ENOMEM;
+        }
+        *pointer = result;
+        return 0;
+    }
+
+    void free(void *pointer)
+    {
+        released(pointer);
+        __libc_free(pointer);
+        trace(MBED_MEM_TRACE_FREE, nullptr, __builtin_return_address(0), pointer);
+    }
+}
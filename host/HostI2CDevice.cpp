@@ -0,0 +1,213 @@
+/**
+ * @file HostI2CDevice.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "HostI2CDevice.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+
+
+using namespace std;
+
+namespace
+{
+    HostI2CDevice *s_devices[MAX_HOST_I2C_DEVICES];
+}
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+HostI2CDevice::HostI2CDevice(const char *name, uint8_t address, uint8_t increment_flag) : m_name(name), m_address(address),
+    m_increment_flag(increment_flag), m_increment(true), m_pointer(0), m_nb_transfers(0), m_nb_bytes(0), m_bus_us(0){
+    memset(m_registers, 0, sizeof(m_registers));
+
+    for(int i = 0; i < MAX_HOST_I2C_DEVICES; i++)
+    {
+        if(s_devices[i] == NULL)
+        {
+            s_devices[i] = this;
+            break;
+        }
+    }
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+HostI2CDevice::~HostI2CDevice()
+{
+    for(int i = 0; i < MAX_HOST_I2C_DEVICES; i++)
+    {
+        if(s_devices[i] == this)
+        {
+            s_devices[i] = NULL;
+        }
+    }
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+const uint8_t& HostI2CDevice::getAddress() const{
+    return m_address;
+}
+
+uint8_t HostI2CDevice::getRegister(uint8_t reg) const{
+    return m_registers[reg];
+}
+
+void HostI2CDevice::setRegister(uint8_t reg, uint8_t value){
+    m_registers[reg] = value;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Write transfer: register pointer, then the data
+ *
+ * @param data
+ * @param length
+ * @return 0, the device always acknowledges
+ */
+int HostI2CDevice::write(const uint8_t *data, int length)
+{
+    if(length <= 0)
+    {
+        return 0;
+    }
+
+    m_pointer = data[0];
+    m_increment = true;
+    if(m_increment_flag != 0)
+    {
+        m_increment = (m_pointer & m_increment_flag) != 0;
+        m_pointer &= ~m_increment_flag;
+    }
+
+    for(int i = 1; i < length; i++)
+    {
+        writeRegister(m_pointer, data[i]);
+        if(m_increment)
+        {
+            m_pointer = nextRegister(m_pointer);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Read transfer from the register pointer
+ *
+ * @param data
+ * @param length
+ * @return 0
+ */
+int HostI2CDevice::read(uint8_t *data, int length)
+{
+    for(int i = 0; i < length; i++)
+    {
+        data[i] = readRegister(m_pointer);
+        if(m_increment)
+        {
+            m_pointer = nextRegister(m_pointer);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Bus cost of one transfer addressed to the device
+ *
+ * @param length data bytes
+ * @param bus_us bus time of the transfer
+ */
+void HostI2CDevice::countTransfer(int length, int64_t bus_us)
+{
+    m_nb_transfers++;
+    m_nb_bytes += length;
+    m_bus_us += bus_us;
+}
+
+/**
+ * @brief Bus cost, on stderr so the output of the firmware stays clean
+ *
+ */
+void HostI2CDevice::report() const
+{
+    fprintf(stderr, "%s: %lu transfers, %lu bytes, %lld us of bus time\n",
+        m_name,
+        (unsigned long)m_nb_transfers,
+        (unsigned long)m_nb_bytes,
+        (long long)m_bus_us);
+}
+
+/**
+ * @brief Bus cost of every device
+ *
+ */
+void HostI2CDevice::reportAll()
+{
+    for(int i = 0; i < MAX_HOST_I2C_DEVICES; i++)
+    {
+        if(s_devices[i] != NULL)
+        {
+            s_devices[i]->report();
+        }
+    }
+}
+
+/**
+ * @brief Device answering an address
+ *
+ * @param address 8 bits, the read bit is ignored
+ * @return NULL if no device answers
+ */
+HostI2CDevice *HostI2CDevice::find(uint8_t address)
+{
+    for(int i = 0; i < MAX_HOST_I2C_DEVICES; i++)
+    {
+        if(s_devices[i] != NULL && s_devices[i]->m_address == (address & 0xFE))
+        {
+            return s_devices[i];
+        }
+    }
+    return NULL;
+}
+
+uint8_t HostI2CDevice::readRegister(uint8_t reg)
+{
+    return m_registers[reg];
+}
+
+void HostI2CDevice::writeRegister(uint8_t reg, uint8_t value)
+{
+    m_registers[reg] = value;
+}
+
+uint8_t HostI2CDevice::nextRegister(uint8_t reg) const
+{
+    return reg + 1;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file HostI2CDevice.hpp
+ * @author Corentin BENOIT
+ * @brief Register map of a sensor of the host build, answers the transfers of the shim I2C
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOSTI2CDEVICE
+#define DEF_HOSTI2CDEVICE
+
+#include <cstdint>
+
+const int MAX_HOST_I2C_DEVICES = 8;
+const int HOST_NB_REGISTERS = 256;
+
+
+/**
+ * @brief Plain register file with a register pointer, the models of the sensors derive from it.
+ * A write transfer sets the pointer with its first byte then writes the next bytes, a read transfer reads from the pointer
+ */
+class HostI2CDevice
+{
+public:
+    // Constructor
+    HostI2CDevice(const char *name, uint8_t address, uint8_t increment_flag = 0);
+
+    // Destructor
+    virtual ~HostI2CDevice();
+
+
+    // Assessors
+    const uint8_t &getAddress() const;
+    uint8_t getRegister(uint8_t reg) const;
+    void setRegister(uint8_t reg, uint8_t value);
+
+    //Methods
+    int write(const uint8_t *data, int length);
+    int read(uint8_t *data, int length);
+    void countTransfer(int length, int64_t bus_us);
+    virtual void report() const;
+
+    static HostI2CDevice *find(uint8_t address);
+    static void reportAll();
+
+
+
+protected:
+    // Hooks of the models, the default is a plain memory
+    virtual uint8_t readRegister(uint8_t reg);
+    virtual void writeRegister(uint8_t reg, uint8_t value);
+    virtual uint8_t nextRegister(uint8_t reg) const;
+
+    const char *m_name;
+    uint8_t m_address;          //8 bits I2C address
+    uint8_t m_increment_flag;   //Register bit enabling the address auto-increment, 0 if always on
+    bool m_increment;
+    uint8_t m_pointer;
+    uint8_t m_registers[HOST_NB_REGISTERS];
+
+    // Bus cost, counted by the shim I2C
+    uint32_t m_nb_transfers;
+    uint32_t m_nb_bytes;        //Register pointer and data, address bytes excluded
+    int64_t m_bus_us;
+};
+#endif
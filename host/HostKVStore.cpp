@@ -0,0 +1,134 @@
+/**
+ * @file HostKVStore.cpp
+ * @author Corentin BENOIT
+ * @brief kv_set and kv_get of the host. With HOST_KV_DIR set, each key is a file of that directory and survives
+ * the run, otherwise a few fixed slots in memory. No heap: open/read/write, no stdio
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <unistd.h>
+#include "kvstore_global_api.h"
+
+namespace
+{
+    const int KV_SLOTS = 8;
+    const size_t KV_KEY_SIZE = 64;
+    const size_t KV_VALUE_SIZE = 4096;
+
+    struct Slot
+    {
+        char key[KV_KEY_SIZE];
+        uint8_t value[KV_VALUE_SIZE];
+        size_t size;
+    };
+
+    Slot s_slots[KV_SLOTS];
+    std::mutex s_mutex;
+
+    // "/kv/exposure" is HOST_KV_DIR/exposure
+    bool filePath(const char *key, char *path, size_t path_size)
+    {
+        const char *dir = getenv("HOST_KV_DIR");
+        if(dir == nullptr || dir[0] == '\0')
+        {
+            return false;
+        }
+        const char *name = strrchr(key, '/');
+        snprintf(path, path_size, "%s/%s", dir, (name != nullptr) ? name + 1 : key);
+        return true;
+    }
+
+    Slot *findSlot(const char *key, bool create)
+    {
+        for(int i = 0; i < KV_SLOTS; i++)
+        {
+            if(strcmp(s_slots[i].key, key) == 0)
+            {
+                return &s_slots[i];
+            }
+        }
+        if(!create)
+        {
+            return nullptr;
+        }
+        for(int i = 0; i < KV_SLOTS; i++)
+        {
+            if(s_slots[i].key[0] == '\0')
+            {
+                snprintf(s_slots[i].key, KV_KEY_SIZE, "%s", key);
+                return &s_slots[i];
+            }
+        }
+        return nullptr;
+    }
+}
+
+int kv_set(const char *full_name_key, const void *buffer, size_t size, uint32_t create_flags)
+{
+    char path[512];
+    if(filePath(full_name_key, path, sizeof(path)))
+    {
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0)
+        {
+            return MBED_ERROR_WRITE_FAILED;
+        }
+        bool written = (write(fd, buffer, size) == (ssize_t)size);
+        close(fd);
+        return written ? MBED_SUCCESS : MBED_ERROR_WRITE_FAILED;
+    }
+
+    if(size > KV_VALUE_SIZE || strlen(full_name_key) >= KV_KEY_SIZE)
+    {
+        return MBED_ERROR_INVALID_SIZE;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    Slot *slot = findSlot(full_name_key, true);
+    if(slot == nullptr)
+    {
+        return MBED_ERROR_MEDIA_FULL;
+    }
+    memcpy(slot->value, buffer, size);
+    slot->size = size;
+    return MBED_SUCCESS;
+}
+
+int kv_get(const char *full_name_key, void *buffer, size_t buffer_size, size_t *actual_size)
+{
+    char path[512];
+    if(filePath(full_name_key, path, sizeof(path)))
+    {
+        int fd = open(path, O_RDONLY);
+        if(fd < 0)
+        {
+            return MBED_ERROR_ITEM_NOT_FOUND;
+        }
+        ssize_t size = read(fd, buffer, buffer_size);
+        close(fd);
+        if(size < 0)
+        {
+            return MBED_ERROR_ITEM_NOT_FOUND;
+        }
+        *actual_size = size;
+        return MBED_SUCCESS;
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    Slot *slot = findSlot(full_name_key, false);
+    if(slot == nullptr)
+    {
+        return MBED_ERROR_ITEM_NOT_FOUND;
+    }
+    size_t size = (slot->size < buffer_size) ? slot->size : buffer_size;
+    memcpy(buffer, slot->value, size);
+    *actual_size = size;
+    return MBED_SUCCESS;
+}
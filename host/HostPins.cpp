@@ -0,0 +1,102 @@
+/**
+ * @file HostPins.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "HostPins.hpp"
+#include "HostTime.hpp"
+#include <cstddef>
+
+
+
+using namespace std;
+
+namespace
+{
+    int s_levels[HOST_NB_PINS];                 //Buttons are active low, all pins start pressed/low
+    host::AnalogSource s_sources[HOST_NB_PINS];
+    host::PinListener *s_listeners[HOST_NB_PINS][MAX_PIN_LISTENERS];
+
+    bool valid(int pin)
+    {
+        return pin >= 0 && pin < HOST_NB_PINS;
+    }
+}
+
+namespace host
+{
+    int getPin(int pin)
+    {
+        return valid(pin) ? s_levels[pin] : 0;
+    }
+
+    void setPin(int pin, int level)
+    {
+        if(!valid(pin) || s_levels[pin] == level)
+        {
+            return;
+        }
+        s_levels[pin] = level;
+
+        for(int i = 0; i < MAX_PIN_LISTENERS; i++)
+        {
+            if(s_listeners[pin][i] != NULL)
+            {
+                s_listeners[pin][i]->edge(level != 0);
+            }
+        }
+    }
+
+    float getAnalog(int pin)
+    {
+        if(!valid(pin) || s_sources[pin] == NULL)
+        {
+            return 0.5f;
+        }
+        return s_sources[pin](now());
+    }
+
+    void setAnalogSource(int pin, AnalogSource source)
+    {
+        if(valid(pin))
+        {
+            s_sources[pin] = source;
+        }
+    }
+
+    void attachListener(int pin, PinListener *listener)
+    {
+        if(!valid(pin))
+        {
+            return;
+        }
+        for(int i = 0; i < MAX_PIN_LISTENERS; i++)
+        {
+            if(s_listeners[pin][i] == NULL)
+            {
+                s_listeners[pin][i] = listener;
+                return;
+            }
+        }
+    }
+
+    void detachListener(int pin, PinListener *listener)
+    {
+        if(!valid(pin))
+        {
+            return;
+        }
+        for(int i = 0; i < MAX_PIN_LISTENERS; i++)
+        {
+            if(s_listeners[pin][i] == listener)
+            {
+                s_listeners[pin][i] = NULL;
+            }
+        }
+    }
+}
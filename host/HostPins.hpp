@@ -0,0 +1,43 @@
+/**
+ * @file HostPins.hpp
+ * @author Corentin BENOIT
+ * @brief Levels of the pins of the host build: digital levels, analog signals and interrupt edges
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOSTPINS
+#define DEF_HOSTPINS
+
+#include <cstdint>
+
+const int HOST_NB_PINS = 64;
+const int MAX_PIN_LISTENERS = 4;    //InterruptIn per pin
+
+namespace host
+{
+    // Analog signal of one pin, as a function of the virtual time, in [0; 1]
+    typedef float (*AnalogSource)(int64_t now_us);
+
+    // Receives the edges of one pin, InterruptIn derives from it
+    class PinListener
+    {
+    public:
+        virtual ~PinListener() {}
+        virtual void edge(bool rising) = 0;
+    };
+
+    int getPin(int pin);
+    void setPin(int pin, int level);        //Edges are delivered right away, like an ISR
+
+    float getAnalog(int pin);
+    void setAnalogSource(int pin, AnalogSource source);
+
+    void attachListener(int pin, PinListener *listener);
+    void detachListener(int pin, PinListener *listener);
+}
+
+#endif
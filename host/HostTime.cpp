@@ -0,0 +1,225 @@
+/**
+ * @file HostTime.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "HostTime.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+
+
+using namespace std;
+
+namespace
+{
+    // One thread of the firmware, other than main
+    struct HostThread
+    {
+        int64_t wake_us;
+        bool running;       //Only one thread runs at a time, main or this one
+        bool finished;
+    };
+
+    mutex s_mutex;
+    condition_variable s_wake;
+    vector<HostThread *> s_threads;
+
+    atomic<int64_t> s_now_us(0);
+    bool s_in_advance = false;      //Clock reads from a listener or an ISR don't move the clock
+
+    void (*s_listeners[MAX_HOST_LISTENERS])(int64_t now_us);
+    int s_nb_listeners = 0;
+    void (*s_exit_hooks[MAX_HOST_EXIT_HOOKS])();
+    int s_nb_exit_hooks = 0;
+    int64_t s_default_run_us = HOST_DEFAULT_RUN_US;     //Run limit when HOST_RUN_US is not set
+
+    thread_local HostThread *t_self = NULL;
+
+    /**
+     * @brief Ends the run: exit hooks, then the buffered output. The firmware threads are never joined
+     *
+     */
+    void exitRun()
+    {
+        for(int i = 0; i < s_nb_exit_hooks; i++)
+        {
+            s_exit_hooks[i]();
+        }
+        fflush(stdout);
+        fflush(stderr);
+        _exit(0);
+    }
+
+    /**
+     * @brief Moves the clock forward, main thread only
+     *
+     * @param time_us
+     */
+    void moveTo(int64_t time_us)
+    {
+        if(time_us > s_now_us.load())
+        {
+            s_now_us.store(time_us);
+        }
+        for(int i = 0; i < s_nb_listeners; i++)
+        {
+            s_listeners[i](s_now_us.load());
+        }
+
+        int64_t limit_us = host::getRunLimit();
+        if(limit_us > 0 && s_now_us.load() >= limit_us)
+        {
+            exitRun();
+        }
+    }
+
+    /**
+     * @brief Earliest thread due before time_us, the first one started on equal times
+     *
+     * @param time_us
+     * @return NULL if none
+     */
+    HostThread *nextDue(int64_t time_us)
+    {
+        lock_guard<mutex> lock(s_mutex);
+        HostThread *next = NULL;
+        for(HostThread *thread : s_threads)
+        {
+            if(!thread->finished && thread->wake_us <= time_us && (next == NULL || thread->wake_us < next->wake_us))
+            {
+                next = thread;
+            }
+        }
+        return next;
+    }
+
+    /**
+     * @brief Hands the CPU over to a thread until it sleeps again or returns
+     *
+     * @param thread
+     */
+    void resume(HostThread *thread)
+    {
+        unique_lock<mutex> lock(s_mutex);
+        thread->running = true;
+        s_wake.notify_all();
+        s_wake.wait(lock, [thread]{ return !thread->running; });
+    }
+}
+
+namespace host
+{
+    int64_t now()
+    {
+        return s_now_us.load();
+    }
+
+    int64_t readClock()
+    {
+        if(isMainThread() && !s_in_advance)
+        {
+            advance(HOST_CLOCK_READ_US);
+        }
+        return s_now_us.load();
+    }
+
+    void advance(int64_t duration_us)
+    {
+        if(!isMainThread())
+        {
+            unique_lock<mutex> lock(s_mutex);
+            t_self->wake_us = s_now_us.load() + duration_us;
+            t_self->running = false;
+            s_wake.notify_all();
+            s_wake.wait(lock, []{ return t_self->running; });
+            return;
+        }
+
+        if(s_in_advance)
+        {
+            return;
+        }
+        s_in_advance = true;
+
+        int64_t target_us = s_now_us.load() + duration_us;
+        HostThread *thread;
+        while ((thread = nextDue(target_us)) != NULL) {
+            moveTo(thread->wake_us);
+            resume(thread);
+        }
+        moveTo(target_us);
+
+        s_in_advance = false;
+    }
+
+    void *startThread(function<void()> task)
+    {
+        HostThread *thread = new HostThread{s_now_us.load(), false, false};
+        {
+            lock_guard<mutex> lock(s_mutex);
+            s_threads.push_back(thread);
+        }
+
+        std::thread([thread, task]{
+            t_self = thread;
+            {
+                unique_lock<mutex> lock(s_mutex);
+                s_wake.wait(lock, [thread]{ return thread->running; });
+            }
+
+            task();
+
+            lock_guard<mutex> lock(s_mutex);
+            thread->finished = true;
+            thread->running = false;
+            s_wake.notify_all();
+        }).detach();
+
+        return thread;
+    }
+
+    bool isMainThread()
+    {
+        return t_self == NULL;
+    }
+
+    void addTimeListener(void (*listener)(int64_t now_us))
+    {
+        if(s_nb_listeners < MAX_HOST_LISTENERS)
+        {
+            s_listeners[s_nb_listeners++] = listener;
+        }
+    }
+
+    void addExitHook(void (*hook)())
+    {
+        if(s_nb_exit_hooks < MAX_HOST_EXIT_HOOKS)
+        {
+            s_exit_hooks[s_nb_exit_hooks++] = hook;
+        }
+    }
+
+    int64_t getRunLimit()
+    {
+        static const char *env = getenv("HOST_RUN_US");
+        static int64_t env_us = (env != NULL) ? strtoll(env, NULL, 10) : -1;
+        return (env_us >= 0) ? env_us : s_default_run_us;
+    }
+
+    void setDefaultRunLimit(int64_t limit_us)
+    {
+        s_default_run_us = limit_us;
+    }
+}
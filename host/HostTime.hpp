@@ -0,0 +1,53 @@
+/**
+ * @file HostTime.hpp
+ * @author Corentin BENOIT
+ * @brief Virtual clock of the host build, the threads of the firmware run one at a time in lockstep with it
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOSTTIME
+#define DEF_HOSTTIME
+
+#include <cstdint>
+#include <functional>
+
+const int64_t HOST_CLOCK_READ_US = 1;           //Virtual time spent by each clock read of the main thread
+const int64_t HOST_DEFAULT_RUN_US = 30000000;   //Run limit when HOST_RUN_US is not set
+const int MAX_HOST_LISTENERS = 8;
+const int MAX_HOST_EXIT_HOOKS = 8;
+
+namespace host
+{
+    // Virtual time [us], never advanced by the call
+    int64_t now();
+
+    // Clock read: from the main thread it costs HOST_CLOCK_READ_US, so the busy loops of the firmware end
+    int64_t readClock();
+
+    // Time passes for the caller. The main thread moves the clock and runs the threads due in between,
+    // the other threads wait until the clock reaches their wake-up time
+    void advance(int64_t duration_us);
+
+    // Runs task in its own thread, first scheduled at the next advance of the main thread
+    void *startThread(std::function<void()> task);
+
+    bool isMainThread();
+
+    // Called with the time when the clock moves, in the main thread. The device models update from it
+    void addTimeListener(void (*listener)(int64_t now_us));
+
+    // Called once the run limit is reached, before the process exits
+    void addExitHook(void (*hook)());
+
+    // Virtual time at which the run stops, from HOST_RUN_US, 0 runs forever
+    int64_t getRunLimit();
+
+    // Run limit when HOST_RUN_US is not set, the end of a replayed trace for instance
+    void setDefaultRunLimit(int64_t limit_us);
+}
+
+#endif
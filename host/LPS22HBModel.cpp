@@ -0,0 +1,453 @@
+/**
+ * @file LPS22HBModel.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "LPS22HBModel.hpp"
+#include "HostTime.hpp"
+#include "BarometerSensor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+
+using namespace std;
+
+namespace
+{
+    // Register bits and registers the driver doesn't use
+    const uint8_t TEMP_OUT_H = 0x2C;
+    const uint8_t BOOT = 0x80;              //CTRL_REG2
+    const uint8_t SWRESET = 0x04;
+    const uint8_t T_DA = 0x02;              //STATUS
+    const uint8_t P_OR = 0x10;
+    const uint8_t T_OR = 0x20;
+    const uint8_t FIFO_OVR = 0x40;          //FIFO_STATUS
+    const uint8_t FIFO_FTH = 0x80;
+    const uint8_t FIFO_MODE_MASK = 0xE0;    //FIFO_CTRL
+    const uint8_t FIFO_MODE_FIFO = 0x20;    //Stops when full, the other modes are modelled as stream
+    const uint8_t FIFO_WTM_MASK = 0x1F;
+
+    // Internal low-pass filter, first order per sample with the bandwidth of LPFP_CFG
+    const float LPFP_GAIN_ODR_9 = 0.41f;
+    const float LPFP_GAIN_ODR_20 = 0.24f;
+
+    // Synthetic profile: up and down a 3 m flight of stairs every 20 s
+    const float PROFILE_HEIGHT = 3.0f;      //[m]
+    const int64_t PROFILE_PERIOD_US = 20000000;
+}
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+LPS22HBModel::LPS22HBModel(uint8_t address) : HostI2CDevice("LPS22HB", address),
+    m_nb_samples(0), m_nb_reads(0), m_nb_overruns(0){
+    reset();
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+LPS22HBModel::~LPS22HBModel()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+uint32_t LPS22HBModel::getSampleCount() const{
+    return m_nb_samples;
+}
+
+uint32_t LPS22HBModel::getOverrunCount() const{
+    return m_nb_overruns;
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Produces the samples due until now_us, called when the virtual clock moves
+ *
+ * @param now_us
+ */
+void LPS22HBModel::update(int64_t now_us)
+{
+    if(m_one_shot_us >= 0 && now_us >= m_one_shot_us)
+    {
+        // The bit clears itself once the conversion is over
+        sample(m_one_shot_us, false);
+        m_registers[LPS22HB_CTRL_REG2] &= ~LPS22HB_ONE_SHOT;
+        m_one_shot_us = -1;
+    }
+
+    float rate = odr(m_registers[LPS22HB_CTRL_REG1]);
+    if(rate <= 0)
+    {
+        return;
+    }
+    while (1) {
+        int64_t t_us = m_start_us + (int64_t)((m_count + 1)*1e6/rate);
+        if(t_us > now_us)
+        {
+            break;
+        }
+        m_count++;
+        sample(t_us, true);
+    }
+}
+
+/**
+ * @brief Appends a point to the scripted profile, which replaces the synthetic one. The times must increase
+ *
+ * @param t_us
+ * @param pressure [hPa]
+ */
+void LPS22HBModel::addPressure(int64_t t_us, float pressure)
+{
+    PressureSample point;
+    point.t_us = t_us;
+    point.pressure = pressure;
+    m_profile.push_back(point);
+}
+
+/**
+ * @brief Back to the synthetic profile
+ *
+ */
+void LPS22HBModel::clearProfile()
+{
+    m_profile.clear();
+}
+
+/**
+ * @brief Pressure the sensor sees, linear between the points of the profile and held outside of them
+ *
+ * @param t_us
+ * @return [hPa]
+ */
+float LPS22HBModel::pressure(int64_t t_us) const
+{
+    if(m_profile.empty())
+    {
+        float phase = (float)(t_us % PROFILE_PERIOD_US)/PROFILE_PERIOD_US;
+        return pressureAt(0.5f*PROFILE_HEIGHT*(1.0f - cosf(2.0f*(float)M_PI*phase)));
+    }
+
+    if(t_us <= m_profile.front().t_us)
+    {
+        return m_profile.front().pressure;
+    }
+    for(size_t i = 1; i < m_profile.size(); i++)
+    {
+        if(t_us < m_profile[i].t_us)
+        {
+            const PressureSample &a = m_profile[i - 1];
+            const PressureSample &b = m_profile[i];
+            return a.pressure + (b.pressure - a.pressure)*(float)(t_us - a.t_us)/(float)(b.t_us - a.t_us);
+        }
+    }
+    return m_profile.back().pressure;
+}
+
+/**
+ * @brief Bus cost, in total and per pressure sample read
+ *
+ */
+void LPS22HBModel::report() const
+{
+    HostI2CDevice::report();
+    fprintf(stderr, "%s: %lu pressure samples, %lu read, %lu lost, %.1f bytes and %.2f transfers per sample read\n",
+        m_name,
+        (unsigned long)m_nb_samples,
+        (unsigned long)m_nb_reads,
+        (unsigned long)m_nb_overruns,
+        (m_nb_reads > 0) ? (float)m_nb_bytes/m_nb_reads : 0.0f,
+        (m_nb_reads > 0) ? (float)m_nb_transfers/m_nb_reads : 0.0f);
+}
+
+/**
+ * @brief Standard atmosphere, the inverse of the formula of BarometerSensor
+ *
+ * @param altitude above the sea level [m]
+ * @return [hPa]
+ */
+float LPS22HBModel::pressureAt(float altitude)
+{
+    return MODEL_SEA_LEVEL_HPA*powf(1.0f - altitude/44330.0f, 1.0f/0.190295f);
+}
+
+uint8_t LPS22HBModel::readRegister(uint8_t reg)
+{
+    uint8_t value = m_registers[reg];
+
+    if(reg >= LPS22HB_PRESS_OUT_XL && reg <= TEMP_OUT_H && fifoEnabled())
+    {
+        if(m_fifo_level > 0)
+        {
+            int32_t raw = m_fifo[m_fifo_head];
+            int16_t temperature = (int16_t)(MODEL_TEMPERATURE*100.0f);
+            value = (reg < TEMP_OUT_H - 1) ? (raw >> (8*(reg - LPS22HB_PRESS_OUT_XL))) & 0xFF
+                  : (temperature >> (8*(reg - (TEMP_OUT_H - 1)))) & 0xFF;
+
+            // The last byte of a slot pops it
+            if(reg == TEMP_OUT_H)
+            {
+                m_fifo_head = (m_fifo_head + 1) % MODEL_BARO_FIFO_SIZE;
+                m_fifo_level--;
+                m_nb_reads++;
+                m_registers[LPS22HB_STATUS] &= ~(LPS22HB_P_DA | T_DA);
+            }
+        }
+    }
+    else if(reg >= LPS22HB_PRESS_OUT_XL && reg <= LPS22HB_PRESS_OUT_XL + 2)
+    {
+        if(reg == LPS22HB_PRESS_OUT_XL)
+        {
+            m_held = true;
+        }
+        else if(reg == LPS22HB_PRESS_OUT_XL + 2)
+        {
+            // High byte: the output is released, the data ready flag cleared
+            m_held = false;
+            m_registers[LPS22HB_STATUS] &= ~(LPS22HB_P_DA | T_DA);
+            m_nb_reads++;
+            if(m_pending)
+            {
+                m_pending = false;
+                latch(m_pending_raw);
+            }
+        }
+    }
+    else if(reg == LPS22HB_FIFO_STATUS)
+    {
+        int threshold = m_registers[LPS22HB_FIFO_CTRL] & FIFO_WTM_MASK;
+        value = ((threshold > 0 && m_fifo_level >= threshold) ? FIFO_FTH : 0)
+            | (m_fifo_overrun ? FIFO_OVR : 0)
+            | (m_fifo_level & LPS22HB_FIFO_LEVEL_MASK);
+    }
+    else if(reg == LPS22HB_LPFP_RES)
+    {
+        // The read resets the filter, the next sample starts it again
+        m_filter_reset = true;
+        value = 0;
+    }
+    return value;
+}
+
+void LPS22HBModel::writeRegister(uint8_t reg, uint8_t value)
+{
+    int64_t now_us = host::now();
+
+    if(reg == LPS22HB_CTRL_REG1)
+    {
+        if((value & LPS22HB_ODR_MASK) != (m_registers[reg] & LPS22HB_ODR_MASK))
+        {
+            m_start_us = now_us;
+            m_count = 0;
+        }
+        m_registers[reg] = value;
+    }
+    else if(reg == LPS22HB_CTRL_REG2)
+    {
+        if(value & SWRESET)
+        {
+            reset();
+            return;
+        }
+        m_registers[reg] = value & ~BOOT;
+
+        // A one-shot only starts in power-down, and not while another one runs
+        if(value & LPS22HB_ONE_SHOT)
+        {
+            if((m_registers[LPS22HB_CTRL_REG1] & LPS22HB_ODR_MASK) != LPS22HB_ODR_ONE_SHOT)
+            {
+                m_registers[reg] &= ~LPS22HB_ONE_SHOT;
+            }
+            else if(m_one_shot_us < 0)
+            {
+                m_one_shot_us = now_us + MODEL_ONE_SHOT_US;
+            }
+        }
+    }
+    else if(reg == LPS22HB_FIFO_CTRL)
+    {
+        m_registers[reg] = value;
+        if((value & FIFO_MODE_MASK) == LPS22HB_FIFO_BYPASS)
+        {
+            m_fifo_head = 0;
+            m_fifo_level = 0;
+            m_fifo_overrun = false;
+        }
+    }
+    else if(reg != LPS22HB_WHO_AM_I && reg != LPS22HB_STATUS && reg != LPS22HB_FIFO_STATUS
+        && !(reg >= LPS22HB_PRESS_OUT_XL && reg <= TEMP_OUT_H))
+    {
+        m_registers[reg] = value;
+    }
+}
+
+/**
+ * @brief IF_ADD_INC, and the wrap of the output registers that lets a burst read consecutive FIFO slots
+ *
+ * @param reg
+ * @return uint8_t
+ */
+uint8_t LPS22HBModel::nextRegister(uint8_t reg) const
+{
+    if(!(m_registers[LPS22HB_CTRL_REG2] & LPS22HB_IF_ADD_INC))
+    {
+        return reg;
+    }
+    if(reg == TEMP_OUT_H && (m_registers[LPS22HB_CTRL_REG2] & LPS22HB_FIFO_EN))
+    {
+        return LPS22HB_PRESS_OUT_XL;
+    }
+    return reg + 1;
+}
+
+/**
+ * @brief Power-on state
+ *
+ */
+void LPS22HBModel::reset()
+{
+    memset(m_registers, 0, sizeof(m_registers));
+    m_registers[LPS22HB_WHO_AM_I] = LPS22HB_ID;
+    m_registers[LPS22HB_CTRL_REG2] = LPS22HB_IF_ADD_INC;
+
+    m_start_us = 0;
+    m_count = 0;
+    m_one_shot_us = -1;
+
+    m_filtered = 0;
+    m_filter_reset = true;
+
+    m_held = false;
+    m_pending = false;
+    m_pending_raw = 0;
+
+    memset(m_fifo, 0, sizeof(m_fifo));
+    m_fifo_head = 0;
+    m_fifo_level = 0;
+    m_fifo_overrun = false;
+}
+
+/**
+ * @brief One conversion, to the FIFO or to the output registers
+ *
+ * @param t_us
+ * @param filtered through the internal low-pass filter when it is enabled, continuous mode only
+ */
+void LPS22HBModel::sample(int64_t t_us, bool filtered)
+{
+    float value = pressure(t_us);
+
+    uint8_t ctrl_reg1 = m_registers[LPS22HB_CTRL_REG1];
+    if(filtered && (ctrl_reg1 & LPS22HB_EN_LPFP))
+    {
+        if(m_filter_reset)
+        {
+            m_filtered = value;
+            m_filter_reset = false;
+        }
+        m_filtered += (value - m_filtered)*((ctrl_reg1 & LPS22HB_LPFP_CFG) ? LPFP_GAIN_ODR_20 : LPFP_GAIN_ODR_9);
+        value = m_filtered;
+    }
+
+    int32_t raw = (int32_t)lroundf(value*LPS22HB_SENSITIVITY);
+    m_nb_samples++;
+
+    if(fifoEnabled())
+    {
+        pushFifo(raw);
+        m_registers[LPS22HB_STATUS] |= LPS22HB_P_DA | T_DA;
+        return;
+    }
+
+    if(m_registers[LPS22HB_STATUS] & LPS22HB_P_DA)
+    {
+        m_registers[LPS22HB_STATUS] |= P_OR | T_OR;
+        m_nb_overruns++;
+    }
+    m_registers[LPS22HB_STATUS] |= LPS22HB_P_DA | T_DA;
+
+    if((ctrl_reg1 & LPS22HB_BDU) && m_held)
+    {
+        m_pending = true;
+        m_pending_raw = raw;
+        return;
+    }
+    latch(raw);
+}
+
+void LPS22HBModel::latch(int32_t raw)
+{
+    int16_t temperature = (int16_t)(MODEL_TEMPERATURE*100.0f);
+    m_registers[LPS22HB_PRESS_OUT_XL] = raw & 0xFF;
+    m_registers[LPS22HB_PRESS_OUT_XL + 1] = (raw >> 8) & 0xFF;
+    m_registers[LPS22HB_PRESS_OUT_XL + 2] = (raw >> 16) & 0xFF;
+    m_registers[TEMP_OUT_H - 1] = temperature & 0xFF;
+    m_registers[TEMP_OUT_H] = (temperature >> 8) & 0xFF;
+}
+
+/**
+ * @brief Stream mode drops the oldest sample when the FIFO is full, FIFO mode the newest
+ *
+ * @param raw
+ */
+void LPS22HBModel::pushFifo(int32_t raw)
+{
+    if(m_fifo_level == MODEL_BARO_FIFO_SIZE)
+    {
+        m_fifo_overrun = true;
+        m_nb_overruns++;
+        if((m_registers[LPS22HB_FIFO_CTRL] & FIFO_MODE_MASK) == FIFO_MODE_FIFO)
+        {
+            return;
+        }
+        m_fifo_head = (m_fifo_head + 1) % MODEL_BARO_FIFO_SIZE;
+        m_fifo_level--;
+    }
+    m_fifo[(m_fifo_head + m_fifo_level) % MODEL_BARO_FIFO_SIZE] = raw;
+    m_fifo_level++;
+}
+
+bool LPS22HBModel::fifoEnabled() const
+{
+    return (m_registers[LPS22HB_CTRL_REG2] & LPS22HB_FIFO_EN)
+        && (m_registers[LPS22HB_FIFO_CTRL] & FIFO_MODE_MASK) != LPS22HB_FIFO_BYPASS;
+}
+
+/**
+ * @brief Output data rate of CTRL_REG1
+ *
+ * @param ctrl_reg1
+ * @return [Hz], 0 in power-down
+ */
+float LPS22HBModel::odr(uint8_t ctrl_reg1)
+{
+    const float rates[8] = {0, 1, 10, 25, 50, 75, 0, 0};
+    return rates[(ctrl_reg1 & LPS22HB_ODR_MASK) >> 4];
+}
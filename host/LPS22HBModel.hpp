@@ -0,0 +1,100 @@
+/**
+ * @file LPS22HBModel.hpp
+ * @author Corentin BENOIT
+ * @brief Register level model of the LPS22HB for the host build, fed from a synthetic or scripted pressure profile
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_LPS22HBMODEL
+#define DEF_LPS22HBMODEL
+
+#include <cstdint>
+#include <vector>
+#include "HostI2CDevice.hpp"
+
+const int MODEL_BARO_FIFO_SIZE = 32;                //Samples
+const int64_t MODEL_ONE_SHOT_US = 15000;            //Conversion time of a one-shot
+const float MODEL_SEA_LEVEL_HPA = 1013.25f;
+const float MODEL_TEMPERATURE = 25.0f;              //[degC]
+
+
+/**
+ * @brief Models the ODR of CTRL_REG1 with the internal low-pass filter and BDU, the one-shot of CTRL_REG2 and its self-clear,
+ * the FIFO in bypass, FIFO and stream mode with FIFO_STATUS, and the output registers, which wrap from TEMP_OUT_H
+ * back to PRESS_OUT_XL while the FIFO is enabled. Updated by the virtual clock
+ */
+class LPS22HBModel : public HostI2CDevice
+{
+public:
+    // Constructor
+    LPS22HBModel(uint8_t address);
+
+    // Destructor
+    ~LPS22HBModel();
+
+
+    // Assessors
+    uint32_t getSampleCount() const;
+    uint32_t getOverrunCount() const;
+
+    //Methods
+    void update(int64_t now_us);
+    void addPressure(int64_t t_us, float pressure);
+    void clearProfile();
+    float pressure(int64_t t_us) const;
+    void report() const override;
+
+    static float pressureAt(float altitude);
+
+
+
+protected:
+    uint8_t readRegister(uint8_t reg) override;
+    void writeRegister(uint8_t reg, uint8_t value) override;
+    uint8_t nextRegister(uint8_t reg) const override;
+
+    // One point of a scripted profile, linear in between
+    struct PressureSample
+    {
+        int64_t t_us;
+        float pressure;     //[hPa]
+    };
+
+    void reset();
+    void sample(int64_t t_us, bool filtered);
+    void latch(int32_t raw);
+    void pushFifo(int32_t raw);
+    bool fifoEnabled() const;
+    static float odr(uint8_t ctrl_reg1);
+
+    // Continuous mode, the sample times are computed from the start so they don't drift
+    int64_t m_start_us;
+    uint32_t m_count;
+    int64_t m_one_shot_us;      //End of the running one-shot, -1 if none
+
+    // Internal low-pass filter
+    float m_filtered;
+    bool m_filter_reset;
+
+    // BDU: the output is held from the read of PRESS_OUT_XL to the read of PRESS_OUT_H
+    bool m_held;
+    bool m_pending;
+    int32_t m_pending_raw;
+
+    // FIFO
+    int32_t m_fifo[MODEL_BARO_FIFO_SIZE];
+    int m_fifo_head;
+    int m_fifo_level;
+    bool m_fifo_overrun;
+
+    std::vector<PressureSample> m_profile;
+
+    uint32_t m_nb_samples;
+    uint32_t m_nb_reads;        //Samples read, from the output registers or the FIFO
+    uint32_t m_nb_overruns;     //Samples lost, FIFO full in stream mode or output not read
+};
+#endif
@@ -0,0 +1,828 @@
+/**
+ * @file LSM6DSLModel.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "LSM6DSLModel.hpp"
+#include "HostTime.hpp"
+#include "HostPins.hpp"
+#include "LSM6DSL_acc_gyro_driver.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+
+using namespace std;
+
+namespace
+{
+    // Register bits
+    const uint8_t FUNC_CFG_EN = 0x80;       //FUNC_CFG_ACCESS, embedded functions bank A
+    const uint8_t BDU = 0x40;               //CTRL3_C
+    const uint8_t H_LACTIVE = 0x20;
+    const uint8_t IF_INC = 0x04;
+    const uint8_t SW_RESET = 0x01;
+    const uint8_t BOOT = 0x80;
+    const uint8_t TIMER_EN = 0x20;          //CTRL10_C
+    const uint8_t PEDO_EN = 0x10;
+    const uint8_t FUNC_EN = 0x04;
+    const uint8_t PEDO_RST_STEP = 0x02;
+    const uint8_t TIMER_HR = 0x10;          //WAKE_UP_DUR, 25 us timestamp instead of 6.4 ms
+    const uint8_t FF_DUR5 = 0x80;           //WAKE_UP_DUR, high bit of the free-fall duration
+    const uint8_t INTERRUPTS_ENABLE = 0x80; //TAP_CFG
+    const uint8_t LIR = 0x01;
+    const uint8_t TIMER_PEDO_FIFO_EN = 0x80;    //FIFO_CTRL2
+    const uint8_t XLDA = 0x01;              //STATUS_REG
+    const uint8_t GDA = 0x02;
+    const uint8_t TDA = 0x04;
+    const uint8_t WU_IA = 0x08;             //WAKE_UP_SRC
+    const uint8_t WU_SOURCE = 0x0F;         //WU_IA and X_WU, Y_WU, Z_WU
+    const uint8_t FF_IA = 0x20;
+    const uint8_t STEP_DETECTED = 0x10;     //FUNC_SRC1
+    const uint8_t INT_DRDY_XL = 0x01;       //INT1_CTRL and INT2_CTRL
+    const uint8_t INT_DRDY_G = 0x02;
+    const uint8_t INT_FTH = 0x08;
+    const uint8_t INT_FIFO_OVR = 0x10;
+    const uint8_t INT_FULL_FLAG = 0x20;
+    const uint8_t INT1_STEP_DETECTOR = 0x80;
+    const uint8_t INT_FF = 0x10;            //MD1_CFG and MD2_CFG
+    const uint8_t INT_WU = 0x20;
+
+    const uint8_t FIFO_MODE_BYPASS = 0;
+    const uint8_t FIFO_MODE_FIFO = 1;       //Stops when full, the other modes are modelled as continuous
+
+    const uint8_t HELD_GYRO = 0x01;
+    const uint8_t HELD_ACC = 0x02;
+    const uint16_t FIFO_ACC_Z = 0x8000;     //Marks the last accelerometer word of a data set in m_fifo_pattern
+
+    const int DECIMATION[8] = {0, 1, 2, 3, 4, 8, 16, 32};   //0: data set not in the FIFO
+    const float FREE_FALL_MG[8] = {156.0f, 219.0f, 250.0f, 312.0f, 344.0f, 406.0f, 469.0f, 500.0f};    //FF_THS
+
+    // Synthetic motion: walking, two steps a second, with the hip swinging once a second
+    const float MOTION_STEP_HZ = 2.0f;
+    const float MOTION_GAIT_HZ = 1.0f;
+    const float MOTION_BOUNCE_MG = 450.0f;
+    const float MOTION_SWING_MDPS = 60000.0f;
+
+    int16_t saturate(float value)
+    {
+        return (int16_t)max(-32768.0f, min(32767.0f, roundf(value)));
+    }
+}
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+LSM6DSLModel::LSM6DSLModel(uint8_t address, int int1_pin, int int2_pin) : HostI2CDevice("LSM6DSL", address),
+    m_int1_pin(int1_pin), m_int2_pin(int2_pin), m_nb_acc_samples(0), m_nb_acc_reads(0){
+    reset();
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+LSM6DSLModel::~LSM6DSLModel()
+{
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Produces the samples due until now_us, called when the virtual clock moves
+ *
+ * @param now_us
+ */
+void LSM6DSLModel::update(int64_t now_us)
+{
+    if(m_next_us < 0 || now_us < m_next_us)
+    {
+        return;
+    }
+
+    while (1) {
+        float acc_odr = odr(m_registers[LSM6DSL_ACC_GYRO_CTRL1_XL] >> 4);
+        float gyro_odr = odr(m_registers[LSM6DSL_ACC_GYRO_CTRL2_G] >> 4);
+        float fifo_odr = (m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL5] & 0x07) != FIFO_MODE_BYPASS ?
+            odr((m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL5] >> 3) & 0x0F) : 0;
+
+        int64_t acc_us = (acc_odr > 0) ? m_acc_start_us + (int64_t)((m_acc_count + 1)*1e6/acc_odr) : INT64_MAX;
+        int64_t gyro_us = (gyro_odr > 0) ? m_gyro_start_us + (int64_t)((m_gyro_count + 1)*1e6/gyro_odr) : INT64_MAX;
+        int64_t fifo_us = (fifo_odr > 0) ? m_fifo_start_us + (int64_t)((m_fifo_count + 1)*1e6/fifo_odr) : INT64_MAX;
+
+        int64_t next_us = min(acc_us, min(gyro_us, fifo_us));
+        if(next_us > now_us)
+        {
+            m_next_us = (next_us == INT64_MAX) ? -1 : next_us;
+            break;
+        }
+
+        // The FIFO stores the latest samples, it comes last on equal times
+        if(acc_us == next_us)
+        {
+            m_acc_count++;
+            sampleAcc(acc_us);
+        }
+        else if(gyro_us == next_us)
+        {
+            m_gyro_count++;
+            sampleGyro(gyro_us);
+        }
+        else
+        {
+            m_fifo_count++;
+            sampleFifo(fifo_us);
+        }
+    }
+
+    refreshInterrupts();
+}
+
+/**
+ * @brief Replaces the synthetic motion by a recording, played in a loop
+ *
+ * @param path CSV file, t_us,ax,ay,az,gx,gy,gz in mg and mdps, lines that don't parse are skipped
+ * @return true if at least one sample was read
+ */
+bool LSM6DSLModel::loadMotion(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if(file == NULL)
+    {
+        fprintf(stderr, "LSM6DSL model: can't open %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        long long t_us;
+        float acc[3], gyro[3];
+        if(sscanf(line, "%lld,%f,%f,%f,%f,%f,%f", &t_us, &acc[0], &acc[1], &acc[2], &gyro[0], &gyro[1], &gyro[2]) == 7)
+        {
+            addMotion(t_us, acc, gyro);
+        }
+    }
+    fclose(file);
+
+    fprintf(stderr, "LSM6DSL model: %d motion samples from %s\n", (int)m_recording.size(), path);
+    return !m_recording.empty();
+}
+
+/**
+ * @brief Appends a sample to the recording, held until the next one. The times must increase
+ *
+ * @param t_us
+ * @param acc [mg]
+ * @param gyro [mdps]
+ */
+void LSM6DSLModel::addMotion(int64_t t_us, const float acc[3], const float gyro[3])
+{
+    MotionSample sample;
+    sample.t_us = t_us;
+    memcpy(sample.acc, acc, sizeof(sample.acc));
+    memcpy(sample.gyro, gyro, sizeof(sample.gyro));
+    m_recording.push_back(sample);
+}
+
+/**
+ * @brief Bus cost, in total and per accelerometer sample read
+ *
+ */
+void LSM6DSLModel::report() const
+{
+    HostI2CDevice::report();
+    fprintf(stderr, "%s: %lu accelerometer samples, %lu read, %.1f bytes and %.2f transfers per sample read\n",
+        m_name,
+        (unsigned long)m_nb_acc_samples,
+        (unsigned long)m_nb_acc_reads,
+        (m_nb_acc_reads > 0) ? (float)m_nb_bytes/m_nb_acc_reads : 0.0f,
+        (m_nb_acc_reads > 0) ? (float)m_nb_transfers/m_nb_acc_reads : 0.0f);
+}
+
+uint8_t LSM6DSLModel::readRegister(uint8_t reg)
+{
+    if((m_registers[LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS] & FUNC_CFG_EN) && reg != LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS)
+    {
+        return m_bank_a[reg];
+    }
+
+    uint8_t value = m_registers[reg];
+    int64_t now_us = host::now();
+
+    if(reg >= LSM6DSL_ACC_GYRO_OUTX_L_G && reg <= LSM6DSL_ACC_GYRO_OUTZ_H_XL)
+    {
+        uint8_t held = (reg < LSM6DSL_ACC_GYRO_OUTX_L_XL) ? HELD_GYRO : HELD_ACC;
+        if((reg & 0x01) == 0)
+        {
+            m_held |= held;
+        }
+        else
+        {
+            // High byte: the pair is released, the data ready flag cleared
+            m_held &= ~held;
+            m_registers[LSM6DSL_ACC_GYRO_STATUS_REG] &= (held == HELD_GYRO) ? ~GDA : ~XLDA;
+            if(held == HELD_ACC && m_acc_pending)
+            {
+                m_acc_pending = false;
+                latch(LSM6DSL_ACC_GYRO_OUTX_L_XL, m_acc_raw);
+            }
+            if(held == HELD_GYRO && m_gyro_pending)
+            {
+                m_gyro_pending = false;
+                latch(LSM6DSL_ACC_GYRO_OUTX_L_G, m_gyro_raw);
+            }
+            if(reg == LSM6DSL_ACC_GYRO_OUTZ_H_XL)
+            {
+                m_nb_acc_reads++;
+            }
+        }
+    }
+    else if(reg == LSM6DSL_ACC_GYRO_FIFO_STATUS1)
+    {
+        value = m_fifo_level & 0xFF;
+    }
+    else if(reg == LSM6DSL_ACC_GYRO_FIFO_STATUS2)
+    {
+        int threshold = m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL1] | ((m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL2] & 0x07) << 8);
+        value = ((threshold > 0 && m_fifo_level >= threshold) ? 0x80 : 0)
+            | (m_fifo_overrun ? 0x40 : 0)
+            | ((m_fifo_level >= MODEL_FIFO_WORDS - 1) ? 0x20 : 0)
+            | ((m_fifo_level == 0) ? 0x10 : 0)
+            | ((m_fifo_level >> 8) & 0x07);
+    }
+    else if(reg == LSM6DSL_ACC_GYRO_FIFO_STATUS3 || reg == LSM6DSL_ACC_GYRO_FIFO_STATUS4)
+    {
+        uint16_t pattern = (m_fifo_level > 0) ? (m_fifo_pattern[m_fifo_head] & ~FIFO_ACC_Z) : 0;
+        value = (reg == LSM6DSL_ACC_GYRO_FIFO_STATUS3) ? (pattern & 0xFF) : ((pattern >> 8) & 0x03);
+    }
+    else if(reg == LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_L || reg == LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_H)
+    {
+        value = 0;
+        if(m_fifo_level > 0)
+        {
+            uint16_t word = m_fifo[m_fifo_head];
+            value = (reg == LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_L) ? (word & 0xFF) : (word >> 8);
+
+            // The high byte pops the word
+            if(reg == LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_H)
+            {
+                if(m_fifo_pattern[m_fifo_head] & FIFO_ACC_Z)
+                {
+                    m_nb_acc_reads++;
+                }
+                m_fifo_head = (m_fifo_head + 1) % MODEL_FIFO_WORDS;
+                m_fifo_level--;
+            }
+        }
+    }
+    else if(reg >= LSM6DSL_ACC_GYRO_TIMESTAMP0_REG && reg <= LSM6DSL_ACC_GYRO_TIMESTAMP2_REG)
+    {
+        value = (timestamp(now_us) >> (8*(reg - LSM6DSL_ACC_GYRO_TIMESTAMP0_REG))) & 0xFF;
+    }
+    else if(reg == LSM6DSL_ACC_GYRO_WAKE_UP_SRC)
+    {
+        if(m_registers[LSM6DSL_ACC_GYRO_TAP_CFG1] & LIR)
+        {
+            m_registers[reg] = 0;
+        }
+    }
+    else if(reg == LSM6DSL_ACC_GYRO_FUNC_SRC)
+    {
+        m_registers[reg] &= ~STEP_DETECTED;
+    }
+
+    refreshInterrupts();
+    return value;
+}
+
+void LSM6DSLModel::writeRegister(uint8_t reg, uint8_t value)
+{
+    if((m_registers[LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS] & FUNC_CFG_EN) && reg != LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS)
+    {
+        m_bank_a[reg] = value;
+        return;
+    }
+
+    int64_t now_us = host::now();
+    uint8_t previous = m_registers[reg];
+
+    switch (reg) {
+    // Read-only
+    case LSM6DSL_ACC_GYRO_WHO_AM_I_REG:
+    case LSM6DSL_ACC_GYRO_WAKE_UP_SRC:
+    case LSM6DSL_ACC_GYRO_TAP_SRC:
+    case LSM6DSL_ACC_GYRO_D6D_SRC:
+    case LSM6DSL_ACC_GYRO_STATUS_REG:
+    case LSM6DSL_ACC_GYRO_FUNC_SRC:
+        return;
+
+    case LSM6DSL_ACC_GYRO_CTRL1_XL:
+        m_registers[reg] = value;
+        if((value ^ previous) & 0xF0)
+        {
+            m_acc_start_us = now_us;
+            m_acc_count = 0;
+        }
+        break;
+
+    case LSM6DSL_ACC_GYRO_CTRL2_G:
+        m_registers[reg] = value;
+        if((value ^ previous) & 0xF0)
+        {
+            m_gyro_start_us = now_us;
+            m_gyro_count = 0;
+        }
+        break;
+
+    case LSM6DSL_ACC_GYRO_CTRL3_C:
+        if(value & SW_RESET)
+        {
+            reset();
+            return;
+        }
+        m_registers[reg] = value & ~BOOT;
+        break;
+
+    case LSM6DSL_ACC_GYRO_FIFO_CTRL5:
+        m_registers[reg] = value;
+        if((value & 0x07) == FIFO_MODE_BYPASS)
+        {
+            m_fifo_head = 0;
+            m_fifo_level = 0;
+            m_fifo_overrun = false;
+        }
+        if(value != previous)
+        {
+            m_fifo_start_us = now_us;
+            m_fifo_count = 0;
+            m_pattern_index = 0;
+        }
+        break;
+
+    case LSM6DSL_ACC_GYRO_CTRL10_C:
+        m_registers[reg] = value;
+        if(value & PEDO_RST_STEP)
+        {
+            m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_L] = 0;
+            m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_H] = 0;
+        }
+        if((value & TIMER_EN) && !(previous & TIMER_EN))
+        {
+            m_timestamp_start_us = now_us;
+        }
+        break;
+
+    case LSM6DSL_ACC_GYRO_TIMESTAMP2_REG:
+        if(value == 0xAA)
+        {
+            m_timestamp_start_us = now_us;
+        }
+        return;
+
+    default:
+        if((reg >= LSM6DSL_ACC_GYRO_OUT_TEMP_L && reg <= LSM6DSL_ACC_GYRO_OUTZ_H_XL)
+            || (reg >= LSM6DSL_ACC_GYRO_FIFO_STATUS1 && reg <= LSM6DSL_ACC_GYRO_TIMESTAMP1_REG)
+            || (reg >= LSM6DSL_ACC_GYRO_TIMESTAMP_L && reg <= LSM6DSL_ACC_GYRO_STEP_COUNTER_H))
+        {
+            return;
+        }
+        m_registers[reg] = value;
+        break;
+    }
+
+    schedule(now_us);
+    refreshInterrupts();
+}
+
+/**
+ * @brief IF_INC, and the FIFO output rolls back from DATA_OUT_H to DATA_OUT_L for burst reads
+ *
+ * @param reg
+ * @return uint8_t
+ */
+uint8_t LSM6DSLModel::nextRegister(uint8_t reg) const
+{
+    if(!(m_registers[LSM6DSL_ACC_GYRO_CTRL3_C] & IF_INC))
+    {
+        return reg;
+    }
+    if(reg == LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_H && !(m_registers[LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS] & FUNC_CFG_EN))
+    {
+        return LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_L;
+    }
+    return reg + 1;
+}
+
+/**
+ * @brief Power-on state
+ *
+ */
+void LSM6DSLModel::reset()
+{
+    memset(m_registers, 0, sizeof(m_registers));
+    memset(m_bank_a, 0, sizeof(m_bank_a));
+    m_registers[LSM6DSL_ACC_GYRO_WHO_AM_I_REG] = LSM6DSL_ACC_GYRO_WHO_AM_I;
+    m_registers[LSM6DSL_ACC_GYRO_CTRL3_C] = IF_INC;
+    m_bank_a[LSM6DSL_ACC_GYRO_CONFIG_PEDO_THS_MIN] = 0x10;
+    m_bank_a[LSM6DSL_ACC_GYRO_PEDO_DEB_REG] = 0x6E;
+
+    m_acc_start_us = m_gyro_start_us = m_fifo_start_us = 0;
+    m_acc_count = m_gyro_count = m_fifo_count = 0;
+    m_next_us = -1;
+    m_timestamp_start_us = 0;
+
+    m_held = 0;
+    memset(m_acc_raw, 0, sizeof(m_acc_raw));
+    memset(m_gyro_raw, 0, sizeof(m_gyro_raw));
+    m_acc_pending = false;
+    m_gyro_pending = false;
+
+    m_fifo_head = 0;
+    m_fifo_level = 0;
+    m_fifo_overrun = false;
+    m_pattern_index = 0;
+
+    memset(m_last_acc, 0, sizeof(m_last_acc));
+    m_free_fall_count = 0;
+    m_step_above = false;
+    m_last_step_us = -MODEL_STEP_MIN_US;
+    m_step_pulse = false;
+}
+
+/**
+ * @brief Motion at one time, from the recording if one is loaded
+ *
+ * @param t_us
+ * @param acc [mg]
+ * @param gyro [mdps]
+ */
+void LSM6DSLModel::motion(int64_t t_us, float acc[3], float gyro[3]) const
+{
+    if(!m_recording.empty())
+    {
+        int64_t duration_us = m_recording.back().t_us + 1;
+        int64_t t = t_us % duration_us;
+        auto sample = upper_bound(m_recording.begin(), m_recording.end(), t,
+            [](int64_t time, const MotionSample &s){ return time < s.t_us; });
+        if(sample != m_recording.begin())
+        {
+            sample--;
+        }
+        memcpy(acc, sample->acc, 3*sizeof(float));
+        memcpy(gyro, sample->gyro, 3*sizeof(float));
+        return;
+    }
+
+    float t = t_us/1e6f;
+    float step = 2.0f*(float)M_PI*MOTION_STEP_HZ*t;
+    float gait = 2.0f*(float)M_PI*MOTION_GAIT_HZ*t;
+
+    acc[0] = 200.0f*sinf(gait);
+    acc[1] = 100.0f*sinf(step);
+    acc[2] = 1000.0f + MOTION_BOUNCE_MG*sinf(step);
+    gyro[0] = MOTION_SWING_MDPS*sinf(gait);
+    gyro[1] = 10000.0f*cosf(gait);
+    gyro[2] = 5000.0f*sinf(step);
+}
+
+void LSM6DSLModel::sampleAcc(int64_t t_us)
+{
+    float acc[3], gyro[3];
+    motion(t_us, acc, gyro);
+
+    float sensitivity = accSensitivity();
+    for(int i = 0; i < 3; i++)
+    {
+        m_acc_raw[i] = saturate(acc[i]/sensitivity);
+    }
+    latch(LSM6DSL_ACC_GYRO_OUTX_L_XL, m_acc_raw);
+    m_registers[LSM6DSL_ACC_GYRO_STATUS_REG] |= XLDA | TDA;
+    m_nb_acc_samples++;
+
+    m_step_pulse = false;
+    detectStep(acc, t_us);
+    detectWakeUp(acc);
+    detectFreeFall(acc);
+}
+
+void LSM6DSLModel::sampleGyro(int64_t t_us)
+{
+    float acc[3], gyro[3];
+    motion(t_us, acc, gyro);
+
+    float sensitivity = gyroSensitivity();
+    for(int i = 0; i < 3; i++)
+    {
+        m_gyro_raw[i] = saturate(gyro[i]/sensitivity);
+    }
+    latch(LSM6DSL_ACC_GYRO_OUTX_L_G, m_gyro_raw);
+    m_registers[LSM6DSL_ACC_GYRO_STATUS_REG] |= GDA | TDA;
+}
+
+/**
+ * @brief One FIFO tick: gyroscope, accelerometer then timestamp and steps, each at its decimation
+ *
+ * @param t_us
+ */
+void LSM6DSLModel::sampleFifo(int64_t t_us)
+{
+    int gyro_decimation = DECIMATION[(m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL3] >> 3) & 0x07];
+    int acc_decimation = DECIMATION[m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL3] & 0x07];
+    int ds4_decimation = (m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL2] & TIMER_PEDO_FIFO_EN) ?
+        DECIMATION[(m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL4] >> 3) & 0x07] : 0;
+
+    // The pattern starts again once every data set went through its decimation
+    int cycle = 1;
+    for(int decimation : {gyro_decimation, acc_decimation, ds4_decimation})
+    {
+        if(decimation > 0)
+        {
+            int a = cycle, b = decimation;
+            while (b != 0) { int r = a % b; a = b; b = r; }
+            cycle = cycle/a*decimation;
+        }
+    }
+    uint32_t tick = m_fifo_count - 1;
+    if(tick % cycle == 0)
+    {
+        m_pattern_index = 0;
+    }
+
+    if(gyro_decimation > 0 && tick % gyro_decimation == 0)
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            pushFifo((uint16_t)m_gyro_raw[i]);
+        }
+    }
+    if(acc_decimation > 0 && tick % acc_decimation == 0)
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            pushFifo((uint16_t)m_acc_raw[i]);
+        }
+        int last = (m_fifo_head + m_fifo_level - 1) % MODEL_FIFO_WORDS;
+        m_fifo_pattern[last] |= FIFO_ACC_Z;
+    }
+    if(ds4_decimation > 0 && tick % ds4_decimation == 0)
+    {
+        uint32_t time = timestamp(t_us);
+        uint16_t steps = m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_L] | (m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_H] << 8);
+        pushFifo((uint16_t)(((time >> 8) & 0xFF) | (((time >> 16) & 0xFF) << 8)));
+        pushFifo((uint16_t)((time & 0xFF) << 8));
+        pushFifo(steps);
+    }
+}
+
+/**
+ * @brief Writes a sample to the output registers, or keeps it pending while BDU holds them
+ *
+ * @param first_reg
+ * @param raw
+ */
+void LSM6DSLModel::latch(uint8_t first_reg, const int16_t raw[3])
+{
+    uint8_t held = (first_reg == LSM6DSL_ACC_GYRO_OUTX_L_G) ? HELD_GYRO : HELD_ACC;
+    if((m_registers[LSM6DSL_ACC_GYRO_CTRL3_C] & BDU) && (m_held & held))
+    {
+        if(held == HELD_GYRO) m_gyro_pending = true;
+        else m_acc_pending = true;
+        return;
+    }
+
+    for(int i = 0; i < 3; i++)
+    {
+        m_registers[first_reg + 2*i] = raw[i] & 0xFF;
+        m_registers[first_reg + 2*i + 1] = (raw[i] >> 8) & 0xFF;
+    }
+}
+
+void LSM6DSLModel::pushFifo(uint16_t word)
+{
+    if(m_fifo_level == MODEL_FIFO_WORDS)
+    {
+        if((m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL5] & 0x07) == FIFO_MODE_FIFO)
+        {
+            return;
+        }
+        m_fifo_head = (m_fifo_head + 1) % MODEL_FIFO_WORDS;
+        m_fifo_level--;
+        m_fifo_overrun = true;
+    }
+
+    int tail = (m_fifo_head + m_fifo_level) % MODEL_FIFO_WORDS;
+    m_fifo[tail] = word;
+    m_fifo_pattern[tail] = m_pattern_index++;
+    m_fifo_level++;
+}
+
+/**
+ * @brief Peak of the acceleration norm above the threshold of CONFIG_PEDO_THS_MIN
+ *
+ * @param acc [mg]
+ * @param t_us
+ */
+void LSM6DSLModel::detectStep(const float acc[3], int64_t t_us)
+{
+    uint8_t ctrl10 = m_registers[LSM6DSL_ACC_GYRO_CTRL10_C];
+    if(!(ctrl10 & FUNC_EN) || !(ctrl10 & PEDO_EN))
+    {
+        return;
+    }
+
+    uint8_t ths = m_bank_a[LSM6DSL_ACC_GYRO_CONFIG_PEDO_THS_MIN];
+    float threshold_mg = (ths & 0x1F)*((ths & 0x80) ? 32.0f : 16.0f);
+    float dynamic_mg = sqrtf(acc[0]*acc[0] + acc[1]*acc[1] + acc[2]*acc[2]) - 1000.0f;
+
+    if(!m_step_above && dynamic_mg > threshold_mg && t_us - m_last_step_us >= MODEL_STEP_MIN_US)
+    {
+        m_step_above = true;
+        m_last_step_us = t_us;
+        m_step_pulse = true;
+
+        uint16_t steps = m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_L] | (m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_H] << 8);
+        steps++;
+        m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_L] = steps & 0xFF;
+        m_registers[LSM6DSL_ACC_GYRO_STEP_COUNTER_H] = steps >> 8;
+
+        uint32_t time = timestamp(t_us);
+        m_registers[LSM6DSL_ACC_GYRO_TIMESTAMP_L] = time & 0xFF;
+        m_registers[LSM6DSL_ACC_GYRO_TIMESTAMP_H] = (time >> 8) & 0xFF;
+        m_registers[LSM6DSL_ACC_GYRO_FUNC_SRC] |= STEP_DETECTED;
+    }
+    else if(m_step_above && dynamic_mg < threshold_mg/2)
+    {
+        m_step_above = false;
+    }
+}
+
+/**
+ * @brief Slope of the acceleration above WAKE_UP_THS, 1 LSB = full scale/64
+ *
+ * @param acc [mg]
+ */
+void LSM6DSLModel::detectWakeUp(const float acc[3])
+{
+    if(!(m_registers[LSM6DSL_ACC_GYRO_TAP_CFG1] & INTERRUPTS_ENABLE))
+    {
+        memcpy(m_last_acc, acc, sizeof(m_last_acc));
+        return;
+    }
+
+    float full_scale_mg = accSensitivity()*32768.0f;
+    float threshold_mg = (m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_THS] & 0x3F)*full_scale_mg/64.0f;
+
+    uint8_t source = 0;
+    for(int i = 0; i < 3; i++)
+    {
+        if(fabsf(acc[i] - m_last_acc[i]) > threshold_mg)
+        {
+            source |= 0x04 >> i;    //X_WU, Y_WU, Z_WU
+        }
+    }
+    memcpy(m_last_acc, acc, sizeof(m_last_acc));
+
+    if(source != 0)
+    {
+        m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_SRC] = (m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_SRC] & ~WU_SOURCE) | WU_IA | source;
+    }
+    else if(!(m_registers[LSM6DSL_ACC_GYRO_TAP_CFG1] & LIR))
+    {
+        m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_SRC] &= ~WU_SOURCE;
+    }
+}
+
+/**
+ * @brief Every axis under FF_THS for FF_DUR samples
+ *
+ * @param acc [mg]
+ */
+void LSM6DSLModel::detectFreeFall(const float acc[3])
+{
+    if(!(m_registers[LSM6DSL_ACC_GYRO_TAP_CFG1] & INTERRUPTS_ENABLE))
+    {
+        m_free_fall_count = 0;
+        return;
+    }
+
+    float threshold_mg = FREE_FALL_MG[m_registers[LSM6DSL_ACC_GYRO_FREE_FALL] & 0x07];
+    int duration = (m_registers[LSM6DSL_ACC_GYRO_FREE_FALL] >> 3) | ((m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_DUR] & FF_DUR5) ? 0x20 : 0);
+    bool falling = fabsf(acc[0]) < threshold_mg && fabsf(acc[1]) < threshold_mg && fabsf(acc[2]) < threshold_mg;
+    m_free_fall_count = falling ? m_free_fall_count + 1 : 0;
+
+    if(falling && m_free_fall_count >= max(duration, 1))
+    {
+        m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_SRC] |= FF_IA;
+    }
+    else if(!(m_registers[LSM6DSL_ACC_GYRO_TAP_CFG1] & LIR))
+    {
+        m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_SRC] &= ~FF_IA;
+    }
+}
+
+/**
+ * @brief Time of the next sample after a configuration change
+ *
+ * @param now_us
+ */
+void LSM6DSLModel::schedule(int64_t now_us)
+{
+    m_next_us = now_us;
+    update(now_us);
+}
+
+/**
+ * @brief Levels of INT1 and INT2 from their routed sources
+ *
+ */
+void LSM6DSLModel::refreshInterrupts()
+{
+    uint8_t status = m_registers[LSM6DSL_ACC_GYRO_STATUS_REG];
+    int threshold = m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL1] | ((m_registers[LSM6DSL_ACC_GYRO_FIFO_CTRL2] & 0x07) << 8);
+    uint8_t sources = ((status & XLDA) ? INT_DRDY_XL : 0)
+        | ((status & GDA) ? INT_DRDY_G : 0)
+        | ((threshold > 0 && m_fifo_level >= threshold) ? INT_FTH : 0)
+        | (m_fifo_overrun ? INT_FIFO_OVR : 0)
+        | ((m_fifo_level >= MODEL_FIFO_WORDS - 1) ? INT_FULL_FLAG : 0);
+    bool wake_up = (m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_SRC] & WU_IA) != 0;
+    bool free_fall = (m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_SRC] & FF_IA) != 0;
+
+    bool int1 = (m_registers[LSM6DSL_ACC_GYRO_INT1_CTRL] & (sources & ~INT1_STEP_DETECTOR))
+        || ((m_registers[LSM6DSL_ACC_GYRO_INT1_CTRL] & INT1_STEP_DETECTOR) && m_step_pulse)
+        || ((m_registers[LSM6DSL_ACC_GYRO_MD1_CFG] & INT_WU) && wake_up)
+        || ((m_registers[LSM6DSL_ACC_GYRO_MD1_CFG] & INT_FF) && free_fall);
+    bool int2 = (m_registers[LSM6DSL_ACC_GYRO_INT2_CTRL] & sources & (INT_DRDY_XL | INT_DRDY_G | INT_FTH | INT_FIFO_OVR | INT_FULL_FLAG))
+        || ((m_registers[LSM6DSL_ACC_GYRO_MD2_CFG] & INT_WU) && wake_up)
+        || ((m_registers[LSM6DSL_ACC_GYRO_MD2_CFG] & INT_FF) && free_fall);
+
+    bool active_low = (m_registers[LSM6DSL_ACC_GYRO_CTRL3_C] & H_LACTIVE) != 0;
+    host::setPin(m_int1_pin, int1 != active_low);
+    host::setPin(m_int2_pin, int2 != active_low);
+}
+
+/**
+ * @brief 24 bits counter, 25 us or 6.4 ms a tick
+ *
+ * @param t_us
+ * @return 0 if the timestamp is off
+ */
+uint32_t LSM6DSLModel::timestamp(int64_t t_us) const
+{
+    if(!(m_registers[LSM6DSL_ACC_GYRO_CTRL10_C] & TIMER_EN))
+    {
+        return 0;
+    }
+    int64_t resolution_us = (m_registers[LSM6DSL_ACC_GYRO_WAKE_UP_DUR] & TIMER_HR) ? 25 : 6400;
+    return (uint32_t)((t_us - m_timestamp_start_us)/resolution_us) & 0xFFFFFF;
+}
+
+/**
+ * @brief [mg/LSB]
+ *
+ */
+float LSM6DSLModel::accSensitivity() const
+{
+    const float sensitivities[4] = {0.061f, 0.488f, 0.122f, 0.244f};   //2, 16, 4, 8 g
+    return sensitivities[(m_registers[LSM6DSL_ACC_GYRO_CTRL1_XL] >> 2) & 0x03];
+}
+
+/**
+ * @brief [mdps/LSB]
+ *
+ */
+float LSM6DSLModel::gyroSensitivity() const
+{
+    const float sensitivities[4] = {8.75f, 17.5f, 35.0f, 70.0f};        //250, 500, 1000, 2000 dps
+    uint8_t ctrl2 = m_registers[LSM6DSL_ACC_GYRO_CTRL2_G];
+    return (ctrl2 & 0x02) ? 4.375f : sensitivities[(ctrl2 >> 2) & 0x03];
+}
+
+/**
+ * @brief ODR field of CTRL1_XL, CTRL2_G and FIFO_CTRL5
+ *
+ * @param code
+ * @return [Hz], 0 in power-down
+ */
+float LSM6DSLModel::odr(uint8_t code)
+{
+    const float rates[16] = {0, 12.5f, 26, 52, 104, 208, 416, 833, 1660, 3330, 6660, 1.6f, 0, 0, 0, 0};
+    return rates[code & 0x0F];
+}
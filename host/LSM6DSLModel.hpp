@@ -0,0 +1,112 @@
+/**
+ * @file LSM6DSLModel.hpp
+ * @author Corentin BENOIT
+ * @brief Register level model of the LSM6DSL for the host build, fed from synthetic or recorded motion
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_LSM6DSLMODEL
+#define DEF_LSM6DSLMODEL
+
+#include <cstdint>
+#include <vector>
+#include "HostI2CDevice.hpp"
+
+const int MODEL_FIFO_WORDS = 2048;              //4 kB FIFO
+const int64_t MODEL_STEP_MIN_US = 200000;       //Shortest time between two steps
+
+
+/**
+ * @brief Models the output registers at the configured ODR and full scale, BDU, auto-increment,
+ * the FIFO with its pattern and decimation, the timestamp counter, the pedometer, the wake-up and free-fall detections
+ * and the INT1/INT2 pins. Updated by the virtual clock
+ */
+class LSM6DSLModel : public HostI2CDevice
+{
+public:
+    // Constructor
+    LSM6DSLModel(uint8_t address, int int1_pin, int int2_pin);
+
+    // Destructor
+    ~LSM6DSLModel();
+
+
+    //Methods
+    void update(int64_t now_us);
+    bool loadMotion(const char *path);
+    void addMotion(int64_t t_us, const float acc[3], const float gyro[3]);
+    void report() const override;
+
+
+
+protected:
+    uint8_t readRegister(uint8_t reg) override;
+    void writeRegister(uint8_t reg, uint8_t value) override;
+    uint8_t nextRegister(uint8_t reg) const override;
+
+    // One line of a recording, t_us,ax,ay,az,gx,gy,gz in mg and mdps
+    struct MotionSample
+    {
+        int64_t t_us;
+        float acc[3];
+        float gyro[3];
+    };
+
+    void reset();
+    void motion(int64_t t_us, float acc[3], float gyro[3]) const;
+    void sampleAcc(int64_t t_us);
+    void sampleGyro(int64_t t_us);
+    void sampleFifo(int64_t t_us);
+    void latch(uint8_t first_reg, const int16_t raw[3]);
+    void pushFifo(uint16_t word);
+    void detectStep(const float acc[3], int64_t t_us);
+    void detectWakeUp(const float acc[3]);
+    void detectFreeFall(const float acc[3]);
+    void schedule(int64_t now_us);
+    void refreshInterrupts();
+    uint32_t timestamp(int64_t t_us) const;
+    float accSensitivity() const;
+    float gyroSensitivity() const;
+    static float odr(uint8_t code);
+
+    int m_int1_pin;
+    int m_int2_pin;
+    uint8_t m_bank_a[HOST_NB_REGISTERS];    //Embedded functions registers
+
+    // Output data rates, the sample times are computed from the start so they don't drift
+    int64_t m_acc_start_us, m_gyro_start_us, m_fifo_start_us;
+    uint32_t m_acc_count, m_gyro_count, m_fifo_count;
+    int64_t m_next_us;          //Earliest of the next samples, -1 if everything is powered down
+    int64_t m_timestamp_start_us;
+
+    // BDU: a pair is held from the read of its low byte to the read of its high byte
+    uint8_t m_held;             //Bit 0 gyroscope, bit 1 accelerometer
+    int16_t m_acc_raw[3], m_gyro_raw[3];
+    bool m_acc_pending, m_gyro_pending;
+
+    // FIFO
+    uint16_t m_fifo[MODEL_FIFO_WORDS];
+    uint16_t m_fifo_pattern[MODEL_FIFO_WORDS];
+    int m_fifo_head;
+    int m_fifo_level;
+    bool m_fifo_overrun;
+    uint16_t m_pattern_index;
+
+    // Embedded functions
+    float m_last_acc[3];
+    int m_free_fall_count;      //Samples in a row under the free-fall threshold
+    bool m_step_above;
+    int64_t m_last_step_us;
+    bool m_step_pulse;
+
+    std::vector<MotionSample> m_recording;
+
+    // Bus cost per sample
+    uint32_t m_nb_acc_samples;
+    uint32_t m_nb_acc_reads;    //Accelerometer samples read, from the output registers or the FIFO
+};
+#endif
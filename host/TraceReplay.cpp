@@ -0,0 +1,182 @@
+/**
+ * @file TraceReplay.cpp
+ * @author Corentin BENOIT
+ * @brief
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "TraceReplay.hpp"
+#include "SensorTrace.hpp"
+#include <algorithm>
+#include <cstdio>
+
+
+
+using namespace std;
+
+/*
+----------------------------------------------------------
+----------------CONSTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+TraceReplay::TraceReplay() : m_end_us(0){
+}
+
+
+/*
+----------------------------------------------------------
+----------------DESTRUCTOR------------------------------
+----------------------------------------------------------
+*/
+
+TraceReplay::~TraceReplay()
+{
+}
+
+/*
+----------------------------------------------------------
+-------------------ASSESSORS------------------------------
+----------------------------------------------------------
+*/
+
+int64_t TraceReplay::getEnd() const{
+    return m_end_us;
+}
+
+bool TraceReplay::isLoaded() const{
+    return !m_touch.empty();
+}
+
+
+/*
+----------------------------------------------------------
+----------------------------METHODS-----------------------
+----------------------------------------------------------
+*/
+
+/**
+ * @brief Decodes the whole trace. The IMU samples go to the model, converted back with the sensitivities of the header,
+ * so they come out bit-exact when the full scales are the same
+ *
+ * @param path
+ * @param offset_us added to the timestamps of the trace to get the virtual time
+ * @param imu
+ * @return true if at least one sample was decoded
+ */
+bool TraceReplay::load(const char *path, int64_t offset_us, LSM6DSLModel &imu)
+{
+    FILE *file = fopen(path, "rb");
+    if(file == NULL)
+    {
+        fprintf(stderr, "Trace replay: can't open %s\n", path);
+        return false;
+    }
+
+    SensorTrace decoder;
+    bool header = false;
+    uint32_t nb_samples = 0;
+    uint32_t last_timestamp = 0;
+    int64_t trace_us = 0;       //Unwrapped timestamp
+    int64_t last_imu_us = INT64_MIN;
+    int c;
+
+    while ((c = fgetc(file)) != EOF) {
+        TraceFrameType type = decoder.push((uint8_t)c);
+        if(type == TRACE_HEADER)
+        {
+            header = true;
+        }
+        if(type != TRACE_SAMPLE || !header)
+        {
+            continue;
+        }
+
+        const TraceHeader &settings = decoder.getHeader();
+        const TraceSample &sample = decoder.getSample();
+        trace_us += (nb_samples > 0) ? (uint32_t)(sample.timestamp_us - last_timestamp) : sample.timestamp_us;
+        last_timestamp = sample.timestamp_us;
+        nb_samples++;
+
+        int64_t tick_us = offset_us + trace_us;
+        append(m_pot_right, tick_us - sample.pot_age_us, sample.pot_right);
+        append(m_pot_left, tick_us - sample.pot_age_us, sample.pot_left);
+        append(m_touch, tick_us - sample.touch_age_us, sample.touch);
+
+        // One IMU period early, so the model has produced the sample when the firmware reads it
+        int64_t imu_us = tick_us - sample.imu_age_us - (int64_t)(1e6/settings.imu_freq);
+        if(imu_us > last_imu_us)
+        {
+            float acc[3], gyro[3];
+            for(int i = 0; i < 3; i++)
+            {
+                acc[i] = sample.acc[i]*settings.acc_sensitivity;
+                gyro[i] = sample.gyro[i]*settings.gyro_sensitivity;
+            }
+            imu.addMotion(imu_us, acc, gyro);
+            last_imu_us = imu_us;
+        }
+        m_end_us = tick_us;
+    }
+    fclose(file);
+
+    fprintf(stderr, "Trace replay: %lu samples up to %.1f s, %lu bad frames from %s\n",
+        (unsigned long)nb_samples, trace_us/1e6, (unsigned long)decoder.getNbErrors(), path);
+    return nb_samples > 0;
+}
+
+float TraceReplay::potRight(int64_t now_us) const
+{
+    return lookup(m_pot_right, now_us);
+}
+
+float TraceReplay::potLeft(int64_t now_us) const
+{
+    return lookup(m_pot_left, now_us);
+}
+
+float TraceReplay::touch(int64_t now_us) const
+{
+    return lookup(m_touch, now_us);
+}
+
+/**
+ * @brief Value held at now_us, the first one before the trace starts
+ *
+ * @param points
+ * @param now_us
+ * @return [0; 1], as read by AnalogIn
+ */
+float TraceReplay::lookup(const vector<AdcPoint> &points, int64_t now_us)
+{
+    if(points.empty())
+    {
+        return 0.0f;
+    }
+    auto point = upper_bound(points.begin(), points.end(), now_us,
+        [](int64_t time, const AdcPoint &p){ return time < p.t_us; });
+    if(point != points.begin())
+    {
+        point--;
+    }
+    return point->value/65535.0f;
+}
+
+/**
+ * @brief A channel slower than the output repeats its value, only the reads are kept
+ *
+ * @param points
+ * @param t_us
+ * @param value
+ */
+void TraceReplay::append(vector<AdcPoint> &points, int64_t t_us, uint16_t value)
+{
+    if(!points.empty() && t_us <= points.back().t_us)
+    {
+        return;
+    }
+    points.push_back({t_us, value});
+}
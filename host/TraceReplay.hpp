@@ -0,0 +1,63 @@
+/**
+ * @file TraceReplay.hpp
+ * @author Corentin BENOIT
+ * @brief Replays a binary trace of the device into the LSM6DSL model and the analog inputs of the host build
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_TRACEREPLAY
+#define DEF_TRACEREPLAY
+
+#include <cstdint>
+#include <vector>
+#include "LSM6DSLModel.hpp"
+
+
+/**
+ * @brief Loads a trace captured with "fmt trace", the text printed in between is skipped.
+ * The timestamps of the trace are the ones of the firmware timer, shifted by offset_us on the virtual clock.
+ * Every channel holds its value until the next one, the first one before the trace starts
+ */
+class TraceReplay
+{
+public:
+    // Constructor
+    TraceReplay();
+
+    // Destructor
+    ~TraceReplay();
+
+
+    // Assessors
+    int64_t getEnd() const;
+    bool isLoaded() const;
+
+    //Methods
+    bool load(const char *path, int64_t offset_us, LSM6DSLModel &imu);
+    float potRight(int64_t now_us) const;
+    float potLeft(int64_t now_us) const;
+    float touch(int64_t now_us) const;
+
+
+
+protected:
+    // ADC value from t_us on
+    struct AdcPoint
+    {
+        int64_t t_us;
+        uint16_t value;
+    };
+
+    static float lookup(const std::vector<AdcPoint> &points, int64_t now_us);
+    static void append(std::vector<AdcPoint> &points, int64_t t_us, uint16_t value);
+
+    std::vector<AdcPoint> m_pot_right;
+    std::vector<AdcPoint> m_pot_left;
+    std::vector<AdcPoint> m_touch;
+    int64_t m_end_us;
+};
+#endif
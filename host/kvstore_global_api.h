@@ -0,0 +1,30 @@
+/**
+ * @file kvstore_global_api.h
+ * @author Corentin BENOIT
+ * @brief Host stand-in for the global KVStore API of mbed OS: kv_set and kv_get, in files of HOST_KV_DIR or in memory
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOST_KVSTORE_GLOBAL_API
+#define DEF_HOST_KVSTORE_GLOBAL_API
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef MBED_SUCCESS
+#define MBED_SUCCESS 0
+#endif
+// Host values, the firmware only compares the status with MBED_SUCCESS
+#define MBED_ERROR_ITEM_NOT_FOUND (-1)
+#define MBED_ERROR_INVALID_SIZE (-2)
+#define MBED_ERROR_MEDIA_FULL (-3)
+#define MBED_ERROR_WRITE_FAILED (-4)
+
+int kv_set(const char *full_name_key, const void *buffer, size_t size, uint32_t create_flags);
+int kv_get(const char *full_name_key, void *buffer, size_t buffer_size, size_t *actual_size);
+
+#endif
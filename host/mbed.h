@@ -0,0 +1,423 @@
+/**
+ * @file mbed.h
+ * @author Corentin BENOIT
+ * @brief Host stand-in for the part of mbed OS used by the firmware, on the virtual clock of HostTime
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOST_MBED
+#define DEF_HOST_MBED
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <unistd.h>
+
+#include "HostTime.hpp"
+#include "HostPins.hpp"
+
+// Pins of the B-L4S5I board used by the firmware
+typedef enum
+{
+    PB_10, PB_11, PD_11, PD_12,
+    A0, A1, A2, A3, A4, A5,
+    D10, D11, D12, D13,
+    LED1, LED2, BUTTON1,
+    ARDUINO_UNO_A1 = A1,
+    ARDUINO_UNO_A2 = A2,
+    NC = -1,
+} PinName;
+
+enum PinMode
+{
+    PullNone,
+    PullUp,
+    PullDown,
+};
+
+typedef enum
+{
+    osPriorityIdle = 1,
+    osPriorityLow = 8,
+    osPriorityBelowNormal = 16,
+    osPriorityNormal = 24,
+    osPriorityAboveNormal = 32,
+    osPriorityHigh = 40,
+    osPriorityRealtime = 48,
+} osPriority_t;
+typedef osPriority_t osPriority;
+
+typedef int32_t osStatus;
+const osStatus osOK = 0;
+const uint32_t osWaitForever = 0xFFFFFFFF;
+const uint32_t osFlagsError = 0x80000000;
+const uint32_t osFlagsErrorTimeout = 0xFFFFFFFE;
+
+#define OS_STACK_SIZE 4096
+#define MBED_ALIGN(N) __attribute__((aligned(N)))
+
+namespace mbed
+{
+    template <typename F>
+    class Callback;
+
+    /**
+     * @brief Function, lambda or object and method
+     */
+    template <typename R, typename... A>
+    class Callback<R(A...)>
+    {
+    public:
+        Callback() {}
+        Callback(std::nullptr_t) {}
+        Callback(R (*function)(A...)) {
+            if(function != NULL) m_function = function;
+        }
+        template <typename F, typename = decltype(std::declval<F>()(std::declval<A>()...))>
+        Callback(F function) : m_function(function) {}
+        template <typename T, typename U>
+        Callback(U *object, R (T::*method)(A...)) : m_function([object, method](A... args) { return (object->*method)(args...); }) {}
+        template <typename T, typename U>
+        Callback(const U *object, R (T::*method)(A...) const) : m_function([object, method](A... args) { return (object->*method)(args...); }) {}
+
+        R call(A... args) const {
+            return m_function(args...);
+        }
+        R operator()(A... args) const {
+            return m_function(args...);
+        }
+        explicit operator bool() const {
+            return (bool)m_function;
+        }
+
+    private:
+        std::function<R(A...)> m_function;
+    };
+
+    template <typename R, typename... A>
+    Callback<R(A...)> callback(R (*function)(A...)) {
+        return Callback<R(A...)>(function);
+    }
+
+    template <typename T, typename U, typename R, typename... A>
+    Callback<R(A...)> callback(U *object, R (T::*method)(A...)) {
+        return Callback<R(A...)>(object, method);
+    }
+
+    template <typename T, typename U, typename R, typename... A>
+    Callback<R(A...)> callback(const U *object, R (T::*method)(A...) const) {
+        return Callback<R(A...)>(object, method);
+    }
+
+    /**
+     * @brief Stopwatch on the virtual clock
+     */
+    class Timer
+    {
+    public:
+        Timer() : m_running(false), m_start_us(0), m_elapsed_us(0) {}
+        void start();
+        void stop();
+        void reset();
+        std::chrono::microseconds elapsed_time() const;
+        int read_us() const {
+            return (int)elapsed_time().count();
+        }
+        float read() const {
+            return elapsed_time().count()/1000000.0f;
+        }
+
+    private:
+        bool m_running;
+        int64_t m_start_us;
+        int64_t m_elapsed_us;
+    };
+
+    // Deep sleep doesn't exist on the host
+    class LowPowerTimer : public Timer {};
+
+    class DigitalIn
+    {
+    public:
+        DigitalIn(PinName pin) : m_pin(pin) {}
+        DigitalIn(PinName pin, PinMode mode) : m_pin(pin) {}
+        int read() {
+            return host::getPin(m_pin);
+        }
+        void mode(PinMode pull) {}
+        int is_connected() {
+            return m_pin != NC;
+        }
+        operator int() {
+            return read();
+        }
+
+    private:
+        PinName m_pin;
+    };
+
+    class DigitalOut
+    {
+    public:
+        DigitalOut(PinName pin, int value = 0) : m_pin(pin) {
+            write(value);
+        }
+        void write(int value) {
+            host::setPin(m_pin, value);
+        }
+        int read() {
+            return host::getPin(m_pin);
+        }
+        DigitalOut &operator=(int value) {
+            write(value);
+            return *this;
+        }
+        operator int() {
+            return read();
+        }
+
+    private:
+        PinName m_pin;
+    };
+
+    class AnalogIn
+    {
+    public:
+        AnalogIn(PinName pin) : m_pin(pin) {}
+        float read() {
+            return host::getAnalog(m_pin);
+        }
+        uint16_t read_u16() {
+            return (uint16_t)(read()*65535.0f + 0.5f);
+        }
+        operator float() {
+            return read();
+        }
+
+    private:
+        PinName m_pin;
+    };
+
+    /**
+     * @brief The handlers run in the thread that changes the pin level, the main thread for the device models
+     */
+    class InterruptIn : public host::PinListener
+    {
+    public:
+        InterruptIn(PinName pin) : m_pin(pin), m_enabled(true) {
+            host::attachListener(m_pin, this);
+        }
+        ~InterruptIn() {
+            host::detachListener(m_pin, this);
+        }
+        InterruptIn(const InterruptIn &) = delete;
+        InterruptIn &operator=(const InterruptIn &) = delete;
+
+        void rise(Callback<void()> handler) {
+            m_rise = handler;
+        }
+        void fall(Callback<void()> handler) {
+            m_fall = handler;
+        }
+        void enable_irq() {
+            m_enabled = true;
+        }
+        void disable_irq() {
+            m_enabled = false;
+        }
+        void mode(PinMode pull) {}
+        int read() {
+            return host::getPin(m_pin);
+        }
+
+        void edge(bool rising) override {
+            const Callback<void()> &handler = rising ? m_rise : m_fall;
+            if(m_enabled && handler)
+            {
+                handler();
+            }
+        }
+
+    private:
+        PinName m_pin;
+        bool m_enabled;
+        Callback<void()> m_rise;
+        Callback<void()> m_fall;
+    };
+
+    /**
+     * @brief Master of the shim bus, the transfers are answered by the HostI2CDevice models and take bus time
+     */
+    class I2C
+    {
+    public:
+        I2C(PinName sda, PinName scl) : m_frequency(100000) {}
+        void frequency(int hz) {
+            m_frequency = hz;
+        }
+        int read(int address, char *data, int length, bool repeated = false);
+        int write(int address, const char *data, int length, bool repeated = false);
+        void start() {}
+        void stop() {}
+        void lock();
+        void unlock();
+
+    protected:
+        int m_frequency;
+    };
+
+    // No SPI device on the host, the bus reads back 0xFF
+    class SPI
+    {
+    public:
+        SPI(PinName mosi, PinName miso, PinName sclk, PinName ssel = NC) {}
+        void format(int bits, int mode = 0) {}
+        void frequency(int hz) {}
+        int write(int value) {
+            return 0xFF;
+        }
+        int write(const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length) {
+            if(rx_buffer != NULL) memset(rx_buffer, 0xFF, rx_length);
+            return (tx_length > rx_length) ? tx_length : rx_length;
+        }
+        void lock() {}
+        void unlock() {}
+    };
+
+    /**
+     * @brief Console, stdin is polled without waiting
+     */
+    class FileHandle
+    {
+    public:
+        FileHandle(int fd) : m_fd(fd), m_input(true) {}
+        ssize_t read(void *buffer, size_t size);
+        ssize_t write(const void *buffer, size_t size);
+        short poll(short events) const;
+        bool readable() const;
+        int set_blocking(bool blocking) {
+            return 0;
+        }
+        int enable_input(bool enabled) {
+            m_input = enabled;
+            return 0;
+        }
+        int enable_output(bool enabled) {
+            return 0;
+        }
+        // The writes of the host are done when they return
+        int sync() {
+            return 0;
+        }
+
+    private:
+        int m_fd;
+        bool m_input;
+    };
+
+    FileHandle *mbed_file_handle(int fd);
+}
+
+namespace rtos
+{
+    /**
+     * @brief Runs in lockstep with the virtual clock, one thread at a time
+     */
+    class Thread
+    {
+    public:
+        Thread(osPriority_t priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE,
+            unsigned char *stack_mem = NULL, const char *name = NULL) : m_handle(NULL) {}
+        osStatus start(mbed::Callback<void()> task);
+        // The threads run one at a time in lockstep, the priorities change nothing
+        osStatus set_priority(osPriority_t priority) {
+            return osOK;
+        }
+
+    private:
+        void *m_handle;
+    };
+
+    // Only one thread runs at a time, the lock never waits for long
+    class Mutex
+    {
+    public:
+        void lock() {
+            m_mutex.lock();
+        }
+        void unlock() {
+            m_mutex.unlock();
+        }
+        bool trylock() {
+            return m_mutex.try_lock();
+        }
+
+    private:
+        std::recursive_mutex m_mutex;
+    };
+
+    /**
+     * @brief Waiting lets the virtual time pass, the flags are set by ISRs of the device models
+     */
+    class EventFlags
+    {
+    public:
+        EventFlags() : m_flags(0) {}
+        uint32_t set(uint32_t flags);
+        uint32_t clear(uint32_t flags = 0x7FFFFFFF);
+        uint32_t get() const;
+        uint32_t wait_any(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true);
+        uint32_t wait_all(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true);
+        template <typename Rep, typename Period>
+        uint32_t wait_any_for(uint32_t flags, std::chrono::duration<Rep, Period> rel_time, bool clear = true) {
+            return wait(flags, false, (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(rel_time).count(), clear);
+        }
+
+    private:
+        uint32_t wait(uint32_t flags, bool all, uint32_t millisec, bool clear);
+
+        volatile uint32_t m_flags;
+    };
+
+    namespace ThisThread
+    {
+        template <typename Rep, typename Period>
+        void sleep_for(std::chrono::duration<Rep, Period> duration) {
+            host::advance(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+        }
+        inline void sleep_for(uint32_t millisec) {
+            host::advance((int64_t)millisec*1000);
+        }
+        inline void yield() {
+            host::advance(0);
+        }
+    }
+}
+
+inline void wait_us(int us)
+{
+    host::advance(us);
+}
+
+// Prints on stderr and ends the run, without the exit hooks
+[[noreturn]] void error(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+// Only one thread runs at a time and the ISRs run in the thread that fires them
+inline void core_util_critical_section_enter() {}
+inline void core_util_critical_section_exit() {}
+
+using namespace mbed;
+using namespace rtos;
+using namespace std;
+using namespace std::chrono_literals;
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * @file mbed_mem_trace.h
+ * @author Corentin BENOIT
+ * @brief Host stand-in for the memory trace of mbed OS, fed by the malloc of HostHeap.cpp
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOST_MBED_MEM_TRACE
+#define DEF_HOST_MBED_MEM_TRACE
+
+#include <cstdint>
+
+enum
+{
+    MBED_MEM_TRACE_MALLOC,
+    MBED_MEM_TRACE_REALLOC,
+    MBED_MEM_TRACE_CALLOC,
+    MBED_MEM_TRACE_FREE,
+};
+
+typedef void (*mbed_mem_trace_cb_t)(uint8_t op, void *res, void *caller, ...);
+
+// Called after each heap operation, never for the allocations of the callback itself
+void mbed_mem_trace_set_callback(mbed_mem_trace_cb_t callback);
+
+#endif
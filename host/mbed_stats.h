@@ -0,0 +1,30 @@
+/**
+ * @file mbed_stats.h
+ * @author Corentin BENOIT
+ * @brief Host stand-in for the heap statistics of mbed OS, counted by the malloc of HostHeap.cpp
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOST_MBED_STATS
+#define DEF_HOST_MBED_STATS
+
+#include <cstdint>
+
+typedef struct
+{
+    uint32_t current_size;      //Bytes in use, usable size of the glibc blocks
+    uint32_t max_size;
+    uint32_t total_size;        //Bytes ever allocated
+    uint32_t reserved_size;     //Unknown on the host, 0
+    uint32_t alloc_cnt;         //Blocks in use
+    uint32_t alloc_fail_cnt;
+    uint32_t overhead_size;     //Unknown on the host, 0
+} mbed_stats_heap_t;
+
+void mbed_stats_heap_get(mbed_stats_heap_t *stats);
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file pinmap.h
+ * @author Corentin BENOIT
+ * @brief Included by DevI2C.h, the host build has no pin map
+ * @version 1.2
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DEF_HOST_PINMAP
+#define DEF_HOST_PINMAP
+
+#endif
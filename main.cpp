@@ -10,11 +10,34 @@
 #include "mbed.h"
 #include "../LSM6DSL/LSM6DSL_acc_gyro_driver.h"
 #include "../LSM6DSL/LSM6DSLSensor.h"
-#include "LSM6DSL/ST_INTERFACES/Sensors/PressureSensor.h"
+#include "../LIS3MDL/lis3mdl_class.h"
 
 #include "TouchSensor.hpp"
 #include "StartButton.hpp"
 #include "PotentiometerSensor.hpp"
+#include "SensorScheduler.hpp"
+#include "SampleRecord.hpp"
+#include "RuntimeConfig.hpp"
+#include "CommandParser.hpp"
+#include "IdleManager.hpp"
+#include "StepCounter.hpp"
+#include "BarometerSensor.hpp"
+#include "I2CBusConfig.hpp"
+#include "I2CBusArbiter.hpp"
+#include "SampleQueue.hpp"
+#include "SensorTrace.hpp"
+#include "I2CProfiler.hpp"
+#include "ScalingTable.hpp"
+#include "Log.hpp"
+#include "MemoryGuard.hpp"
+#include "HipEstimator.hpp"
+#include "TorqueTable.hpp"
+#include "TrunkPitch.hpp"
+#include "LiftDetector.hpp"
+#include "ExposureLog.hpp"
+#include "GaitDetector.hpp"
+#include "OutputEvent.hpp"
+#include "SafetyMonitor.hpp"
 
 /*
 ----------------------------------------------------------
@@ -32,6 +55,17 @@
 // Blinking rate in milliseconds
 #define BLINKING_RATE    500ms
 #define BUSY_LOOP_DURATON 9ms
+// Time before a deadline spent busy waiting instead of sleeping, more than one RTOS tick
+#define SLEEP_MARGIN_US 1000
+#define OUTPUT_POLL_PERIOD 2ms
+// Set when an event is queued, wakes the output thread up before the end of its poll period
+#define OUTPUT_EVENT_FLAG 0x01
+// Cleared while idle, the output thread waits for it with no timeout
+#define OUTPUT_AWAKE_FLAG 0x02
+// Stacks of the output, command and safety threads [bytes]
+#define OUTPUT_STACK_SIZE 4096
+#define COMMAND_STACK_SIZE 4096
+#define SAFETY_STACK_SIZE 4096
 
 ////Initialise the startButton
 StartButton startButton;
@@ -46,9 +80,35 @@ TouchSensor sensorButton(A0);
 PotentiometerSensor potentiometer_right(A3, 0);
 PotentiometerSensor potentiometer_left(A2, 1);
 
-// Set the sampling frequency in Hz
-static int16_t sampling_freq = 100;
-static int64_t time_between_samples_us = (1000000 / (sampling_freq));
+// Default settings, they can be changed at runtime from the serial link
+static RuntimeConfig config = {
+    100.0f,         //sampling_freq: output rate in Hz
+    416.0f,         //imu_freq: each sensor has its own rate in Hz
+    200.0f,         //pot_freq
+    50.0f,          //touch_freq
+    2.0f,           //sensibility_acc
+    250.0f,         //sensibility_gyro
+    DEFAULT_CHANNELS,   //channels, the step channel is optional
+    FORMAT_TAB,     //format
+    true,           //streaming
+    1010,           //calibration_samples
+    60.0f,          //idle_timeout: seconds without motion before the low-power mode
+    20.0f,          //mag_freq
+    4.0f,           //sensibility_mag
+    10.0f,          //baro_freq
+    DROP_OLDEST,    //overflow: output queue policy when the serial link can't keep up
+    'b',            //color: gas springs of the Laevo
+};
+static int64_t time_between_samples_us = (1000000 / (config.sampling_freq));
+
+// Phase offsets in us, so the sensors don't all hit the bus and the ADC on the same tick
+static int64_t imu_phase_us = 0;
+static int64_t pot_phase_us = 500;
+static int64_t mag_phase_us = 750;
+static int64_t touch_phase_us = 1000;
+static int64_t baro_phase_us = 1100;
+static int64_t step_phase_us = 1250;
+static int64_t output_phase_us = 1500;
 
 // Measurements
 float gyr_offset[3] = {0};
@@ -56,10 +116,95 @@ float gyr_offset[3] = {0};
 // Check if this checks out for B-L4S5I board
 static DevI2C devI2C(PB_11, PB_10);
 
+#if MBED_CONF_APP_IMU_SPI
+// IMU wired on SPI, much shorter bus time per sample
+static SPI imu_spi(MBED_CONF_APP_IMU_SPI_MOSI, MBED_CONF_APP_IMU_SPI_MISO, MBED_CONF_APP_IMU_SPI_SCLK);
+static LSM6DSLSensor acc_gyro(&imu_spi, MBED_CONF_APP_IMU_SPI_CS, PD_11);
+#else
 static LSM6DSLSensor acc_gyro(&devI2C, LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, PD_11);
+#endif
+
+// Magnetometer on the same bus
+static LIS3MDL magnetometer(&devI2C, LIS3MDL_M_MEMS_ADDRESS_HIGH);
+
+// Wake-on-motion, INT2 is not wired on every board
+static IdleManager idle(acc_gyro, MBED_CONF_APP_IMU_INT2_PIN);
+
+// Embedded pedometer, the step detector is on INT1 unless the safety events take it
+static StepCounter steps(acc_gyro);
+
+//Free-fall and impact events of the LSM6DSL, on INT1
+static SafetyMonitor safety(acc_gyro);
 
 //Initialise pressureSensor
+static BarometerSensor barometer(&devI2C);
+
+// Bus clock, the fastest one every device supports
+static I2CBusConfig busConfig(devI2C);
+
+// Multi-rate acquisition
+static Timer t;      //Time base of every timestamp
+
+// Reads of the sensors sharing the I2C bus, ordered by deadline
+static I2CBusArbiter arbiter(devI2C, t);
+static int imu_device = -1, mag_device = -1;
+static uint8_t imu_gyro_raw[6], imu_acc_raw[6], mag_raw[6];
+static I2CTransaction imu_gyro_read, imu_acc_read, mag_read;
+static float acc_sensitivity, gyro_sensitivity;     //Cached so a sample is only the output registers
+static SensorScheduler scheduler;
+static int imu_task, mag_task, pot_task, touch_task, baro_task, step_task, output_task;
+static SampleRecord record;
+static float acc_ratio = 100.0f;
+static float gyr_ratio = 100.0f;
+static ScalingTable scaling;    //Raw values to output units, updated with the settings and the calibration
+static HipEstimator hip[2];     //Right, left
+static int64_t hip_pot_timestamp_us = 0;    //Potentiometer sample of the last update
+static TorqueTable torque_table[2];     //Right, left, for the colour of each potentiometer
+static char torque_direction[2] = {'i', 'i'};
+static TrunkPitch trunk(MBED_CONF_APP_HIP_GYRO_AXIS, MBED_CONF_APP_HIP_GYRO_SIGN);
+static LiftDetector lifts;
+static HipEstimator gait_hip[2];    //Potentiometer only: the gyroscope measures the trunk, which follows no hip in a walk
+static GaitDetector gait;
+
+// Posture over the shift, updated per output sample, saved by the output thread
+static ExposureLog exposure;
+static ExposureData exposure_snapshot;      //Copy being saved
+static atomic<bool> exposure_saving(false);
+static int64_t exposure_last_us = -1;       //Last output sample counted
+static int64_t exposure_saved_us = 0;
+
+// What the output thread needs to print one line, copied so it never reads the live settings
+struct OutputSample
+{
+    SampleRecord record;
+    RuntimeConfig config;
+    float gyr_offset[3];
+    float acc_sensitivity;      //Scale of the raw data of the binary trace
+    float gyro_sensitivity;
+    float pot_offset[2];
+    ScalingTable scaling;
+};
+
+// The acquisition (main thread) pushes, the output thread pops, encodes and prints
+static SampleQueue<OutputSample, 32> output_queue;
+MBED_ALIGN(8) static unsigned char output_stack[OUTPUT_STACK_SIZE];     //Static, no thread stack comes from the heap
+static Thread output_thread(osPriorityBelowNormal, OUTPUT_STACK_SIZE, output_stack, "output");
 
+// Event path: pushed as soon as they are detected, printed before the samples still queued
+static SampleQueue<OutputEvent, 16> event_queue(DROP_NEWEST);
+static EventFlags output_flags;
+
+// Safety events: read by a thread above the acquisition as soon as INT1 rises, then printed by the output thread
+// ahead of its next write. The other threads write to the console under consoleLock(), the line is timed under it
+MBED_ALIGN(8) static unsigned char safety_stack[SAFETY_STACK_SIZE];
+static Thread safety_thread(osPriorityAboveNormal, SAFETY_STACK_SIZE, safety_stack, "safety");
+static SampleQueue<SafetyEvent, SAFETY_PENDING_SIZE> safety_queue(DROP_NEWEST);
+static atomic<OutputFormat> safety_format(FORMAT_TAB);     //Copy of the setting, the output thread never reads the live settings
+
+// Runtime configuration, the commands are read by a low priority thread
+static CommandParser commands(config);
+MBED_ALIGN(8) static unsigned char command_stack[COMMAND_STACK_SIZE];
+static Thread command_thread(osPriorityLow, COMMAND_STACK_SIZE, command_stack, "commands");
 
 /*
 ----------------------------------------------------------
@@ -69,6 +214,40 @@ static LSM6DSLSensor acc_gyro(&devI2C, LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, PD_11);
 
 void initCalibration(int N);
 void calibrate_sensors(float N);
+void configureImu(float odr, float acc_fs, float gyro_fs);
+void updateScaling();
+void updateTorqueTables(char color);
+void initArbiter();
+void imuReadDone(I2CTransaction *transaction);
+void magReadDone(I2CTransaction *transaction);
+void updateHip(int64_t timestamp_us);
+void updateTorque();
+void updateTrunk(int64_t timestamp_us, float rate);
+void updateLift(int64_t timestamp_us);
+void updateGait(int64_t timestamp_us, bool new_pot);
+void updateExposure(int64_t timestamp_us);
+void applyExposure(ExposureRequest &request);
+void sampleImu(int64_t timestamp_us);
+void sampleMagnetometer(int64_t timestamp_us);
+void samplePotentiometers(int64_t timestamp_us);
+void sampleTouch(int64_t timestamp_us);
+void sampleSteps(int64_t timestamp_us);
+void sampleBarometer(int64_t timestamp_us);
+void updateImuEvents(uint32_t channels, float acc_fs);
+void updateBarometer(uint32_t channels, float rate);
+float barometerTaskRate(float rate);
+#if MBED_CONF_APP_BUS_BENCHMARK
+void benchmarkImuBus();
+#endif
+void outputRecord(int64_t timestamp_us);
+void outputRun();
+void printSample(const OutputSample &sample);
+void printEvent(const OutputEvent &event);
+void printSafety();
+void writeTrace(const OutputSample &sample);
+void writeFrame(const uint8_t *frame, int length);
+void safetyRun();
+void applyConfig(const RuntimeConfig &new_config, CommandRequest &requests, int64_t now_us);
 
 /**
  * @brief main
@@ -77,72 +256,1150 @@ void calibrate_sensors(float N);
  */
 int main(void)
 {
-
-    //Init
-    float acc_ratio = 100.0f;
-    float gyr_ratio = 100.0f;
-    int N = 1010; //cpt
+    MemoryGuard::instance().start();
 
     startButton.displayWait();
-
-    int32_t acc_val_buf[3];
-    int32_t gyro_val_buf[3];
-    float acc_val_buf_f[3];
-    float gyro_val_buf_f[3];
     
     // init initializes the component
+#if MBED_CONF_APP_IMU_SPI
+    acc_gyro.configure_spi(MBED_CONF_APP_IMU_SPI_FREQUENCY);
+#endif
     acc_gyro.init(NULL);
-    // enables the accelero
-    float sensibility_acc = 2.0f;
-    acc_gyro.enable_x();
-    acc_gyro.set_x_fs(sensibility_acc);
+    updateImuEvents(config.channels, config.sensibility_acc);
+    // enables the accelero and the gyro, the ODR follows the IMU rate
+    configureImu(config.imu_freq, config.sensibility_acc, config.sensibility_gyro);
+    magnetometer.init(NULL);
+    magnetometer.configure(config.mag_freq, config.sensibility_mag);
+    barometer.init(NULL);
+
+    // None of the sensors supports Fm+, the bus ends up at 400 kHz unless a check fails
+#if !MBED_CONF_APP_IMU_SPI
+    busConfig.addDevice(static_cast<MotionSensor *>(&acc_gyro), LSM6DSL_ACC_GYRO_WHO_AM_I, I2C_FAST_MODE, "LSM6DSL");
+#endif
+    busConfig.addDevice(&magnetometer, I_AM_LIS3MDL_M, I2C_FAST_MODE, "LIS3MDL");
+    busConfig.addDevice(&barometer, LPS22HB_ID, I2C_FAST_MODE, "LPS22HB");
+    busConfig.autotune();
+    initArbiter();
 
+    updateBarometer(config.channels, config.baro_freq);
+    updateTorqueTables(config.color);
+    if(exposure.load())
+    {
+        LOG_INFO("Exposure restored: %.0f s recorded\n", exposure.getData().total_us/1000000.0f);
+    }
 
-    // enable gyro
-    float sensibility_gyro = 250.0f;
-    acc_gyro.enable_g();
-    acc_gyro.set_g_fs(sensibility_gyro);
+#if MBED_CONF_APP_BUS_BENCHMARK
+    benchmarkImuBus();
+#endif
 
 
     //Initialize timer
-    Timer t;
     t.start();
 
     //Initialise the calibrations of all sensors
-    initCalibration(N);
+    initCalibration(config.calibration_samples);
  
 
     ThisThread::sleep_for(3s);
 
+    //Each sensor runs at its own rate
+    imu_task = scheduler.addTask(sampleImu, config.imu_freq, imu_phase_us);
+    mag_task = scheduler.addTask(sampleMagnetometer, config.mag_freq, mag_phase_us);
+    pot_task = scheduler.addTask(samplePotentiometers, config.pot_freq, pot_phase_us);
+    touch_task = scheduler.addTask(sampleTouch, config.touch_freq, touch_phase_us);
+    baro_task = scheduler.addTask(sampleBarometer, barometerTaskRate(config.baro_freq), baro_phase_us);
+    step_task = scheduler.addTask(sampleSteps, config.sampling_freq, step_phase_us);
+    output_task = scheduler.addTask(outputRecord, config.sampling_freq, output_phase_us);
+    scheduler.start(t.elapsed_time().count());
+    idle.setTimeout(config.idle_timeout);
+    idle.start(t.elapsed_time().count());
+
+    //The commands are only read once the user prompts and the calibration are over
+    command_thread.start(callback(&commands, &CommandParser::run));
+    output_flags.set(OUTPUT_AWAKE_FLAG);
+    output_thread.start(outputRun);
+    safety_format = config.format;
+    safety_thread.start(safetyRun);
+
+    //Everything is allocated by now, the sample loop must not touch the heap
+    MemoryGuard::instance().seal();
+
     while (1) {
-        int64_t next_tick = t.elapsed_time().count() + time_between_samples_us;
-        acc_gyro.get_x_axes(acc_val_buf);
-        acc_gyro.get_g_axes(gyro_val_buf);
+        //New settings are applied between two samples
+        RuntimeConfig new_config = config;
+        CommandRequest requests;
+        if(commands.fetch(new_config, requests))
+        {
+            applyConfig(new_config, requests, t.elapsed_time().count());
+        }
 
-        for(int i = 0; i <3; i++)
+        if(!config.streaming)
+        {
+            ThisThread::sleep_for(10ms);
+            continue;
+        }
+
+        //No motion for a while: low-power mode until the next motion, then full rate again.
+        //The motion is only seen on the IMU samples, without them the wearer is never idle
+        if((config.channels & IMU_CHANNELS) && idle.idleDue(t.elapsed_time().count()))
         {
-            acc_val_buf_f[i] = map(acc_val_buf[i], -sensibility_acc*g0*100.0f, sensibility_acc*g0*100.0f, -acc_ratio, acc_ratio);
-            gyro_val_buf_f[i] = map(gyro_val_buf[i] - gyr_offset[i], -sensibility_gyro*1000.0f, sensibility_gyro*1000.0f, -gyr_ratio, gyr_ratio);
-        }
-
-        //numbers
-        printf("%f\t%f\t%f\t%f\t%f\t%f\t%d\t%f\t%f\n",
-            static_cast<float>(acc_val_buf_f[0]),            
-            static_cast<float>(acc_val_buf_f[1]),
-            static_cast<float>(acc_val_buf_f[2]),
-            static_cast<float>(gyro_val_buf_f[0]),
-            static_cast<float>(gyro_val_buf_f[1]),
-            static_cast<float>(gyro_val_buf_f[2]),
-            sensorButton.detection(),
-            potentiometer_right.getRawDataOffsetPercentage_u16(),
-            potentiometer_left.getRawDataOffsetPercentage_u16());
+            //The low-power mode takes the wake-up engine, the safety events come back with the streaming
+            if(safety.isEnabled())
+            {
+                safety.disable();
+            }
+
+            //The output and command threads stop polling, only the wake-up interrupt is left to end the deep sleep
+            commands.pause();
+            output_flags.clear(OUTPUT_AWAKE_FLAG);
+            idle.sleep(t, time_between_samples_us);
+            output_flags.set(OUTPUT_AWAKE_FLAG);
+            commands.resume();
+            if(config.channels & CHANNEL_FALL)
+            {
+                safety.enable(t, config.sensibility_acc);
+            }
+            configureImu(config.imu_freq, config.sensibility_acc, config.sensibility_gyro);
+            scheduler.start(t.elapsed_time().count());
+        }
+
+        int64_t next_tick = scheduler.nextDeadline();
+
+        //The slower reads use the slack before the next tick, if they fit
+        arbiter.run(next_tick);
 
+        //Sleep so the output and command threads can run, then busy wait for an accurate tick
+        int64_t remaining_us = next_tick - t.elapsed_time().count();
+        if(remaining_us > 2*SLEEP_MARGIN_US)
+        {
+            ThisThread::sleep_for(chrono::milliseconds((remaining_us - SLEEP_MARGIN_US)/1000));
+        }
         while (t.elapsed_time().count() < next_tick){
             // busy loop
-        } 
+        }
+
+        scheduler.runDue(t.elapsed_time().count());
+    }
+}
+
+/**
+ * @brief Reads the accelerometer and the gyroscope
+ * 
+ * @param timestamp_us 
+ */
+void sampleImu(int64_t timestamp_us)
+{
+    if((config.channels & IMU_CHANNELS) == 0)
+    {
+        return;
+    }
+#if MBED_CONF_APP_IMU_SPI
+    acc_gyro.get_x_axes_raw(record.acc_raw);
+    acc_gyro.get_g_axes_raw(record.gyro_raw);
+    for(int i = 0; i <3; i++)
+    {
+        record.acc[i] = (int32_t)(record.acc_raw[i] * acc_sensitivity);
+        record.gyro[i] = (int32_t)(record.gyro_raw[i] * gyro_sensitivity);
+    }
+    record.imu_timestamp_us = timestamp_us;
+    record.updated |= CHANNEL_ACC | CHANNEL_GYRO;
+    idle.update(record.gyro, gyr_offset, timestamp_us);
+    updateHip(timestamp_us);
+#else
+    //Gyroscope then accelerometer output registers, merged into one read by the arbiter
+    int64_t deadline_us = timestamp_us + (int64_t)(500000/config.imu_freq);
+    imu_gyro_read.deadline_us = deadline_us;
+    imu_acc_read.deadline_us = deadline_us;
+    arbiter.submit(&imu_gyro_read);
+    arbiter.submit(&imu_acc_read);
+    arbiter.run(deadline_us);
+#endif
+}
+
+/**
+ * @brief Converts the IMU output registers once both reads are over
+ * 
+ * @param transaction 
+ */
+void imuReadDone(I2CTransaction *transaction)
+{
+    if(transaction != &imu_acc_read || imu_gyro_read.status != TRANSACTION_DONE || imu_acc_read.status != TRANSACTION_DONE)
+    {
+        return;
+    }
+    for(int i = 0; i <3; i++)
+    {
+        record.gyro_raw[i] = (int16_t)(imu_gyro_raw[2*i] | (imu_gyro_raw[2*i + 1] << 8));
+        record.acc_raw[i] = (int16_t)(imu_acc_raw[2*i] | (imu_acc_raw[2*i + 1] << 8));
+        record.gyro[i] = (int32_t)(record.gyro_raw[i] * gyro_sensitivity);
+        record.acc[i] = (int32_t)(record.acc_raw[i] * acc_sensitivity);
+    }
+    record.imu_timestamp_us = imu_gyro_read.submit_us;
+    record.updated |= CHANNEL_ACC | CHANNEL_GYRO;
+    idle.update(record.gyro, gyr_offset, record.imu_timestamp_us);
+    updateHip(record.imu_timestamp_us);
+}
+
+/**
+ * @brief Fuses the new IMU sample, and the potentiometer sample taken since the last one, into the hip estimates
+ * 
+ * @param timestamp_us of the IMU sample
+ */
+void updateHip(int64_t timestamp_us)
+{
+    if((config.channels & FUSED_CHANNELS) == 0)
+    {
+        return;
+    }
+    const int axis = MBED_CONF_APP_HIP_GYRO_AXIS;
+    float rate = MBED_CONF_APP_HIP_GYRO_SIGN*(record.gyro_raw[axis]*gyro_sensitivity - gyr_offset[axis])/1000.0f;
+    bool new_pot = (record.pot_timestamp_us != hip_pot_timestamp_us);
+    uint16_t raw[2] = {record.pot_right_raw, record.pot_left_raw};
+    const PotentiometerSensor *pots[2] = {&potentiometer_right, &potentiometer_left};
+
+    for(int side = 0; side < 2; side++)
+    {
+        if(new_pot)
+        {
+            float angle = pots[side]->offsetAngle(raw[side]);
+            if(!hip[side].isStarted())
+            {
+                hip[side].start(angle, record.pot_timestamp_us);
+            }
+            hip[side].predict(record.pot_timestamp_us);
+            hip[side].updatePot(angle);
+        }
+        //No effect before the first potentiometer sample, the estimate starts on it
+        hip[side].predict(timestamp_us);
+        hip[side].updateGyro(rate);
+        record.hip_angle[side] = hip[side].getAngle();
+        record.hip_velocity[side] = hip[side].getVelocity();
+        record.hip_acceleration[side] = hip[side].getAcceleration();
+    }
+    hip_pot_timestamp_us = record.pot_timestamp_us;
+    if(hip[0].isStarted())
+    {
+        record.hip_timestamp_us = timestamp_us;
+        record.updated |= CHANNEL_HIP;
+        updateTorque();
+        updateTrunk(timestamp_us, rate);
+        updateLift(timestamp_us);
+    }
+    updateGait(timestamp_us, new_pot);
+}
+
+/**
+ * @brief Support torque of both rods from the hip estimates, two table lookups
+ * 
+ */
+void updateTorque()
+{
+    if((config.channels & (CHANNEL_TORQUE | CHANNEL_LIFT)) == 0)
+    {
+        return;
+    }
+    for(int side = 0; side < 2; side++)
+    {
+        TorqueTable::updateDirection(torque_direction[side], record.hip_velocity[side]);
+        record.torque[side] = torque_table[side].lookup(record.hip_angle[side], torque_direction[side]);
+    }
+    record.torque_global = calculateGlobalTorque(record.torque[0], record.torque[1]);
+    record.updated |= CHANNEL_TORQUE;
+}
+
+/**
+ * @brief Trunk pitch, for the lift cycles and the exposure
+ * 
+ * @param timestamp_us of the IMU sample
+ * @param rate pitch rate [deg/s]
+ */
+void updateTrunk(int64_t timestamp_us, float rate)
+{
+    if((config.channels & (CHANNEL_LIFT | CHANNEL_EXPOSURE)) == 0)
+    {
+        return;
+    }
+    trunk.update(record.acc, rate, timestamp_us);
+    record.trunk_pitch = trunk.getPitch();
+}
+
+/**
+ * @brief Bend or lift cycles, the summary of a cycle goes out with the next output tick
+ * 
+ * @param timestamp_us of the IMU sample
+ */
+void updateLift(int64_t timestamp_us)
+{
+    if((config.channels & CHANNEL_LIFT) == 0)
+    {
+        return;
+    }
+    if(lifts.update(timestamp_us, record.trunk_pitch, record.hip_angle, record.torque_global, record.touch != 0))
+    {
+        record.lift = lifts.getEvent();
+        record.updated |= CHANNEL_LIFT;
+    }
+}
+
+/**
+ * @brief Heel strikes and toe-offs, each one is queued on the event path as soon as it is detected
+ * 
+ * @param timestamp_us of the IMU sample
+ * @param new_pot a potentiometer sample was taken since the last IMU sample
+ */
+void updateGait(int64_t timestamp_us, bool new_pot)
+{
+    if((config.channels & CHANNEL_GAIT) == 0)
+    {
+        return;
+    }
+    uint16_t raw[2] = {record.pot_right_raw, record.pot_left_raw};
+    const PotentiometerSensor *pots[2] = {&potentiometer_right, &potentiometer_left};
+    float angles[2], velocities[2];
+
+    for(int side = 0; side < 2; side++)
+    {
+        if(new_pot)
+        {
+            float angle = pots[side]->offsetAngle(raw[side]);
+            if(!gait_hip[side].isStarted())
+            {
+                gait_hip[side].start(angle, record.pot_timestamp_us);
+            }
+            gait_hip[side].predict(record.pot_timestamp_us);
+            gait_hip[side].updatePot(angle);
+        }
+        gait_hip[side].predict(timestamp_us);
+        angles[side] = gait_hip[side].getAngle();
+        velocities[side] = gait_hip[side].getVelocity();
+    }
+    if(!gait_hip[0].isStarted())
+    {
+        return;
+    }
+
+    int nb_events = gait.update(timestamp_us, angles, velocities);
+    for(int i = 0; i < nb_events; i++)
+    {
+        OutputEvent event;
+        event.kind = EVENT_GAIT;
+        event.format = config.format;
+        event.gait = gait.getEvent(i);
+        event_queue.push(event);
+    }
+    if(nb_events > 0)
+    {
+        output_flags.set(OUTPUT_EVENT_FLAG);
+    }
+}
+
+/**
+ * @brief Reads the three axes of the magnetometer in one transfer
+ * 
+ * @param timestamp_us 
+ */
+void sampleMagnetometer(int64_t timestamp_us)
+{
+    if((config.channels & CHANNEL_MAG) == 0)
+    {
+        return;
+    }
+    //Not urgent, the read may wait for the slack before the next IMU tick. Skipped if the last one is still pending
+    mag_read.deadline_us = timestamp_us + (int64_t)(1000000/config.mag_freq);
+    arbiter.submit(&mag_read);
+}
+
+/**
+ * @brief Converts the magnetometer output registers
+ * 
+ * @param transaction 
+ */
+void magReadDone(I2CTransaction *transaction)
+{
+    if(transaction->status != TRANSACTION_DONE)
+    {
+        return;
+    }
+    float sensitivity = magnetometer.get_m_sensitivity();
+    for(int i = 0; i <3; i++)
+    {
+        int16_t raw = (int16_t)(mag_raw[2*i] | (mag_raw[2*i + 1] << 8));
+        record.mag[i] = (int32_t)(raw * sensitivity);
+    }
+    record.mag_timestamp_us = transaction->complete_us;
+    record.updated |= CHANNEL_MAG;
+}
+
+/**
+ * @brief Reads both potentiometers
+ * 
+ * @param timestamp_us 
+ */
+void samplePotentiometers(int64_t timestamp_us)
+{
+    if((config.channels & (CHANNEL_POT_RIGHT | CHANNEL_POT_LEFT | FUSED_CHANNELS)) == 0)
+    {
+        return;
+    }
+    //Converted by the output thread
+    record.pot_right_raw = potentiometer_right.getRawData_u16();
+    record.pot_left_raw = potentiometer_left.getRawData_u16();
+    record.pot_timestamp_us = timestamp_us;
+    record.updated |= CHANNEL_POT_RIGHT | CHANNEL_POT_LEFT;
+}
+
+/**
+ * @brief Reads the touch sensor
+ * 
+ * @param timestamp_us 
+ */
+void sampleTouch(int64_t timestamp_us)
+{
+    if((config.channels & (CHANNEL_TOUCH | CHANNEL_LIFT | CHANNEL_EXPOSURE)) == 0)
+    {
+        return;
+    }
+    record.touch_raw = sensorButton.getRawData_u16();
+    record.touch = sensorButton.detection(record.touch_raw);
+    record.touch_timestamp_us = timestamp_us;
+    record.updated |= CHANNEL_TOUCH;
+}
+
+/**
+ * @brief Refreshes the step count once per output, the bus is only used after a step
+ * 
+ * @param timestamp_us 
+ */
+void sampleSteps(int64_t timestamp_us)
+{
+    if((config.channels & CHANNEL_STEPS) == 0)
+    {
+        return;
+    }
+    if(steps.fetch(record.step_count, record.step_timestamp_us))
+    {
+        record.updated |= CHANNEL_STEPS;
+    }
+}
+
+/**
+ * @brief Drains the barometer FIFO, a few samples per call so the transfer fits between two IMU samples
+ * 
+ * @param timestamp_us 
+ */
+void sampleBarometer(int64_t timestamp_us)
+{
+    if((config.channels & CHANNEL_BARO) == 0)
+    {
+        return;
+    }
+    if(barometer.update() > 0)
+    {
+        record.pressure = barometer.getPressure();
+        record.altitude = barometer.getAltitude();
+        record.baro_timestamp_us = timestamp_us;
+        record.updated |= CHANNEL_BARO;
+    }
+}
+
+/**
+ * @brief Hands the latest value of each channel to the output thread, never waits for the serial link
+ * 
+ * @param timestamp_us 
+ */
+void outputRecord(int64_t timestamp_us)
+{
+    OutputSample sample;
+
+    updateExposure(timestamp_us);
+    record.timestamp_us = timestamp_us;
+    sample.record = record;
+    sample.config = config;
+    for(int i = 0; i <3; i++)
+    {
+        sample.gyr_offset[i] = gyr_offset[i];
+    }
+    sample.acc_sensitivity = acc_sensitivity;
+    sample.gyro_sensitivity = gyro_sensitivity;
+    sample.pot_offset[0] = potentiometer_right.getOffset();
+    sample.pot_offset[1] = potentiometer_left.getOffset();
+    sample.scaling = scaling;
+    output_queue.push(sample);
+
+    record.updated = 0;
+
+#if MBED_CONF_APP_I2C_PROFILER
+    //The safety thread records its reads under the bus lock
+    devI2C.lock();
+    I2CProfiler::instance().tick();
+    devI2C.unlock();
+#endif
+}
+
+/**
+ * @brief Adds the time since the last output sample to the exposure histograms, and hands a copy
+ * to the output thread to be saved every exposure-save-period seconds
+ * 
+ * @param timestamp_us 
+ */
+void updateExposure(int64_t timestamp_us)
+{
+    //A pause, the low-power mode or a stop, is not counted
+    int64_t dt_us = timestamp_us - exposure_last_us;
+    bool counted = (config.channels & CHANNEL_EXPOSURE) && hip[0].isStarted() && trunk.isStarted()
+        && exposure_last_us >= 0 && dt_us > 0 && dt_us <= 2*time_between_samples_us;
+    exposure_last_us = timestamp_us;
+    if(!counted)
+    {
+        return;
+    }
+    const float angles[EXPOSURE_NB_SIGNALS] = {record.trunk_pitch, record.hip_angle[0], record.hip_angle[1]};
+    exposure.add(angles, record.touch != 0, (uint32_t)dt_us);
+
+    if(timestamp_us - exposure_saved_us >= (int64_t)MBED_CONF_APP_EXPOSURE_SAVE_PERIOD*1000000 && !exposure_saving)
+    {
+        exposure_snapshot = exposure.getData();
+        exposure_saving = true;
+        exposure_saved_us = timestamp_us;
+    }
+}
+
+/**
+ * @brief Output thread body, scales and prints the queued samples at a lower priority than the acquisition
+ * 
+ */
+void outputRun()
+{
+    uint32_t dropped = 0;
+    uint32_t events_dropped = 0;
+    uint32_t safety_dropped = 0;
+    OutputSample sample;
+    OutputEvent event;
+
+    while (1) {
+        while (1) {
+            //The safety events go out ahead of every write, the events ahead of the samples still queued
+            printSafety();
+            if(event_queue.pop(event))
+            {
+                printEvent(event);
+            }
+            else if(output_queue.pop(sample))
+            {
+                printSample(sample);
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        //The flash write of the KVStore never delays the acquisition
+        if(exposure_saving)
+        {
+            ExposureLog::save(exposure_snapshot);
+            exposure_saving = false;
+            printSafety();
+        }
+
+        uint32_t new_dropped = output_queue.getDroppedOldest() + output_queue.getDroppedNewest();
+        if(new_dropped != dropped)
+        {
+            LOG_WARNING("Output queue full: %lu dropped oldest, %lu dropped newest\n",
+                (unsigned long)output_queue.getDroppedOldest(),
+                (unsigned long)output_queue.getDroppedNewest());
+            dropped = new_dropped;
+        }
+        if(event_queue.getDroppedNewest() != events_dropped)
+        {
+            events_dropped = event_queue.getDroppedNewest();
+            LOG_WARNING("Event queue full: %lu events dropped\n", (unsigned long)events_dropped);
+        }
+        if(safety_queue.getDroppedNewest() != safety_dropped)
+        {
+            safety_dropped = safety_queue.getDroppedNewest();
+            LOG_WARNING("Safety queue full: %lu events dropped\n", (unsigned long)safety_dropped);
+        }
+
+        //Parked while idle, everything queued before is printed by now
+        output_flags.wait_any(OUTPUT_AWAKE_FLAG, osWaitForever, false);
+
+        //Until the next poll, or at once if an event comes
+        output_flags.wait_any_for(OUTPUT_EVENT_FLAG, OUTPUT_POLL_PERIOD);
+    }
+}
+
+/**
+ * @brief Scales and prints the enabled channels of one sample
+ * 
+ * @param sample 
+ */
+void printSample(const OutputSample &sample)
+{
+    if(sample.config.format == FORMAT_TRACE)
+    {
+        writeTrace(sample);
+        return;
+    }
+
+    char line[384];
+    int length = 0;
+    char separator = (sample.config.format == FORMAT_CSV) ? ',' : '\t';
+
+    //Summary of a cycle, a line of its own before the sample
+    if(sample.config.channels & sample.record.updated & CHANNEL_LIFT)
+    {
+        const LiftEvent &lift = sample.record.lift;
+        length = snprintf(line, sizeof(line), "lift%c%lu%c%s%c%lld%c%lld%c%lu%c%f%c%f%c%f%c%f\n",
+            separator, (unsigned long)lift.index,
+            separator, (lift.kind == LIFT_CARRY) ? "carry" : "bend",
+            separator, (long long)(lift.start_us/1000),
+            separator, (long long)(lift.end_us/1000),
+            separator, (unsigned long)lift.duration_ms,
+            separator, lift.peak_flexion,
+            separator, lift.peak_hip,
+            separator, lift.peak_torque,
+            separator, lift.work);
+        fwrite(line, 1, length, stdout);
+        length = 0;
+    }
+
+    //Every scaled channel in one pass over the raw values
+    int32_t raw[SCALE_NB_CHANNELS];
+    float scaled[SCALE_NB_CHANNELS];
+    for(int i = 0; i <3; i++)
+    {
+        raw[SCALE_ACC_X + i] = sample.record.acc_raw[i];
+        raw[SCALE_GYRO_X + i] = sample.record.gyro_raw[i];
+    }
+    raw[SCALE_POT_RIGHT] = sample.record.pot_right_raw;
+    raw[SCALE_POT_LEFT] = sample.record.pot_left_raw;
+    sample.scaling.apply(raw, scaled);
+
+    //numbers
+    if(sample.config.channels & CHANNEL_ACC)
+    {
+        for(int i = 0; i <3; i++)
+        {
+            length += snprintf(line + length, sizeof(line) - length, "%f%c", scaled[SCALE_ACC_X + i], separator);
+        }
+    }
+    if(sample.config.channels & CHANNEL_GYRO)
+    {
+        for(int i = 0; i <3; i++)
+        {
+            length += snprintf(line + length, sizeof(line) - length, "%f%c", scaled[SCALE_GYRO_X + i], separator);
+        }
+    }
+    if(sample.config.channels & CHANNEL_MAG)
+    {
+        for(int i = 0; i <3; i++)
+        {
+            length += snprintf(line + length, sizeof(line) - length, "%ld%c", (long)sample.record.mag[i], separator);
+        }
+    }
+    if(sample.config.channels & CHANNEL_TOUCH)
+    {
+        length += snprintf(line + length, sizeof(line) - length, "%d%c", sample.record.touch, separator);
+    }
+    if(sample.config.channels & CHANNEL_POT_RIGHT)
+    {
+        length += snprintf(line + length, sizeof(line) - length, "%f%c", scaled[SCALE_POT_RIGHT], separator);
+    }
+    if(sample.config.channels & CHANNEL_POT_LEFT)
+    {
+        length += snprintf(line + length, sizeof(line) - length, "%f%c", scaled[SCALE_POT_LEFT], separator);
+    }
+    if(sample.config.channels & CHANNEL_BARO)
+    {
+        length += snprintf(line + length, sizeof(line) - length, "%f%c%f%c", sample.record.pressure, separator, sample.record.altitude, separator);
+    }
+    if(sample.config.channels & CHANNEL_HIP)
+    {
+        for(int side = 0; side < 2; side++)
+        {
+            length += snprintf(line + length, sizeof(line) - length, "%f%c%f%c%f%c",
+                sample.record.hip_angle[side], separator,
+                sample.record.hip_velocity[side], separator,
+                sample.record.hip_acceleration[side], separator);
+        }
+    }
+    if(sample.config.channels & CHANNEL_TORQUE)
+    {
+        length += snprintf(line + length, sizeof(line) - length, "%f%c%f%c%f%c",
+            sample.record.torque[0], separator,
+            sample.record.torque[1], separator,
+            sample.record.torque_global, separator);
+    }
+    if(sample.config.channels & CHANNEL_STEPS)
+    {
+        length += snprintf(line + length, sizeof(line) - length, "%lu%c%lld%c",
+            (unsigned long)sample.record.step_count, separator,
+            (long long)(sample.record.step_timestamp_us/1000), separator);
+    }
+
+    //The last separator is replaced by the end of line
+    if(length > 0)
+    {
+        line[length - 1] = '\n';
+        fwrite(line, 1, length, stdout);
+    }
+}
+
+/**
+ * @brief Prints one event of the event path on a line of its own
+ * 
+ * @param event 
+ */
+void printEvent(const OutputEvent &event)
+{
+    //Not in the binary trace, replaying it detects the events again
+    if(event.format == FORMAT_TRACE)
+    {
+        return;
+    }
+
+    char line[128];
+    int length = 0;
+    char separator = (event.format == FORMAT_CSV) ? ',' : '\t';
+
+    if(event.kind == EVENT_GAIT)
+    {
+        const GaitEvent &gait_event = event.gait;
+        length = snprintf(line, sizeof(line), "gait%c%lu%c%s%c%s%c%lld%c%lld%c%f%c%f%c%f\n",
+            separator, (unsigned long)gait_event.index,
+            separator, (gait_event.side == 0) ? "right" : "left",
+            separator, (gait_event.kind == GAIT_HEEL_STRIKE) ? "hs" : "to",
+            separator, (long long)(gait_event.timestamp_us/1000),
+            separator, (long long)((gait_event.detected_us - gait_event.timestamp_us)/1000),
+            separator, gait_event.angle,
+            separator, gait_event.stride_time,
+            separator, gait_event.cadence);
     }
+    fwrite(line, 1, length, stdout);
 }
 
+/**
+ * @brief Safety thread body. It runs above the acquisition: it reads the source of each event as soon as INT1 rises,
+ * hands it to the output thread and raises that thread above the acquisition until it is printed
+ * 
+ */
+void safetyRun()
+{
+    SafetyEvent event;
+
+    while (1) {
+        safety.wait(event);
+        safety_queue.push(event);
+        output_thread.set_priority(osPriorityAboveNormal);
+        output_flags.set(OUTPUT_EVENT_FLAG);
+    }
+}
+
+/**
+ * @brief Prints the queued safety events, for the output thread before each of its writes, and times each one
+ * from its interrupt to the moment its line has left the transmit buffer of the serial port.
+ * The lines are printed in the binary trace too, a trace reader skips the text between two frames
+ * 
+ */
+void printSafety()
+{
+    const char *kinds[SAFETY_NB_KINDS] = {"fall", "impact", "unknown"};
+    SafetyEvent events[SAFETY_PENDING_SIZE];
+    char line[64];
+    int nb_events = 0;
+
+    while (nb_events < (int)SAFETY_PENDING_SIZE && safety_queue.pop(events[nb_events])) {
+        nb_events++;
+    }
+    if(nb_events == 0)
+    {
+        return;
+    }
+
+    //The lines leave under the console lock: the transmit buffer holds what was written before them, nothing after them,
+    //until BufferedSerial::sync() sees it empty, only the last byte is still on the wire.
+    //The acquisition runs again while it drains, a writer of another thread waits for the unlock
+    consoleLock();
+    char separator = (safety_format == FORMAT_CSV) ? ',' : '\t';
+    for(int i = 0; i < nb_events; i++)
+    {
+        const SafetyEvent &event = events[i];
+        int length = snprintf(line, sizeof(line), "safety%c%lu%c%s%c%lld%c%lld\n",
+            separator, (unsigned long)event.index,
+            separator, kinds[event.kind],
+            separator, (long long)(event.irq_us/1000),
+            separator, (long long)(event.source_us - event.irq_us));
+        fwrite(line, 1, length, stdout);
+    }
+    fflush(stdout);
+    output_thread.set_priority(osPriorityBelowNormal);
+    mbed_file_handle(STDOUT_FILENO)->sync();
+    int64_t now_us = t.elapsed_time().count();
+    consoleUnlock();
+    for(int i = 0; i < nb_events; i++)
+    {
+        safety.recordLatency(now_us - events[i].irq_us);
+    }
+
+    //An event pushed between the last pop and the priority change lost its raise
+    if(safety_queue.size() > 0)
+    {
+        output_thread.set_priority(osPriorityAboveNormal);
+    }
+}
+
+/**
+ * @brief Writes the raw data of one sample as a binary trace frame, preceded by a header
+ * when the trace starts, when the scaling changes, and every TRACE_HEADER_PERIOD samples
+ * 
+ * @param sample 
+ */
+void writeTrace(const OutputSample &sample)
+{
+    static TraceHeader last_header;
+    static int nb_since_header = TRACE_HEADER_PERIOD;
+    uint8_t frame[TRACE_MAX_FRAME];
+
+    TraceHeader header;
+    memset(&header, 0, sizeof(header));     //Compared with memcmp, padding included
+    header.version = TRACE_VERSION;
+    header.channels = sample.config.channels;
+    header.sampling_freq = sample.config.sampling_freq;
+    header.acc_sensitivity = sample.acc_sensitivity;
+    header.gyro_sensitivity = sample.gyro_sensitivity;
+    for(int i = 0; i <3; i++)
+    {
+        header.gyr_offset[i] = sample.gyr_offset[i];
+    }
+    header.pot_offset[0] = sample.pot_offset[0];
+    header.pot_offset[1] = sample.pot_offset[1];
+    header.imu_freq = sample.config.imu_freq;
+
+    if(nb_since_header >= TRACE_HEADER_PERIOD || memcmp(&header, &last_header, sizeof(header)) != 0)
+    {
+        writeFrame(frame, SensorTrace::encodeHeader(header, frame));
+        last_header = header;
+        nb_since_header = 0;
+    }
+    nb_since_header++;
+
+    //Age of each channel at the output tick, so a replay feeds it at the time it was read
+    const SampleRecord &record = sample.record;
+    TraceSample trace;
+    trace.timestamp_us = (uint32_t)record.timestamp_us;
+    trace.imu_age_us = (uint16_t)min<int64_t>(record.timestamp_us - record.imu_timestamp_us, UINT16_MAX);
+    trace.pot_age_us = (uint16_t)min<int64_t>(record.timestamp_us - record.pot_timestamp_us, UINT16_MAX);
+    trace.touch_age_us = (uint16_t)min<int64_t>(record.timestamp_us - record.touch_timestamp_us, UINT16_MAX);
+    for(int i = 0; i <3; i++)
+    {
+        trace.acc[i] = record.acc_raw[i];
+        trace.gyro[i] = record.gyro_raw[i];
+    }
+    trace.pot_right = record.pot_right_raw;
+    trace.pot_left = record.pot_left_raw;
+    trace.touch = record.touch_raw;
+    writeFrame(frame, SensorTrace::encodeSample(trace, frame));
+}
+
+/**
+ * @brief Hands a binary frame to the console below stdio: platform.stdio-convert-newlines would turn every 0x0A
+ * of the frame into "\r\n". The text lines still go through stdio, they are flushed first to keep the order
+ * 
+ * @param frame 
+ * @param length 
+ */
+void writeFrame(const uint8_t *frame, int length)
+{
+    fflush(stdout);
+    mbed_file_handle(STDOUT_FILENO)->write(frame, length);
+}
+
+/**
+ * @brief Applies a new configuration and runs the one-shot requests between two samples
+ * 
+ * @param new_config 
+ * @param requests cleared once done
+ * @param now_us 
+ */
+void applyConfig(const RuntimeConfig &new_config, CommandRequest &requests, int64_t now_us)
+{
+    bool imu_events = ((new_config.channels ^ config.channels) & (CHANNEL_STEPS | CHANNEL_FALL)) != 0
+        || ((new_config.channels & CHANNEL_FALL) && new_config.sensibility_acc != config.sensibility_acc);
+    if(imu_events)
+    {
+        updateImuEvents(new_config.channels, new_config.sensibility_acc);
+    }
+
+    if(imu_events
+        || new_config.imu_freq != config.imu_freq
+        || new_config.sensibility_acc != config.sensibility_acc
+        || new_config.sensibility_gyro != config.sensibility_gyro)
+    {
+        configureImu(new_config.imu_freq, new_config.sensibility_acc, new_config.sensibility_gyro);
+    }
+
+    if(new_config.mag_freq != config.mag_freq || new_config.sensibility_mag != config.sensibility_mag)
+    {
+        magnetometer.configure(new_config.mag_freq, new_config.sensibility_mag);
+    }
+
+    if(((new_config.channels ^ config.channels) & CHANNEL_BARO) || new_config.baro_freq != config.baro_freq)
+    {
+        updateBarometer(new_config.channels, new_config.baro_freq);
+    }
+
+    scheduler.setRate(imu_task, new_config.imu_freq);
+    scheduler.setRate(mag_task, new_config.mag_freq);
+    scheduler.setRate(pot_task, new_config.pot_freq);
+    scheduler.setRate(touch_task, new_config.touch_freq);
+    scheduler.setRate(baro_task, barometerTaskRate(new_config.baro_freq));
+    scheduler.setRate(step_task, new_config.sampling_freq);
+    scheduler.setRate(output_task, new_config.sampling_freq);
+    time_between_samples_us = (int64_t)(1000000 / new_config.sampling_freq);
+    idle.setTimeout(new_config.idle_timeout);
+    output_queue.setPolicy(new_config.overflow);
+    if(new_config.color != config.color)
+    {
+        updateTorqueTables(new_config.color);
+    }
+
+    bool restart = new_config.streaming && !config.streaming;
+    //The time without motion counts from the first IMU sample
+    bool imu_restart = (new_config.channels & IMU_CHANNELS) && !(config.channels & IMU_CHANNELS);
+    config = new_config;
+    safety_format = config.format;
+
+    //The reports leave whole, the output thread prints a safety line before or after them
+    consoleLock();
+    if(requests.bus_stats)
+    {
+        arbiter.display();
+        arbiter.resetStats();
+        requests.bus_stats = false;
+    }
+
+    if(requests.bus_profile)
+    {
+#if MBED_CONF_APP_I2C_PROFILER
+        I2CProfiler::instance().dump(devI2C, true);
+#else
+        printf("I2C profiler not built, set i2c-profiler in mbed_app.json\n");
+#endif
+        requests.bus_profile = false;
+    }
+
+    if(requests.mem_report)
+    {
+        MemoryGuard::instance().display();
+        requests.mem_report = false;
+    }
+
+    if(requests.safety_report)
+    {
+        safety.display();
+        requests.safety_report = false;
+    }
+
+    applyExposure(requests.exposure);
+    fflush(stdout);
+    consoleUnlock();
+
+    if(requests.calibrate)
+    {
+        LOG_INFO("Calibration Started. This will take approximately %d seconds.\n", (int)(config.calibration_samples/config.sampling_freq));
+        calibrate_sensors(config.calibration_samples);
+        requests.calibrate = false;
+        restart = true;
+    }
+    updateScaling();
+
+    //The time grid starts again after a pause
+    if(restart)
+    {
+        scheduler.start(now_us);
+        idle.start(now_us);
+    }
+    else if(imu_restart)
+    {
+        idle.restartTimeout(now_us);
+    }
+}
+
+/**
+ * @brief Requests of the expo command
+ * 
+ * @param request cleared once done
+ */
+void applyExposure(ExposureRequest &request)
+{
+    if(request.signal == EXPOSURE_TRUNK)
+    {
+        exposure.setEdges(EXPOSURE_TRUNK, request.edges, request.nb_edges);
+    }
+    else if(request.signal == EXPOSURE_HIP_RIGHT)
+    {
+        exposure.setEdges(EXPOSURE_HIP_RIGHT, request.edges, request.nb_edges);
+        exposure.setEdges(EXPOSURE_HIP_LEFT, request.edges, request.nb_edges);
+    }
+    if(request.clear)
+    {
+        exposure.clear();
+    }
+    if(request.report)
+    {
+        exposure.display();
+    }
+    request.signal = -1;
+    request.clear = false;
+    request.report = false;
+}
+
+/**
+ * @brief Configures the IMU and caches its sensitivities for the conversion of the raw samples
+ * 
+ * @param odr 
+ * @param acc_fs 
+ * @param gyro_fs 
+ */
+void configureImu(float odr, float acc_fs, float gyro_fs)
+{
+    acc_gyro.configure(odr, acc_fs, gyro_fs);
+    acc_gyro.get_x_sensitivity(&acc_sensitivity);
+    acc_gyro.get_g_sensitivity(&gyro_sensitivity);
+}
+
+/**
+ * @brief Sets the colour of the gas springs and samples their torque curves, once per change
+ * 
+ * @param color b, g, r or y
+ */
+void updateTorqueTables(char color)
+{
+    potentiometer_right.setColor(color);
+    potentiometer_left.setColor(color);
+    torque_table[0].build(potentiometer_right);
+    torque_table[1].build(potentiometer_left);
+}
+
+/**
+ * @brief Folds the sensitivities, the output ranges and the calibration offsets into the scaling table,
+ * once per change instead of once per sample
+ * 
+ */
+void updateScaling()
+{
+    scaling.setAccelerometer(acc_sensitivity, config.sensibility_acc*g0*100.0f, acc_ratio);
+    scaling.setGyroscope(gyro_sensitivity, config.sensibility_gyro*1000.0f, gyr_ratio, gyr_offset);
+    scaling.setPotentiometers(potentiometer_right.getOffset(), potentiometer_left.getOffset());
+}
+
+/**
+ * @brief Registers the sensors read through the arbiter and their reads.
+ * The LSM6DSL increments the register address by default, the LIS3MDL needs the MSB of the register set
+ * 
+ */
+void initArbiter()
+{
+    arbiter.setFrequency(busConfig.getFrequency());
+#if !MBED_CONF_APP_IMU_SPI
+    imu_device = arbiter.addDevice(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, 0, "LSM6DSL");
+#endif
+    mag_device = arbiter.addDevice(LIS3MDL_M_MEMS_ADDRESS_HIGH, LIS3MDL_I2C_MULTIPLEBYTE_CMD, "LIS3MDL");
+
+    // The arbiter fills the status and the times in, idle until the first submit
+    imu_gyro_read = {imu_device, LSM6DSL_ACC_GYRO_OUTX_L_G, imu_gyro_raw, sizeof(imu_gyro_raw), 0, 2, imuReadDone, TRANSACTION_IDLE, 0, 0};
+    imu_acc_read = {imu_device, LSM6DSL_ACC_GYRO_OUTX_L_XL, imu_acc_raw, sizeof(imu_acc_raw), 0, 2, imuReadDone, TRANSACTION_IDLE, 0, 0};
+    mag_read = {mag_device, LIS3MDL_M_OUT_X_L_M, mag_raw, sizeof(mag_raw), 0, 1, magReadDone, TRANSACTION_IDLE, 0, 0};
+}
+
+/**
+ * @brief Enables the embedded pedometer when the step channel is on, and the safety events when the fall channel is on.
+ * Both force the accelerometer ODR and full scale, the IMU must be configured again after it.
+ * INT1 is released first: the step detector only keeps it without the safety events, the step count is polled otherwise
+ * 
+ * @param channels 
+ * @param acc_fs accelerometer full scale, for the impact threshold [g]
+ */
+void updateImuEvents(uint32_t channels, float acc_fs)
+{
+    if(safety.isEnabled())
+    {
+        safety.disable();
+    }
+
+    if(channels & CHANNEL_STEPS)
+    {
+        steps.enable(t, LSM6DSL_PEDOMETER_THRESHOLD_MID_HIGH, (channels & CHANNEL_FALL) == 0);
+        record.step_count = 0;
+        record.step_timestamp_us = 0;
+    }
+    else if(steps.isEnabled())
+    {
+        steps.disable();
+    }
+
+    if(channels & CHANNEL_FALL)
+    {
+        safety.enable(t, acc_fs);
+    }
+}
+
+/**
+ * @brief Starts the barometer when the channel is on, the altitude starts from zero
+ * 
+ * @param channels 
+ * @param rate 
+ */
+void updateBarometer(uint32_t channels, float rate)
+{
+    if(channels & CHANNEL_BARO)
+    {
+        barometer.configure(rate);
+        barometer.resetReference();
+    }
+    else
+    {
+        barometer.powerDown();
+    }
+}
+
+/**
+ * @brief The FIFO is read a bit faster than it fills up, one-shots are read one by one
+ * 
+ * @param rate barometer ODR
+ * @return float 
+ */
+float barometerTaskRate(float rate)
+{
+    return (rate < BARO_ONE_SHOT_RATE) ? rate : rate/(BARO_FIFO_BURST - 1);
+}
+
+#if MBED_CONF_APP_BUS_BENCHMARK
+/**
+ * @brief Bus time of one IMU sample, accelerometer and gyroscope
+ * 
+ */
+void benchmarkImuBus()
+{
+    const int nb_samples = 1000;
+    int32_t axes[3];
+    Timer bench;
+
+    bench.start();
+    for(int i = 0; i < nb_samples; i++)
+    {
+        acc_gyro.get_x_axes(axes);
+        acc_gyro.get_g_axes(axes);
+    }
+    bench.stop();
+
+    LOG_INFO("Bus benchmark: %s, %d us per IMU sample\n",
+        MBED_CONF_APP_IMU_SPI ? "SPI" : "I2C",
+        (int)(bench.elapsed_time().count()/nb_samples));
+}
+#endif
+
 /**
  * @brief Use for calibration 
  * 
@@ -175,6 +1432,7 @@ void calibrate_sensors(float N) {
             pot_left += pot_val_buf[1];
         }
         
+        consoleLock();
         printf("%f\t%f\t%f\t%f\t%f\t%d\n",
             static_cast<float>(gyro_val_buf[0]),
             static_cast<float>(gyro_val_buf[1]),
@@ -182,6 +1440,8 @@ void calibrate_sensors(float N) {
             pot_val_buf[0],
             pot_val_buf[1],
             sensorButton.detection());
+        fflush(stdout);
+        consoleUnlock();
 
         if (i % 20 == 0) {
             led1 = !led1;
@@ -202,19 +1462,27 @@ void calibrate_sensors(float N) {
     pot_left = pot_left/N;
     
 
-    printf("Calibration Finished, Gyro offsets:\n");
-    printf("%f\t%f\t%f\n\n\n",
+    LOG_INFO("Calibration Finished, Gyro offsets:\n");
+    LOG_INFO("%f\t%f\t%f\n\n\n",
             static_cast<float>(gyr_offset[0]),
             static_cast<float>(gyr_offset[1]),
             static_cast<float>(gyr_offset[2]));
 
-    cout <<"\n\nThe offset right angle value is "+ to_string(pot_val_buf[0]) <<endl;
-    cout <<"The offset left angle value is "+ to_string(pot_val_buf[1]) <<endl;
+    LOG_INFO("\n\nThe offset right angle value is %f\n", pot_val_buf[0]);
+    LOG_INFO("The offset left angle value is %f\n", pot_val_buf[1]);
     wait_us(1E+6);
 
     //Set data offset 
     potentiometer_right.setOffset(pot_val_buf[0]);       //Offset type u16_t
     potentiometer_left.setOffset(pot_val_buf[1]);         //Offset type u16_t     
+    updateScaling();
+
+    //The angles start again from the new standing position
+    hip[0].reset();
+    hip[1].reset();
+    gait_hip[0].reset();
+    gait_hip[1].reset();
+    gait.reset();
 }
 
 /**
@@ -230,22 +1498,22 @@ void initCalibration(int N)
 
     /* Calibration countdown */
     led1 = 1;
-    printf("\nCalibration starting in 5 seconds, please keep the IMU horizontal and fully still.\n");
+    LOG_INFO("\nCalibration starting in 5 seconds, please keep the IMU horizontal and fully still.\n");
     wait_us(1e6);
     led1 = 0;
-    printf("Calibration starting in 4 seconds.\n");
+    LOG_INFO("Calibration starting in 4 seconds.\n");
     wait_us(1e6);
     led1 = 1;
-    printf("Calibration starting in 3 seconds.\n");
+    LOG_INFO("Calibration starting in 3 seconds.\n");
     wait_us(1e6);
     led1 = 0;
-    printf("Calibration starting in 2 seconds.\n");
+    LOG_INFO("Calibration starting in 2 seconds.\n");
     wait_us(1e6);
     led1 = 1;
-    printf("Calibration starting in 1 seconds.\n");
+    LOG_INFO("Calibration starting in 1 seconds.\n");
     wait_us(1e6);
     led1 = 0;
-    printf("Calibration Started. This will take approximately %d seconds.\n", N/sampling_freq);
+    LOG_INFO("Calibration Started. This will take approximately %d seconds.\n", (int)(N/config.sampling_freq));
 
     calibrate_sensors( N);
     